@@ -1,4 +1,4 @@
-import { app, BrowserWindow, shell, ipcMain } from 'electron';
+import { app, BrowserWindow, shell, ipcMain, session } from 'electron';
 import { createRequire } from 'node:module';
 import { fileURLToPath } from 'node:url';
 import path from 'node:path';
@@ -59,6 +59,19 @@ const indexHtml = path.join(RENDERER_DIST, 'index.html');
 const UDP_TARGET_PORT = 8888;
 const UDP_TARGET_HOST = '127.0.0.1'; // 可以修改为实际的外部服务器IP
 
+// 为页面开启跨源隔离（COOP/COEP），使 SharedArrayBuffer 可用，从而加载多线程 wasm 构建
+function enableCrossOriginIsolation() {
+  session.defaultSession.webRequest.onHeadersReceived((details, callback) => {
+    callback({
+      responseHeaders: {
+        ...details.responseHeaders,
+        'Cross-Origin-Opener-Policy': ['same-origin'],
+        'Cross-Origin-Embedder-Policy': ['require-corp'],
+      },
+    });
+  });
+}
+
 function createWindow() {
   win = new BrowserWindow({
     title: 'Main window',
@@ -382,6 +395,7 @@ function getKeyCode(key) {
 
 // 当Electron完成初始化并准备创建浏览器窗口时调用此方�?
 app.whenReady().then(() => {
+  enableCrossOriginIsolation();
   createWindow();
   
   // 如果只需要作为UDP客户端发送消息，注释掉下面这�?
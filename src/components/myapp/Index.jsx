@@ -182,8 +182,13 @@ function App() {
         if (canvasRef.current) {
             console.log('Setting up Module configuration...');
             
+            // 多线程构建（build_with_ninja_mt.bat 输出到 public 目录）
+            const threadedJsUrl = '/OpenglWebTest_mt.js';
+            const threadedWasmUrl = '/OpenglWebTest_mt.wasm';
+
             // 检查是否已经加载过WASM脚本
-            if (document.querySelector(`script[src="${wasmJsUrl}"]`)) {
+            if (document.querySelector(`script[src="${wasmJsUrl}"]`) ||
+                document.querySelector(`script[src="${threadedJsUrl}"]`)) {
                 console.log('WASM script already loaded, skipping...');
                 return;
             }
@@ -208,10 +213,7 @@ function App() {
             document.body.appendChild(configScript);
             
             // 动态创建script标签来加载OpenglWebTest.js
-            const wasmScript = document.createElement('script');
-            wasmScript.src = wasmJsUrl;
-            wasmScript.async = true;
-            wasmScript.onload = () => {
+            const onWasmScriptLoaded = () => {
                 console.log('OpenglWebTest.js loaded successfully');
                 
                 // 创建script元素来添加事件监听器
@@ -301,11 +303,43 @@ function App() {
                     
                 }, 1000); // 1秒延迟确保WASM完全加载
             };
-            wasmScript.onerror = () => {
-                console.error('Failed to load OpenglWebTest.js');
+
+            const loadWasmScript = (scriptUrl, onError) => {
+                const wasmScript = document.createElement('script');
+                wasmScript.src = scriptUrl;
+                wasmScript.async = true;
+                wasmScript.onload = onWasmScriptLoaded;
+                wasmScript.onerror = onError;
+                document.body.appendChild(wasmScript);
             };
-            
-            document.body.appendChild(wasmScript);
+
+            // 多线程构建依赖 SharedArrayBuffer，只有页面跨源隔离（COOP/COEP）时才可用；
+            // 不可用或多线程构建不存在时回退到单线程构建
+            const threadedBuildAvailable = async () => {
+                if (typeof SharedArrayBuffer === 'undefined') {
+                    return false;
+                }
+                try {
+                    const response = await fetch(threadedJsUrl, { method: 'HEAD' });
+                    return response.ok && (response.headers.get('content-type') || '').includes('javascript');
+                } catch (error) {
+                    return false;
+                }
+            };
+
+            threadedBuildAvailable().then((useThreadedBuild) => {
+                console.log(`crossOriginIsolated: ${window.crossOriginIsolated}, using ${useThreadedBuild ? 'threaded' : 'single-threaded'} build`);
+                if (useThreadedBuild) {
+                    window.Module.locateFile = (path, prefix) => path.endsWith('.wasm') ? threadedWasmUrl : prefix + path;
+                    loadWasmScript(threadedJsUrl, () => {
+                        console.error('Failed to load OpenglWebTest_mt.js');
+                    });
+                } else {
+                    loadWasmScript(wasmJsUrl, () => {
+                        console.error('Failed to load OpenglWebTest.js');
+                    });
+                }
+            });
             
             // 清理函数
             return () => {
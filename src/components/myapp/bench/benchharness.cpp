@@ -0,0 +1,217 @@
+#include "benchharness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------------
+// 全局分配统计
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    std::atomic<std::uint64_t> g_allocCount{0};
+    std::atomic<std::uint64_t> g_allocBytes{0};
+
+    void *countedAlloc(std::size_t size)
+    {
+        g_allocCount.fetch_add(1, std::memory_order_relaxed);
+        g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+        void *ptr = std::malloc(size ? size : 1);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// ---------------------------------------------------------------------------
+// BenchRunner
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    // 单次采样的最短时长，迭代次数按此校准
+    const double kMinSampleNs = 20.0e6;
+    const int kSampleCount = 5;
+
+    double timeIterations(const BenchRunner::BenchFunction &func, std::uint64_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func(iterations);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    bool readNumber(const std::string &line, const char *key, double &value)
+    {
+        std::string pattern = std::string("\"") + key + "\": ";
+        size_t pos = line.find(pattern);
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+        value = std::strtod(line.c_str() + pos + pattern.size(), nullptr);
+        return true;
+    }
+
+    bool readName(const std::string &line, std::string &name)
+    {
+        const std::string pattern = "\"name\": \"";
+        size_t pos = line.find(pattern);
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+        size_t begin = pos + pattern.size();
+        size_t end = line.find('"', begin);
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+        name = line.substr(begin, end - begin);
+        return true;
+    }
+}
+
+BenchRunner::BenchRunner(std::string filter)
+    : m_filter(std::move(filter))
+{
+}
+
+void BenchRunner::run(const std::string &name, std::uint64_t opsPerIteration, const BenchFunction &func)
+{
+    if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+    {
+        return;
+    }
+
+    // 预热并校准迭代次数
+    std::uint64_t iterations = 1;
+    double elapsed = timeIterations(func, iterations);
+    while (elapsed < kMinSampleNs && iterations < (1ull << 40))
+    {
+        double scale = elapsed > 0.0 ? kMinSampleNs / elapsed : 10.0;
+        iterations = std::max<std::uint64_t>(iterations + 1, static_cast<std::uint64_t>(iterations * std::min(scale * 1.2, 10.0)));
+        elapsed = timeIterations(func, iterations);
+    }
+
+    std::vector<double> samples;
+    std::uint64_t allocCount = g_allocCount.load(std::memory_order_relaxed);
+    std::uint64_t allocBytes = g_allocBytes.load(std::memory_order_relaxed);
+    for (int i = 0; i < kSampleCount; ++i)
+    {
+        samples.push_back(timeIterations(func, iterations));
+    }
+    allocCount = g_allocCount.load(std::memory_order_relaxed) - allocCount;
+    allocBytes = g_allocBytes.load(std::memory_order_relaxed) - allocBytes;
+
+    std::sort(samples.begin(), samples.end());
+    const double totalOps = static_cast<double>(iterations) * static_cast<double>(opsPerIteration);
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = samples[samples.size() / 2] / totalOps;
+    result.allocsPerOp = static_cast<double>(allocCount) / (totalOps * kSampleCount);
+    result.bytesPerOp = static_cast<double>(allocBytes) / (totalOps * kSampleCount);
+    m_results.push_back(result);
+
+    std::printf("%-48s %12.1f ns/op %10.2f allocs/op %12.1f B/op\n",
+                name.c_str(), result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+}
+
+bool BenchRunner::writeJson(const std::string &path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "Failed to open benchmark output: " << path << std::endl;
+        return false;
+    }
+
+    // 每个基准一行，compare() 按行读取
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const BenchResult &r = m_results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"bytes_per_op\": %.2f, \"iterations\": %llu}",
+                      r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp,
+                      static_cast<unsigned long long>(r.iterations));
+        out << line << (i + 1 < m_results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+int BenchRunner::compare(const std::string &baselinePath, double thresholdPercent) const
+{
+    std::ifstream in(baselinePath);
+    if (!in)
+    {
+        std::cerr << "Failed to open benchmark baseline: " << baselinePath << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, BenchResult> baseline;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        BenchResult r;
+        if (readName(line, r.name) && readNumber(line, "ns_per_op", r.nsPerOp))
+        {
+            readNumber(line, "allocs_per_op", r.allocsPerOp);
+            readNumber(line, "bytes_per_op", r.bytesPerOp);
+            baseline[r.name] = r;
+        }
+    }
+
+    int regressions = 0;
+    std::printf("\n%-48s %12s %12s %8s %s\n", "benchmark", "base ns/op", "ns/op", "delta", "");
+    for (const BenchResult &current : m_results)
+    {
+        auto it = baseline.find(current.name);
+        if (it == baseline.end())
+        {
+            std::printf("%-48s %12s %12.1f %8s new\n", current.name.c_str(), "-", current.nsPerOp, "");
+            continue;
+        }
+
+        const BenchResult &base = it->second;
+        double delta = base.nsPerOp > 0.0 ? (current.nsPerOp - base.nsPerOp) / base.nsPerOp * 100.0 : 0.0;
+        // 分配次数是确定性的，任何增加都视为回归
+        bool slower = delta > thresholdPercent;
+        bool moreAllocs = current.allocsPerOp > base.allocsPerOp + 0.01;
+        const char *flag = "";
+        if (slower || moreAllocs)
+        {
+            ++regressions;
+            flag = moreAllocs ? (slower ? "REGRESSION (time, allocs)" : "REGRESSION (allocs)") : "REGRESSION (time)";
+        }
+        else if (delta < -thresholdPercent)
+        {
+            flag = "improved";
+        }
+        std::printf("%-48s %12.1f %12.1f %+7.1f%% %s\n",
+                    current.name.c_str(), base.nsPerOp, current.nsPerOp, delta, flag);
+    }
+
+    std::printf("\n%d regression(s), threshold %.1f%%\n", regressions, thresholdPercent);
+    return regressions;
+}
@@ -0,0 +1,83 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 单个基准测试的结果
+ */
+struct BenchResult
+{
+    std::string name;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+    std::uint64_t iterations = 0;
+};
+
+/**
+ * @brief 基准测试运行器
+ *
+ * 自动校准迭代次数，取多次采样的中位数，并统计每次操作的堆分配次数和字节数。
+ * 分配统计依赖 benchharness.cpp 中替换的全局 operator new。
+ */
+class BenchRunner
+{
+public:
+    /**
+     * @brief 被测函数，参数为本次采样的迭代次数
+     */
+    using BenchFunction = std::function<void(std::uint64_t iterations)>;
+
+    /**
+     * @param filter 名称过滤子串，为空时运行全部
+     */
+    explicit BenchRunner(std::string filter = "");
+
+    /**
+     * @brief 运行一个基准测试
+     * @param name 名称，建议使用 "Group/param" 格式
+     * @param opsPerIteration 每次迭代包含的操作数（结果按操作数归一化）
+     * @param func 被测函数
+     */
+    void run(const std::string &name, std::uint64_t opsPerIteration, const BenchFunction &func);
+
+    /**
+     * @brief 获取所有结果
+     * @return 结果列表
+     */
+    const std::vector<BenchResult> &results() const { return m_results; }
+
+    /**
+     * @brief 以JSON格式写出结果
+     * @param path 输出文件路径
+     * @return 是否成功
+     */
+    bool writeJson(const std::string &path) const;
+
+    /**
+     * @brief 与基线对比并打印报告
+     * @param baselinePath 基线JSON文件（由writeJson生成）
+     * @param thresholdPercent ns/op 超过基线的百分比阈值
+     * @return 回归的基准数量，基线读取失败时返回-1
+     */
+    int compare(const std::string &baselinePath, double thresholdPercent) const;
+
+private:
+    std::string m_filter;
+    std::vector<BenchResult> m_results;
+};
+
+/**
+ * @brief 阻止编译器优化掉计算结果
+ */
+template <typename T>
+inline void benchDoNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCHHARNESS_H
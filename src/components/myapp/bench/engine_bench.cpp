@@ -0,0 +1,500 @@
+// 引擎每帧热路径的微基准测试
+//
+// 用法: engine_bench [--filter STR] [--json FILE] [--compare BASELINE] [--threshold PCT] [--workers N]
+//   --json      以JSON格式保存结果（可作为之后的基线）
+//   --compare   与基线对比，存在回归时返回码为2
+//   --threshold ns/op 回归阈值百分比，默认10
+//   --workers   作业系统工作线程数量，默认硬件线程数减一
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchharness.h"
+
+#include "glbackend.h"
+#include "material.h"
+#include "mesh.h"
+#include "gameobject.h"
+#include "scene.h"
+#include "renderpass.h"
+#include "taskscheduler.h"
+
+#ifdef ENGINE_WITH_OZZ
+#include "ozz_animation.h"
+#include "ozz_benchmark.h"
+#endif
+
+namespace
+{
+    const char *vertexShaderSource = "#version 300 es\n"
+                                     "layout (location = 0) in vec3 aPos;\n"
+                                     "void main()\n"
+                                     "{\n"
+                                     "   gl_Position = vec4(aPos, 1.0);\n"
+                                     "}\n";
+
+    const char *fragmentShaderSource = "#version 300 es\n"
+                                       "precision mediump float;\n"
+                                       "out vec4 FragColor;\n"
+                                       "void main()\n"
+                                       "{\n"
+                                       "   FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);\n"
+                                       "}\n";
+
+    std::shared_ptr<Mesh> createQuadMesh(std::shared_ptr<Material> material)
+    {
+        float vertices[] = {
+            0.5f, 0.5f, 0.0f,
+            0.5f, -0.5f, 0.0f,
+            -0.5f, -0.5f, 0.0f,
+            -0.5f, 0.5f, 0.0f};
+        unsigned int indices[] = {0, 1, 3, 1, 2, 3};
+
+        auto mesh = std::make_shared<Mesh>();
+        mesh->setVertices(vertices, 4, 3 * sizeof(float));
+        mesh->setIndices(indices, 6);
+        mesh->setMaterial(material);
+        return mesh;
+    }
+
+    std::vector<std::shared_ptr<GameObject>> createGameObjects(int count, std::shared_ptr<Mesh> mesh)
+    {
+        std::vector<std::shared_ptr<GameObject>> objects;
+        objects.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            auto object = std::make_shared<GameObject>("Object" + std::to_string(i));
+            object->addMesh(mesh);
+            objects.push_back(object);
+        }
+        return objects;
+    }
+
+    void benchRenderPass(BenchRunner &runner)
+    {
+        auto shader = std::make_shared<Shader>(vertexShaderSource, fragmentShaderSource, true);
+        auto mesh = createQuadMesh(std::make_shared<Material>(shader));
+
+        for (int count : {10, 100, 1000, 10000})
+        {
+            RenderPass renderPass;
+            for (auto &object : createGameObjects(count, mesh))
+            {
+                renderPass.addGameObject(object);
+            }
+
+            runner.run("RenderPass::render/objects:" + std::to_string(count), 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               renderPass.render();
+                           }
+                       });
+        }
+
+        // 材质交替的对象：绘制排序把状态切换从每个对象一次降到每种材质一次
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        for (int i = 0; i < 16; ++i)
+        {
+            meshes.push_back(createQuadMesh(std::make_shared<Material>(shader)));
+        }
+
+        RenderPass renderPass;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto object = std::make_shared<GameObject>("Object" + std::to_string(i));
+            object->addMesh(meshes[i % meshes.size()]);
+            renderPass.addGameObject(object);
+        }
+
+        runner.run("RenderPass::render/objects:1000/materials:16", 1,
+                   [&](std::uint64_t iterations)
+                   {
+                       for (std::uint64_t i = 0; i < iterations; ++i)
+                       {
+                           renderPass.render();
+                       }
+                   });
+
+        // 关闭命令缓存，每帧重新准备和录制：对比串行与并行录制
+        RenderPass largePass;
+        for (int i = 0; i < 20000; ++i)
+        {
+            auto object = std::make_shared<GameObject>("Object" + std::to_string(i));
+            object->addMesh(meshes[i % meshes.size()]);
+            largePass.addGameObject(object);
+        }
+        largePass.setCommandCacheEnabled(false);
+
+        for (bool parallel : {false, true})
+        {
+            largePass.setParallelRecordingEnabled(parallel);
+            runner.run(std::string("RenderPass::record/objects:20000/") + (parallel ? "parallel" : "serial"), 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               largePass.render();
+                           }
+                       });
+        }
+    }
+
+    // 声明 uParam0..uParam{count-1}，类型按 float、int、bool、vec4 轮流，与 setParameters 对应
+    std::string createParameterShaderSource(int count)
+    {
+        static const char *const types[] = {"float", "int", "bool", "vec4"};
+        std::string source = "#version 300 es\n"
+                             "precision mediump float;\n";
+        for (int i = 0; i < count; ++i)
+        {
+            source += std::string("uniform ") + types[i % 4] + " uParam" + std::to_string(i) + ";\n";
+        }
+        source += "out vec4 FragColor;\n"
+                  "void main()\n"
+                  "{\n"
+                  "   vec4 sum = vec4(0.0);\n";
+        for (int i = 0; i < count; ++i)
+        {
+            const std::string name = "uParam" + std::to_string(i);
+            switch (i % 4)
+            {
+            case 0:
+                source += "   sum.x += " + name + ";\n";
+                break;
+            case 1:
+                source += "   sum.y += float(" + name + ");\n";
+                break;
+            case 2:
+                source += "   sum.z += " + name + " ? 1.0 : 0.0;\n";
+                break;
+            default:
+                source += "   sum += " + name + ";\n";
+                break;
+            }
+        }
+        source += "   FragColor = sum;\n"
+                  "}\n";
+        return source;
+    }
+
+    // value 不同的两组参数每一项都不相同，交替提交时不会被着色器的值缓存过滤
+    void setParameters(Material &material, int count, float value)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            // 四种属性类型轮流设置
+            std::string name = "uParam" + std::to_string(i);
+            switch (i % 4)
+            {
+            case 0:
+                material.setFloat(name, value);
+                break;
+            case 1:
+                material.setInt(name, static_cast<int>(value));
+                break;
+            case 2:
+                material.setBool(name, value != 0.0f);
+                break;
+            default:
+                material.setColor(name, value, 0.5f, 0.2f, 1.0f);
+                break;
+            }
+        }
+    }
+
+    void benchMaterialApply(BenchRunner &runner)
+    {
+        for (int count : {1, 4, 16, 64})
+        {
+            const std::string fragmentSource = createParameterShaderSource(count);
+            auto shader = std::make_shared<Shader>(vertexShaderSource, fragmentSource.c_str(), true);
+            Material material(shader);
+            Material other(shader);
+            setParameters(material, count, 1.0f);
+            setParameters(other, count, 0.0f);
+
+            // 参数没有改变且程序上的值未被改写：只绑定程序，不提交 uniform
+            material.apply();
+            runner.run("Material::apply/properties:" + std::to_string(count) + "/clean", 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               material.apply();
+                           }
+                       });
+
+            // 每次只改变一个参数：脏位只提交这一个
+            runner.run("Material::apply/properties:" + std::to_string(count) + "/dirty:1", 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               material.setFloat("uParam0", static_cast<float>(i & 1));
+                               material.apply();
+                           }
+                       });
+
+            // 两个材质共享程序交替应用，程序上的值被改写过，每次都要重新提交全部参数
+            runner.run("Material::apply/properties:" + std::to_string(count) + "/shared", 2,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               material.apply();
+                               other.apply();
+                           }
+                       });
+        }
+    }
+
+    void benchSceneAddRemove(BenchRunner &runner)
+    {
+        auto shader = std::make_shared<Shader>(vertexShaderSource, fragmentShaderSource, true);
+        auto mesh = createQuadMesh(std::make_shared<Material>(shader));
+
+        for (int count : {100, 1000, 10000})
+        {
+            auto objects = createGameObjects(count, mesh);
+            Scene scene("BenchScene");
+
+            // 每次迭代添加并移除全部对象，按 2*count 次操作归一化
+            runner.run("Scene::addRemoveGameObject/objects:" + std::to_string(count), 2ull * count,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               for (auto &object : objects)
+                               {
+                                   scene.addGameObject(object);
+                               }
+                               for (auto &object : objects)
+                               {
+                                   scene.removeGameObject(object);
+                               }
+                           }
+                       });
+        }
+    }
+
+    void benchSceneUpdate(BenchRunner &runner)
+    {
+        auto shader = std::make_shared<Shader>(vertexShaderSource, fragmentShaderSource, true);
+        auto mesh = createQuadMesh(std::make_shared<Material>(shader));
+
+        for (int count : {100, 10000})
+        {
+            Scene scene("BenchScene");
+            for (auto &object : createGameObjects(count, mesh))
+            {
+                scene.addGameObject(object);
+            }
+
+            runner.run("Scene::update/objects:" + std::to_string(count), 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               scene.update(1.0f / 60.0f);
+                           }
+                       });
+        }
+    }
+
+    void benchParallelFor(BenchRunner &runner)
+    {
+        // 每个元素少量计算，测量作业拆分与窃取的开销
+        std::vector<float> values(1 << 16, 1.0f);
+        for (size_t grain : {256, 4096})
+        {
+            runner.run("TaskScheduler::parallelFor/items:65536/grain:" + std::to_string(grain), values.size(),
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               TaskScheduler::instance().parallelFor(values.size(), grain,
+                                                                     [&](size_t begin, size_t end)
+                                                                     {
+                                                                         for (size_t j = begin; j < end; ++j)
+                                                                         {
+                                                                             values[j] = values[j] * 0.5f + 1.0f;
+                                                                         }
+                                                                     });
+                           }
+                           benchDoNotOptimize(values.data());
+                       });
+        }
+    }
+
+#ifdef ENGINE_WITH_OZZ
+    std::vector<std::unique_ptr<OzzAnimation>> createAnimations(int numJoints, int numInstances)
+    {
+        const std::vector<char> skeleton = OzzBenchmark::BuildSkeletonData(numJoints);
+        const std::vector<char> animation = OzzBenchmark::BuildAnimationData(numJoints, 16);
+
+        std::vector<std::unique_ptr<OzzAnimation>> instances;
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto instance = std::make_unique<OzzAnimation>();
+            instance->Initialize();
+            instance->LoadSkeletonFromMemory(skeleton.data(), skeleton.size());
+            for (int index = 0; index < 3; ++index)
+            {
+                instance->LoadAnimationFromMemory(animation.data(), animation.size(), index);
+            }
+            instance->SetBlendRatio(0.5f);
+            instances.push_back(std::move(instance));
+        }
+        return instances;
+    }
+
+    void benchOzzAnimation(BenchRunner &runner)
+    {
+        auto runUpdate = [&](const std::string &name, int numJoints, int numInstances)
+        {
+            auto instances = createAnimations(numJoints, numInstances);
+            runner.run(name, numInstances,
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               for (auto &instance : instances)
+                               {
+                                   instance->Update(1.0f / 60.0f);
+                               }
+                           }
+                       });
+        };
+
+        for (int joints : {16, 64, 256})
+        {
+            runUpdate("OzzAnimation::Update/joints:" + std::to_string(joints), joints, 1);
+        }
+        for (int instances : {1, 16, 64})
+        {
+            runUpdate("OzzAnimation::Update/joints:64/instances:" + std::to_string(instances), 64, instances);
+        }
+
+        // 通过作业系统并行更新多个实例
+        {
+            auto instances = createAnimations(64, 64);
+            std::vector<OzzAnimation *> pointers;
+            for (auto &instance : instances)
+            {
+                pointers.push_back(instance.get());
+            }
+            runner.run("OzzAnimation::UpdateInstances/joints:64/instances:64", pointers.size(),
+                       [&](std::uint64_t iterations)
+                       {
+                           for (std::uint64_t i = 0; i < iterations; ++i)
+                           {
+                               OzzAnimation::UpdateInstances(pointers.data(), pointers.size(), 1.0f / 60.0f);
+                           }
+                       });
+        }
+
+        // 单独测量采样/混合/模型空间转换作业
+        const struct
+        {
+            OzzBenchmark::Stage stage;
+            const char *name;
+        } stages[] = {
+            {OzzBenchmark::kSampling, "OzzJob::Sampling"},
+            {OzzBenchmark::kBlending, "OzzJob::Blending"},
+            {OzzBenchmark::kLocalToModel, "OzzJob::LocalToModel"},
+        };
+        for (const auto &entry : stages)
+        {
+            OzzBenchmark benchmark(64);
+            runner.run(std::string(entry.name) + "/joints:64", 1,
+                       [&](std::uint64_t iterations)
+                       {
+                           benchmark.Run(entry.stage, static_cast<int>(iterations));
+                       });
+        }
+    }
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    std::string jsonPath;
+    std::string baselinePath;
+    double threshold = 10.0;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--filter") == 0 && hasValue)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(arg, "--json") == 0 && hasValue)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (std::strcmp(arg, "--compare") == 0 && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (std::strcmp(arg, "--threshold") == 0 && hasValue)
+        {
+            threshold = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(arg, "--workers") == 0 && hasValue)
+        {
+            workers = std::atoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter STR] [--json FILE] [--compare BASELINE] [--threshold PCT] [--workers N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // 使用空后端，只测量引擎自身的CPU开销
+    NullGLBackend backend;
+    GLBackend::setCurrent(&backend);
+
+    TaskScheduler::instance().initialize(workers < 0 ? TaskScheduler::defaultWorkerCount()
+                                                     : static_cast<unsigned>(workers));
+
+    BenchRunner runner(filter);
+    benchRenderPass(runner);
+    benchMaterialApply(runner);
+    benchSceneAddRemove(runner);
+    benchSceneUpdate(runner);
+    benchParallelFor(runner);
+#ifdef ENGINE_WITH_OZZ
+    benchOzzAnimation(runner);
+#endif
+
+    GLBackend::setCurrent(nullptr);
+    TaskScheduler::instance().shutdown();
+
+    if (!jsonPath.empty() && !runner.writeJson(jsonPath))
+    {
+        return 1;
+    }
+
+    if (!baselinePath.empty())
+    {
+        int regressions = runner.compare(baselinePath, threshold);
+        if (regressions < 0)
+        {
+            return 1;
+        }
+        return regressions > 0 ? 2 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+@echo off
+echo ========================================
+echo OpenGL Web Test - Ninja SIMD128 Build Script
+echo ========================================
+
+REM 检查Emscripten环境变量
+if "%EMSDK%"=="" (
+    echo Error: EMSDK environment variable is not set!
+    echo Please set EMSDK environment variable first.
+    pause
+    exit /b 1
+)
+
+REM 创建构建目录
+if not exist "build_emscripten_simd" mkdir build_emscripten_simd
+
+echo.
+echo [1/3] Configuring CMake with Emscripten toolchain...
+cd build_emscripten_simd
+cmake -G "Ninja" -DCMAKE_TOOLCHAIN_FILE=%EMSDK%/upstream/emscripten/cmake/Modules/Platform/Emscripten.cmake -DENGINE_WASM_SIMD=ON ..
+
+if %errorlevel% neq 0 (
+    echo Error: CMake configuration failed!
+    pause
+    exit /b 1
+)
+
+echo.
+echo [2/3] Building with Ninja...
+ninja
+
+if %errorlevel% neq 0 (
+    echo Error: Ninja build failed!
+    pause
+    exit /b 1
+)
+
+echo.
+echo [3/4] Build completed successfully!
+echo.
+echo Generated files:
+echo   - OpenglWebTest_simd.html (Web page)
+echo   - OpenglWebTest_simd.js   (JavaScript glue code)
+echo   - OpenglWebTest_simd.wasm (WebAssembly binary)
+echo.
+echo [4/4] Copying WebAssembly files to build_emscripten_simd directory...
+REM 确保WASM文件在正确的位置
+
+xcopy "OpenglWebTest_simd.wasm" "..\..\..\public\" /Y
+xcopy "OpenglWebTest_simd.js" "..\..\..\public\" /Y
+
+echo.
+echo Build completed successfully!
+echo You can open build_emscripten_simd\OpenglWebTest_simd.html in a web browser to test the application.
+echo.
+echo WebAssembly files copied to public directory for Electron app usage.
+echo.
+pause
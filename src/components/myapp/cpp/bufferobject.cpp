@@ -1,8 +1,8 @@
 #include "bufferobject.h"
-#include <GLES3/gl3.h>
+#include "glstate.h"
 
 BufferObject::BufferObject(Type type)
-    : m_id(0), m_type(type), m_size(0)
+    : m_id(0), m_type(type), m_size(0), m_usage(Usage::StaticDraw)
 {
     glGenBuffers(1, &m_id);
 }
@@ -11,12 +11,13 @@ BufferObject::~BufferObject()
 {
     if (m_id != 0)
     {
+        GLState::bufferDeleted(m_id);
         glDeleteBuffers(1, &m_id);
     }
 }
 
 BufferObject::BufferObject(BufferObject &&other) noexcept
-    : m_id(other.m_id), m_type(other.m_type), m_size(other.m_size)
+    : m_id(other.m_id), m_type(other.m_type), m_size(other.m_size), m_usage(other.m_usage)
 {
     other.m_id = 0;
     other.m_size = 0;
@@ -28,11 +29,13 @@ BufferObject &BufferObject::operator=(BufferObject &&other) noexcept
     {
         if (m_id != 0)
         {
+            GLState::bufferDeleted(m_id);
             glDeleteBuffers(1, &m_id);
         }
         m_id = other.m_id;
         m_type = other.m_type;
         m_size = other.m_size;
+        m_usage = other.m_usage;
         other.m_id = 0;
         other.m_size = 0;
     }
@@ -41,12 +44,12 @@ BufferObject &BufferObject::operator=(BufferObject &&other) noexcept
 
 void BufferObject::bind() const
 {
-    glBindBuffer(static_cast<GLenum>(m_type), m_id);
+    GLState::bindBuffer(static_cast<GLenum>(m_type), m_id);
 }
 
 void BufferObject::unbind() const
 {
-    glBindBuffer(static_cast<GLenum>(m_type), 0);
+    GLState::bindBuffer(static_cast<GLenum>(m_type), 0);
 }
 
 void BufferObject::setData(const void *data, GLsizeiptr size, Usage usage)
@@ -54,6 +57,16 @@ void BufferObject::setData(const void *data, GLsizeiptr size, Usage usage)
     bind();
     glBufferData(static_cast<GLenum>(m_type), size, data, static_cast<GLenum>(usage));
     m_size = size;
+    m_usage = usage;
+}
+
+void BufferObject::orphan()
+{
+    if (m_size == 0)
+        return;
+
+    bind();
+    glBufferData(static_cast<GLenum>(m_type), m_size, nullptr, static_cast<GLenum>(m_usage));
 }
 
 void BufferObject::updateData(GLintptr offset, const void *data, GLsizeiptr size)
@@ -1,7 +1,7 @@
 #ifndef BUFFER_OBJECT_H
 #define BUFFER_OBJECT_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
 #include <vector>
 #include <cstddef>
 
@@ -104,6 +104,13 @@ public:
         updateData(offset, data.data(), static_cast<GLsizeiptr>(data.size() * sizeof(T)));
     }
 
+    /**
+     * @brief 孤立当前存储：按原来的大小和使用方式重新分配（glBufferData 传空指针）
+     *
+     * GPU 仍在读取的旧存储由驱动保留，之后写入新存储不需要等待它们完成
+     */
+    void orphan();
+
     /**
      * @brief 获取缓冲大小
      * @return 缓冲大小（字节）
@@ -114,6 +121,7 @@ private:
     GLuint m_id;
     Type m_type;
     GLsizeiptr m_size;
+    Usage m_usage;
 };
 
 #endif // BUFFER_OBJECT_H
@@ -0,0 +1,97 @@
+#include "dynamicbufferring.h"
+#include "glstate.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstring>
+
+DynamicBufferRing::DynamicBufferRing(BufferObject::Type type, int frameCount, GLsizeiptr capacity)
+    : m_frameIndex(0), m_capacity(capacity > 0 ? capacity : kDefaultCapacity),
+      m_maxCapacity(kDefaultMaxCapacity), m_orphaning(true), m_stats{}
+{
+    const int count = frameCount > 0 ? frameCount : 1;
+    m_buffers.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        m_buffers.emplace_back(type);
+    }
+}
+
+DynamicBufferRing::~DynamicBufferRing()
+{
+}
+
+void DynamicBufferRing::beginFrame()
+{
+    m_frameIndex = (m_frameIndex + 1) % m_buffers.size();
+    m_staging.clear();
+    m_stats = {};
+}
+
+void *DynamicBufferRing::allocate(GLsizeiptr size, GLsizeiptr alignment, Allocation &allocation)
+{
+    const size_t align = alignment > 0 ? static_cast<size_t>(alignment) : 1;
+    const size_t offset = (m_staging.size() + align - 1) / align * align;
+    if (static_cast<GLsizeiptr>(offset) + size > std::max(m_maxCapacity, m_capacity))
+    {
+        allocation = {0, 0, 0};
+        ++m_stats.failedAllocations;
+        return nullptr;
+    }
+
+    m_staging.resize(offset + static_cast<size_t>(size));
+    allocation.buffer = m_buffers[m_frameIndex].getId();
+    allocation.offset = static_cast<GLintptr>(offset);
+    allocation.size = size;
+    ++m_stats.allocations;
+    return m_staging.data() + offset;
+}
+
+DynamicBufferRing::Allocation DynamicBufferRing::push(const void *data, GLsizeiptr size, GLsizeiptr alignment)
+{
+    Allocation allocation;
+    void *destination = allocate(size, alignment, allocation);
+    if (destination)
+    {
+        std::memcpy(destination, data, static_cast<size_t>(size));
+    }
+    return allocation;
+}
+
+void DynamicBufferRing::flush()
+{
+    PROFILE_ZONE("DynamicBufferRing::flush");
+
+    const GLsizeiptr used = getBytesUsed();
+    if (used == 0)
+        return;
+
+    while (m_capacity < used)
+    {
+        m_capacity *= 2;
+    }
+
+    BufferObject &buffer = m_buffers[m_frameIndex];
+
+    // 索引缓冲的绑定属于当前 VAO，上传时不能改动正在使用的 VAO
+    if (buffer.getType() == BufferObject::Type::ElementBuffer)
+    {
+        GLState::bindVertexArray(0);
+    }
+
+    // 每个缓冲在轮到自己时才按当前容量重新分配；新分配的存储不需要孤立
+    if (buffer.getSize() < m_capacity)
+    {
+        if (buffer.getSize() > 0)
+        {
+            ++m_stats.grows;
+        }
+        buffer.setData(nullptr, m_capacity, BufferObject::Usage::StreamDraw);
+    }
+    else if (m_orphaning)
+    {
+        buffer.orphan();
+        ++m_stats.orphans;
+    }
+    buffer.updateData(0, m_staging.data(), used);
+    m_stats.bytesUploaded += used;
+}
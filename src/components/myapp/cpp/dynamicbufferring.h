@@ -0,0 +1,156 @@
+#ifndef DYNAMICBUFFERRING_H
+#define DYNAMICBUFFERRING_H
+
+#include "glapi.h"
+#include <cstdint>
+#include <vector>
+#include "bufferobject.h"
+
+/**
+ * @brief 多缓冲的动态数据环
+ *
+ * 用于每帧重新生成的数据（UI、调试线、粒子、CPU 蒙皮顶点、逐帧 uniform 块）。持有 frameCount 个缓冲，
+ * 每帧轮换使用其中一个；一帧内的分配先按要求的对齐写入 CPU 暂存区，flush() 时一次 glBufferSubData 上传。
+ * 启用孤立时上传前先孤立缓冲的旧存储，GPU 仍在读取时也不会等待。
+ *
+ * 分配返回 (缓冲名, 偏移, 大小)，可以直接用于绘制：索引的偏移就是 glDrawElements 的偏移；
+ * 按顶点步长对齐分配的顶点，offset / stride 就是第一个顶点的序号。
+ *
+ * 一帧的数据超过容量时，该帧的缓冲在上传前按两倍扩容（已分配的偏移仍然有效），直到最大容量；
+ * 超过最大容量的分配失败。只在持有 GL 上下文的线程上使用
+ */
+class DynamicBufferRing
+{
+public:
+    // 默认轮换的缓冲数量
+    static constexpr int kDefaultFrameCount = 3;
+
+    // 每个缓冲的默认初始容量（字节）
+    static constexpr GLsizeiptr kDefaultCapacity = 256 * 1024;
+
+    // 默认最大容量（字节）
+    static constexpr GLsizeiptr kDefaultMaxCapacity = 64 * 1024 * 1024;
+
+    /**
+     * @brief 一次分配在缓冲中的位置
+     */
+    struct Allocation
+    {
+        GLuint buffer;   // 缓冲名，分配失败时为 0
+        GLintptr offset; // 字节偏移，满足对齐要求
+        GLsizeiptr size; // 请求的字节数
+    };
+
+    /**
+     * @brief 统计（最近一帧）
+     */
+    struct Stats
+    {
+        std::uint32_t allocations;      // 成功的分配次数
+        std::uint32_t failedAllocations; // 超过最大容量而失败的分配次数
+        GLsizeiptr bytesUploaded;       // 上传的字节数（含对齐填充）
+        std::uint32_t orphans;          // 孤立次数
+        std::uint32_t grows;            // 扩容次数
+    };
+
+    /**
+     * @brief 创建数据环（创建 GL 缓冲对象，必须在 GL 上下文中调用）
+     * @param type 缓冲类型
+     * @param frameCount 轮换的缓冲数量
+     * @param capacity 每个缓冲的初始容量（字节）
+     */
+    explicit DynamicBufferRing(BufferObject::Type type, int frameCount = kDefaultFrameCount,
+                               GLsizeiptr capacity = kDefaultCapacity);
+    ~DynamicBufferRing();
+
+    // 禁用拷贝构造和赋值
+    DynamicBufferRing(const DynamicBufferRing &) = delete;
+    DynamicBufferRing &operator=(const DynamicBufferRing &) = delete;
+
+    /**
+     * @brief 开始新的一帧：切换到下一个缓冲并清空暂存区
+     */
+    void beginFrame();
+
+    /**
+     * @brief 在本帧中分配一段对齐的空间
+     * @param size 字节数
+     * @param alignment 偏移的对齐字节数（不必是 2 的幂，例如顶点步长）
+     * @param allocation 输出分配的位置
+     * @return 暂存区中的写入地址，下一次分配前有效；超过最大容量时返回 nullptr
+     */
+    void *allocate(GLsizeiptr size, GLsizeiptr alignment, Allocation &allocation);
+
+    /**
+     * @brief 分配空间并拷贝数据
+     * @param data 数据
+     * @param size 字节数
+     * @param alignment 偏移的对齐字节数
+     * @return 分配的位置，失败时 buffer 为 0
+     */
+    Allocation push(const void *data, GLsizeiptr size, GLsizeiptr alignment);
+
+    /**
+     * @brief 把本帧暂存区上传到当前缓冲，绘制前调用
+     */
+    void flush();
+
+    /**
+     * @brief 启用/禁用上传前孤立旧存储
+     * @param enabled 是否孤立
+     */
+    void setOrphaning(bool enabled) { m_orphaning = enabled; }
+
+    /**
+     * @brief 设置最大容量
+     * @param capacity 字节数
+     */
+    void setMaxCapacity(GLsizeiptr capacity) { m_maxCapacity = capacity; }
+
+    /**
+     * @brief 获取当前帧使用的缓冲名
+     * @return 缓冲名
+     */
+    GLuint getCurrentBuffer() const { return m_buffers[m_frameIndex].getId(); }
+
+    /**
+     * @brief 获取当前帧在环中的序号，按缓冲准备绑定状态（例如每个缓冲一个 VAO）时使用
+     * @return 序号
+     */
+    int getFrameIndex() const { return static_cast<int>(m_frameIndex); }
+
+    /**
+     * @brief 获取轮换的缓冲数量
+     * @return 缓冲数量
+     */
+    int getFrameCount() const { return static_cast<int>(m_buffers.size()); }
+
+    /**
+     * @brief 获取每个缓冲的容量
+     * @return 字节数
+     */
+    GLsizeiptr getCapacity() const { return m_capacity; }
+
+    /**
+     * @brief 获取本帧已分配的字节数（含对齐填充）
+     * @return 字节数
+     */
+    GLsizeiptr getBytesUsed() const { return static_cast<GLsizeiptr>(m_staging.size()); }
+
+    /**
+     * @brief 获取最近一帧的统计
+     * @return 统计数据
+     */
+    const Stats &getStats() const { return m_stats; }
+
+private:
+    std::vector<BufferObject> m_buffers;
+    std::vector<std::uint8_t> m_staging; // 本帧的数据，按对齐后的偏移排列
+    size_t m_frameIndex;
+    GLsizeiptr m_capacity;
+    GLsizeiptr m_maxCapacity;
+    bool m_orphaning;
+    Stats m_stats;
+};
+
+#endif // DYNAMICBUFFERRING_H
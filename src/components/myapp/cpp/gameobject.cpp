@@ -1,7 +1,25 @@
 #include "gameobject.h"
+#include "rendercommand.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // 非量化网格共用第一个块，存在时量化网格的块从 1 开始
+    std::uint32_t firstQuantizedBlock(const std::vector<std::shared_ptr<Mesh>> &meshes)
+    {
+        for (const auto &mesh : meshes)
+        {
+            if (mesh && !mesh->isQuantized())
+                return 1;
+        }
+        return 0;
+    }
+}
 
 GameObject::GameObject()
-    : m_name("GameObject"), m_visible(true)
+    : m_name("GameObject"), m_visible(true), m_static(false), m_staticBatched(false), m_revision(0)
 {
     m_position[0] = 0.0f;
     m_position[1] = 0.0f;
@@ -14,10 +32,20 @@ GameObject::GameObject()
     m_scale[0] = 1.0f;
     m_scale[1] = 1.0f;
     m_scale[2] = 1.0f;
+
+    m_color[0] = 1.0f;
+    m_color[1] = 1.0f;
+    m_color[2] = 1.0f;
+    m_color[3] = 1.0f;
+
+    m_instanceParams[0] = 0.0f;
+    m_instanceParams[1] = 0.0f;
+    m_instanceParams[2] = 0.0f;
+    m_instanceParams[3] = 0.0f;
 }
 
 GameObject::GameObject(const std::string &name)
-    : m_name(name), m_visible(true)
+    : m_name(name), m_visible(true), m_static(false), m_staticBatched(false), m_revision(0)
 {
     m_position[0] = 0.0f;
     m_position[1] = 0.0f;
@@ -30,6 +58,16 @@ GameObject::GameObject(const std::string &name)
     m_scale[0] = 1.0f;
     m_scale[1] = 1.0f;
     m_scale[2] = 1.0f;
+
+    m_color[0] = 1.0f;
+    m_color[1] = 1.0f;
+    m_color[2] = 1.0f;
+    m_color[3] = 1.0f;
+
+    m_instanceParams[0] = 0.0f;
+    m_instanceParams[1] = 0.0f;
+    m_instanceParams[2] = 0.0f;
+    m_instanceParams[3] = 0.0f;
 }
 
 GameObject::~GameObject()
@@ -39,7 +77,10 @@ GameObject::~GameObject()
 GameObject::GameObject(GameObject &&other) noexcept
     : m_name(std::move(other.m_name)),
       m_meshes(std::move(other.m_meshes)),
-      m_visible(other.m_visible)
+      m_visible(other.m_visible),
+      m_static(other.m_static),
+      m_staticBatched(other.m_staticBatched),
+      m_revision(other.m_revision)
 {
     m_position[0] = other.m_position[0];
     m_position[1] = other.m_position[1];
@@ -52,6 +93,9 @@ GameObject::GameObject(GameObject &&other) noexcept
     m_scale[0] = other.m_scale[0];
     m_scale[1] = other.m_scale[1];
     m_scale[2] = other.m_scale[2];
+
+    std::memcpy(m_color, other.m_color, sizeof(m_color));
+    std::memcpy(m_instanceParams, other.m_instanceParams, sizeof(m_instanceParams));
 }
 
 GameObject &GameObject::operator=(GameObject &&other) noexcept
@@ -61,6 +105,9 @@ GameObject &GameObject::operator=(GameObject &&other) noexcept
         m_name = std::move(other.m_name);
         m_meshes = std::move(other.m_meshes);
         m_visible = other.m_visible;
+        m_static = other.m_static;
+        m_staticBatched = other.m_staticBatched;
+        m_revision = RenderRevision::bump();
 
         m_position[0] = other.m_position[0];
         m_position[1] = other.m_position[1];
@@ -73,6 +120,9 @@ GameObject &GameObject::operator=(GameObject &&other) noexcept
         m_scale[0] = other.m_scale[0];
         m_scale[1] = other.m_scale[1];
         m_scale[2] = other.m_scale[2];
+
+        std::memcpy(m_color, other.m_color, sizeof(m_color));
+        std::memcpy(m_instanceParams, other.m_instanceParams, sizeof(m_instanceParams));
     }
     return *this;
 }
@@ -84,33 +134,111 @@ void GameObject::setName(const std::string &name)
 
 void GameObject::setPosition(float x, float y, float z)
 {
+    if (m_position[0] == x && m_position[1] == y && m_position[2] == z)
+        return;
+
     m_position[0] = x;
     m_position[1] = y;
     m_position[2] = z;
+    m_revision = RenderRevision::bump();
 }
 
 void GameObject::setRotation(float x, float y, float z)
 {
+    if (m_rotation[0] == x && m_rotation[1] == y && m_rotation[2] == z)
+        return;
+
     m_rotation[0] = x;
     m_rotation[1] = y;
     m_rotation[2] = z;
+    m_revision = RenderRevision::bump();
 }
 
 void GameObject::setScale(float x, float y, float z)
 {
+    if (m_scale[0] == x && m_scale[1] == y && m_scale[2] == z)
+        return;
+
     m_scale[0] = x;
     m_scale[1] = y;
     m_scale[2] = z;
+    m_revision = RenderRevision::bump();
+}
+
+void GameObject::getModelMatrix(float matrix[16]) const
+{
+    constexpr float degreesToRadians = 3.14159265358979323846f / 180.0f;
+    const float cx = std::cos(m_rotation[0] * degreesToRadians);
+    const float sx = std::sin(m_rotation[0] * degreesToRadians);
+    const float cy = std::cos(m_rotation[1] * degreesToRadians);
+    const float sy = std::sin(m_rotation[1] * degreesToRadians);
+    const float cz = std::cos(m_rotation[2] * degreesToRadians);
+    const float sz = std::sin(m_rotation[2] * degreesToRadians);
+
+    // R = Rz * Ry * Rx，每一列再乘以对应轴的缩放
+    matrix[0] = cy * cz * m_scale[0];
+    matrix[1] = cy * sz * m_scale[0];
+    matrix[2] = -sy * m_scale[0];
+    matrix[3] = 0.0f;
+
+    matrix[4] = (sx * sy * cz - cx * sz) * m_scale[1];
+    matrix[5] = (sx * sy * sz + cx * cz) * m_scale[1];
+    matrix[6] = sx * cy * m_scale[1];
+    matrix[7] = 0.0f;
+
+    matrix[8] = (cx * sy * cz + sx * sz) * m_scale[2];
+    matrix[9] = (cx * sy * sz - sx * cz) * m_scale[2];
+    matrix[10] = cx * cy * m_scale[2];
+    matrix[11] = 0.0f;
+
+    matrix[12] = m_position[0];
+    matrix[13] = m_position[1];
+    matrix[14] = m_position[2];
+    matrix[15] = 1.0f;
+}
+
+void GameObject::setColor(float r, float g, float b, float a)
+{
+    if (m_color[0] == r && m_color[1] == g && m_color[2] == b && m_color[3] == a)
+        return;
+
+    m_color[0] = r;
+    m_color[1] = g;
+    m_color[2] = b;
+    m_color[3] = a;
+    m_revision = RenderRevision::bump();
+}
+
+void GameObject::setInstanceParams(float x, float y, float z, float w)
+{
+    if (m_instanceParams[0] == x && m_instanceParams[1] == y && m_instanceParams[2] == z && m_instanceParams[3] == w)
+        return;
+
+    m_instanceParams[0] = x;
+    m_instanceParams[1] = y;
+    m_instanceParams[2] = z;
+    m_instanceParams[3] = w;
+    m_revision = RenderRevision::bump();
+}
+
+void GameObject::getInstanceData(const Mesh &mesh, InstanceData &data) const
+{
+    getModelMatrix(data.model);
+    mesh.applyDequantization(data.model);
+    std::memcpy(data.color, m_color, sizeof(m_color));
+    std::memcpy(data.params, m_instanceParams, sizeof(m_instanceParams));
 }
 
 void GameObject::addMesh(std::shared_ptr<Mesh> mesh)
 {
     m_meshes.push_back(mesh);
+    m_revision = RenderRevision::bump();
 }
 
 void GameObject::render()
 {
-    if (!m_visible)
+    // 已合批的网格由 StaticBatch 绘制
+    if (!m_visible || m_staticBatched)
         return;
 
     // 渲染所有网格
@@ -123,6 +251,94 @@ void GameObject::render()
     }
 }
 
+std::uint32_t GameObject::getObjectUniformCount() const
+{
+    std::uint32_t count = firstQuantizedBlock(m_meshes);
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh && mesh->isQuantized())
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void GameObject::getObjectUniforms(ObjectUniforms *uniforms) const
+{
+    ObjectUniforms base;
+    getModelMatrix(base.model);
+    std::memcpy(base.color, m_color, sizeof(m_color));
+    std::memcpy(base.params, m_instanceParams, sizeof(m_instanceParams));
+
+    std::uint32_t block = firstQuantizedBlock(m_meshes);
+    if (block > 0)
+    {
+        uniforms[0] = base;
+    }
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh && mesh->isQuantized())
+        {
+            uniforms[block] = base;
+            mesh->applyDequantization(uniforms[block].model);
+            ++block;
+        }
+    }
+}
+
+std::uint64_t GameObject::getRevision() const
+{
+    std::uint64_t revision = m_revision;
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh)
+        {
+            revision = std::max(revision, mesh->getRevision());
+        }
+    }
+    return revision;
+}
+
+bool GameObject::usesObjectUniforms() const
+{
+    for (const auto &mesh : m_meshes)
+    {
+        if (mesh && !mesh->isInstanced() && mesh->getMaterial() &&
+            mesh->getMaterial()->usesUniformBlock(UniformBlock::Object))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GameObject::recordCommands(RenderCommandQueue &commandQueue, float depth, std::uint32_t uniformSlot) const
+{
+    if (!m_visible || m_staticBatched)
+        return;
+
+    std::uint32_t quantizedSlot = uniformSlot;
+    if (uniformSlot != DrawCommand::kNoUniformSlot)
+    {
+        quantizedSlot += firstQuantizedBlock(m_meshes);
+    }
+    for (auto &mesh : m_meshes)
+    {
+        if (!mesh)
+            continue;
+
+        if (mesh->isQuantized() && uniformSlot != DrawCommand::kNoUniformSlot)
+        {
+            mesh->recordCommands(commandQueue, depth, quantizedSlot++);
+        }
+        else
+        {
+            mesh->recordCommands(commandQueue, depth, uniformSlot);
+        }
+    }
+}
+
 void GameObject::initialize()
 {
     // 初始化所有网格
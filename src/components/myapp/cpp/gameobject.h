@@ -1,11 +1,12 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
 #include <memory>
 #include <vector>
 #include <string>
 #include "mesh.h"
+#include "renderrevision.h"
 
 /**
  * @brief 游戏对象类
@@ -81,6 +82,61 @@ public:
      */
     const float *getScale() const { return m_scale; }
 
+    /**
+     * @brief 计算模型矩阵：平移 * 旋转(Z * Y * X，角度制) * 缩放
+     * @param matrix 输出的 4x4 列主序矩阵
+     */
+    void getModelMatrix(float matrix[16]) const;
+
+    /**
+     * @brief 设置实例颜色（实例化绘制时写入 InstanceData::color）
+     */
+    void setColor(float r, float g, float b, float a);
+
+    /**
+     * @brief 获取实例颜色
+     * @return 颜色数组 [r, g, b, a]
+     */
+    const float *getColor() const { return m_color; }
+
+    /**
+     * @brief 设置实例自定义参数（实例化绘制时写入 InstanceData::params）
+     */
+    void setInstanceParams(float x, float y, float z, float w);
+
+    /**
+     * @brief 获取实例自定义参数
+     * @return 参数数组 [x, y, z, w]
+     */
+    const float *getInstanceParams() const { return m_instanceParams; }
+
+    /**
+     * @brief 填写实例化绘制使用的实例数据
+     * @param mesh 实例化绘制的网格，量化网格的反量化变换右乘到模型矩阵上
+     * @param data 输出的实例数据
+     */
+    void getInstanceData(const Mesh &mesh, InstanceData &data) const;
+
+    /**
+     * @brief 获取对象需要的 ObjectBlock 数量
+     *
+     * 非量化网格共用一个块，每个量化网格各占一个块，模型矩阵包含该网格的反量化变换
+     * @return 块数量
+     */
+    std::uint32_t getObjectUniformCount() const;
+
+    /**
+     * @brief 填写着色器 ObjectBlock 使用的逐对象数据
+     * @param uniforms 输出的块数据，数量为 getObjectUniformCount()
+     */
+    void getObjectUniforms(ObjectUniforms *uniforms) const;
+
+    /**
+     * @brief 检查是否有非实例化网格的材质声明了 ObjectBlock
+     * @return 是否需要逐对象 uniform 块
+     */
+    bool usesObjectUniforms() const;
+
     /**
      * @brief 添加网格
      * @param mesh 网格对象
@@ -98,6 +154,15 @@ public:
      */
     void render();
 
+    /**
+     * @brief 录制所有网格的渲染命令
+     * @param commandQueue 命令队列
+     * @param depth 归一化视图深度，0 为最近，用于排序
+     * @param uniformSlot 对象第一个 ObjectBlock 的槽位，量化网格使用其后各自的槽位（见 getObjectUniforms）
+     */
+    void recordCommands(RenderCommandQueue &commandQueue, float depth,
+                        std::uint32_t uniformSlot = DrawCommand::kNoUniformSlot) const;
+
     /**
      * @brief 检查对象是否可见
      * @return 是否可见
@@ -108,7 +173,54 @@ public:
      * @brief 设置可见性
      * @param visible 是否可见
      */
-    void setVisible(bool visible) { m_visible = visible; }
+    void setVisible(bool visible)
+    {
+        if (m_visible != visible)
+        {
+            m_visible = visible;
+            m_revision = RenderRevision::bump();
+        }
+    }
+
+    /**
+     * @brief 标记为静态对象
+     *
+     * 静态对象在 Scene::initialize() 中与使用相同材质的其他静态对象合批，
+     * 之后只能改变可见性，变换和网格的修改不会反映到合批数据中
+     * @param isStatic 是否静态
+     */
+    void setStatic(bool isStatic) { m_static = isStatic; }
+
+    /**
+     * @brief 检查是否为静态对象
+     * @return 是否静态
+     */
+    bool isStatic() const { return m_static; }
+
+    /**
+     * @brief 设置网格是否已被静态合批接管（由 Scene 设置），接管后对象不再单独绘制网格
+     * @param batched 是否已合批
+     */
+    void setStaticBatched(bool batched)
+    {
+        if (m_staticBatched != batched)
+        {
+            m_staticBatched = batched;
+            m_revision = RenderRevision::bump();
+        }
+    }
+
+    /**
+     * @brief 检查网格是否已被静态合批接管
+     * @return 是否已合批
+     */
+    bool isStaticBatched() const { return m_staticBatched; }
+
+    /**
+     * @brief 获取影响录制命令的最近一次修改的修订号（包括网格、材质和着色器）
+     * @return 修订号（见 RenderRevision）
+     */
+    std::uint64_t getRevision() const;
 
     /**
      * @brief 初始化游戏对象
@@ -126,8 +238,13 @@ private:
     float m_position[3];
     float m_rotation[3];
     float m_scale[3];
+    float m_color[4];
+    float m_instanceParams[4];
     std::vector<std::shared_ptr<Mesh>> m_meshes;
     bool m_visible;
+    bool m_static;
+    bool m_staticBatched;
+    std::uint64_t m_revision; // 对象自身最近一次修改的修订号
 };
 
 #endif // GAMEOBJECT_H
@@ -0,0 +1,33 @@
+#ifndef GLAPI_H
+#define GLAPI_H
+
+/**
+ * @brief OpenGL 头文件统一入口
+ *
+ * Emscripten 构建通过 GLFW/WebGL2 提供 GL 函数；
+ * 原生主机构建只使用 Khronos GLES3 头文件中的声明，
+ * 函数实现由 glbackend_host.cpp 转发到可替换的 GLBackend。
+ */
+#ifdef __EMSCRIPTEN__
+#include <GLFW/glfw3.h>
+#endif
+
+#include <GLES3/gl3.h>
+
+// WEBGL_multi_draw：浏览器中由 Emscripten 提供，原生主机由 glbackend_host.cpp 转发到 GLBackend
+#ifdef __EMSCRIPTEN__
+#include <webgl/webgl1_ext.h>
+#else
+extern "C" void glMultiDrawElementsWEBGL(GLenum mode, const GLsizei *counts, GLenum type,
+                                         const void *const *offsets, GLsizei drawcount);
+#endif
+
+// KHR_parallel_shader_compile：轮询编译/链接是否完成而不阻塞
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// 调用统计：ENGINE_GL_STATS 启用时把 gl* 入口重定向到 GLStats
+#include "glstats.h"
+
+#endif // GLAPI_H
@@ -0,0 +1,816 @@
+#include "glbackend.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+    NullGLBackend &defaultBackend()
+    {
+        static NullGLBackend backend;
+        return backend;
+    }
+
+    GLBackend *g_currentBackend = nullptr;
+
+    void writeEmptyLog(GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+    {
+        if (length)
+        {
+            *length = 0;
+        }
+        if (infoLog && bufSize > 0)
+        {
+            infoLog[0] = '\0';
+        }
+    }
+
+    // 计算 #ifdef/#ifndef/#if defined(NAME)/#elif defined(NAME) 的条件，其他表达式视为成立
+    bool evaluateCondition(const std::string &directive, const std::string &argument,
+                           const std::vector<std::string> &defines)
+    {
+        auto isDefined = [&defines](const std::string &name)
+        {
+            return std::find(defines.begin(), defines.end(), name) != defines.end();
+        };
+
+        if (directive == "ifdef")
+            return isDefined(argument);
+        if (directive == "ifndef")
+            return !isDefined(argument);
+
+        const bool negated = argument.compare(0, 1, "!") == 0;
+        size_t open = argument.find("defined");
+        if (open == std::string::npos)
+            return true;
+        open = argument.find_first_not_of(" \t(", open + 7);
+        size_t close = argument.find_first_of(" \t)", open);
+        bool result = open != std::string::npos && isDefined(argument.substr(open, close - open));
+        return negated ? !result : result;
+    }
+
+    /**
+     * @brief 去掉条件编译排除的代码和所有预处理指令，只支持着色器变体使用的简单写法
+     */
+    std::string stripInactiveCode(const std::string &source)
+    {
+        struct Branch
+        {
+            bool parentActive;
+            bool taken; // 已经有分支成立
+            bool active;
+        };
+
+        std::vector<std::string> defines;
+        std::vector<Branch> branches;
+        std::string result;
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            const bool active = branches.empty() || branches.back().active;
+            size_t hash = line.find_first_not_of(" \t");
+            if (hash == std::string::npos || line[hash] != '#')
+            {
+                if (active)
+                {
+                    result += line;
+                    result += '\n';
+                }
+                continue;
+            }
+
+            std::istringstream words(line.substr(hash + 1));
+            std::string directive;
+            words >> directive;
+            std::string argument;
+            std::getline(words >> std::ws, argument);
+
+            if (directive == "ifdef" || directive == "ifndef" || directive == "if")
+            {
+                bool condition = active && evaluateCondition(directive, argument, defines);
+                branches.push_back({active, condition, condition});
+            }
+            else if (directive == "elif" && !branches.empty())
+            {
+                Branch &branch = branches.back();
+                branch.active = branch.parentActive && !branch.taken && evaluateCondition(directive, argument, defines);
+                branch.taken = branch.taken || branch.active;
+            }
+            else if (directive == "else" && !branches.empty())
+            {
+                Branch &branch = branches.back();
+                branch.active = branch.parentActive && !branch.taken;
+                branch.taken = true;
+            }
+            else if (directive == "endif" && !branches.empty())
+            {
+                branches.pop_back();
+            }
+            else if (directive == "define" && active)
+            {
+                std::istringstream name(argument);
+                std::string defined;
+                name >> defined;
+                defines.push_back(defined);
+            }
+            else if (directive == "undef" && active)
+            {
+                defines.erase(std::remove(defines.begin(), defines.end(), argument), defines.end());
+            }
+        }
+        return result;
+    }
+
+    void writeName(const std::string &value, GLsizei bufSize, GLsizei *length, GLchar *name)
+    {
+        GLsizei count = 0;
+        if (name && bufSize > 0)
+        {
+            count = std::min(static_cast<GLsizei>(value.size()), bufSize - 1);
+            std::memcpy(name, value.data(), static_cast<size_t>(count));
+            name[count] = '\0';
+        }
+        if (length)
+        {
+            *length = count;
+        }
+    }
+
+    GLenum glslType(const std::string &type)
+    {
+        static const std::unordered_map<std::string, GLenum> types = {
+            {"float", GL_FLOAT},
+            {"vec2", GL_FLOAT_VEC2},
+            {"vec3", GL_FLOAT_VEC3},
+            {"vec4", GL_FLOAT_VEC4},
+            {"int", GL_INT},
+            {"ivec2", GL_INT_VEC2},
+            {"ivec3", GL_INT_VEC3},
+            {"ivec4", GL_INT_VEC4},
+            {"bool", GL_BOOL},
+            {"mat3", GL_FLOAT_MAT3},
+            {"mat4", GL_FLOAT_MAT4},
+            {"sampler2D", GL_SAMPLER_2D},
+            {"sampler3D", GL_SAMPLER_3D},
+            {"samplerCube", GL_SAMPLER_CUBE},
+            {"sampler2DArray", GL_SAMPLER_2D_ARRAY},
+        };
+        auto it = types.find(type);
+        return it != types.end() ? it->second : GL_FLOAT;
+    }
+}
+
+GLBackend &GLBackend::current()
+{
+    return g_currentBackend ? *g_currentBackend : defaultBackend();
+}
+
+void GLBackend::setCurrent(GLBackend *backend)
+{
+    g_currentBackend = backend;
+}
+
+// ---------------------------------------------------------------------------
+// NullGLBackend
+// ---------------------------------------------------------------------------
+
+void NullGLBackend::genBuffers(GLsizei n, GLuint *buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = nextName();
+    }
+}
+
+void NullGLBackend::genVertexArrays(GLsizei n, GLuint *arrays)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        arrays[i] = nextName();
+    }
+}
+
+void NullGLBackend::genTextures(GLsizei n, GLuint *textures)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        textures[i] = nextName();
+    }
+}
+
+void NullGLBackend::getShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    // 编译总是成功，没有日志
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void NullGLBackend::getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    writeEmptyLog(bufSize, length, infoLog);
+}
+
+void NullGLBackend::getProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    // 链接总是成功，没有日志；活动 uniform 和 uniform 块来自链接时解析的源码
+    auto it = m_programs.find(program);
+    ProgramInterface *interface = it != m_programs.end() ? &it->second : nullptr;
+    switch (pname)
+    {
+    case GL_LINK_STATUS:
+        *params = GL_TRUE;
+        break;
+    case GL_COMPLETION_STATUS_KHR:
+        if (interface && interface->pendingPolls > 0)
+        {
+            --interface->pendingPolls;
+            *params = GL_FALSE;
+        }
+        else
+        {
+            *params = GL_TRUE;
+        }
+        break;
+    case GL_ACTIVE_UNIFORMS:
+        *params = interface ? static_cast<GLint>(interface->uniforms.size()) : 0;
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+        *params = 0;
+        for (size_t i = 0; interface && i < interface->uniforms.size(); ++i)
+        {
+            *params = std::max(*params, static_cast<GLint>(interface->uniforms[i].name.size() + 1));
+        }
+        break;
+    case GL_ACTIVE_UNIFORM_BLOCKS:
+        *params = interface ? static_cast<GLint>(interface->blocks.size()) : 0;
+        break;
+    case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+        *params = 0;
+        for (size_t i = 0; interface && i < interface->blocks.size(); ++i)
+        {
+            *params = std::max(*params, static_cast<GLint>(interface->blocks[i].size() + 1));
+        }
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+void NullGLBackend::getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    writeEmptyLog(bufSize, length, infoLog);
+}
+
+GLint NullGLBackend::getUniformLocation(GLuint program, const GLchar *name)
+{
+    // 同名uniform在所有程序中返回同一个位置，保证录制结果稳定
+    auto it = m_uniformLocations.find(name);
+    if (it != m_uniformLocations.end())
+    {
+        return it->second;
+    }
+    GLint location = static_cast<GLint>(m_uniformLocations.size());
+    m_uniformLocations.emplace(name, location);
+    return location;
+}
+
+void NullGLBackend::shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    std::string &source = m_shaderSources[shader];
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length && length[i] >= 0)
+        {
+            source.append(string[i], static_cast<size_t>(length[i]));
+        }
+        else
+        {
+            source.append(string[i]);
+        }
+    }
+}
+
+void NullGLBackend::deleteShader(GLuint shader)
+{
+    m_shaderSources.erase(shader);
+}
+
+void NullGLBackend::attachShader(GLuint program, GLuint shader)
+{
+    m_attachedShaders[program].push_back(shader);
+}
+
+void NullGLBackend::linkProgram(GLuint program)
+{
+    // 着色器在链接后通常立即删除，链接时解析附加着色器的接口
+    ProgramInterface &interface = m_programs[program];
+    interface = {};
+    interface.pendingPolls = m_completionLatency;
+    for (GLuint shader : m_attachedShaders[program])
+    {
+        auto it = m_shaderSources.find(shader);
+        if (it != m_shaderSources.end())
+        {
+            parseInterface(stripInactiveCode(it->second), interface);
+        }
+    }
+}
+
+void NullGLBackend::deleteProgram(GLuint program)
+{
+    m_attachedShaders.erase(program);
+    m_programs.erase(program);
+}
+
+void NullGLBackend::parseInterface(const std::string &source, ProgramInterface &interface)
+{
+    // 切分为标识符/数字和单个标点
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < source.size();)
+    {
+        const unsigned char c = static_cast<unsigned char>(source[i]);
+        if (std::isspace(c))
+        {
+            ++i;
+        }
+        else if (std::isalnum(c) || c == '_')
+        {
+            size_t begin = i;
+            while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+            {
+                ++i;
+            }
+            tokens.emplace_back(source, begin, i - begin);
+        }
+        else
+        {
+            tokens.emplace_back(1, source[i++]);
+        }
+    }
+
+    auto token = [&tokens](size_t i) -> const std::string &
+    {
+        static const std::string empty;
+        return i < tokens.size() ? tokens[i] : empty;
+    };
+
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens[i] != "uniform")
+            continue;
+
+        size_t j = i + 1;
+        if (token(j) == "lowp" || token(j) == "mediump" || token(j) == "highp")
+        {
+            ++j;
+        }
+
+        // uniform 块：uniform Name { ... };
+        if (token(j + 1) == "{")
+        {
+            const std::string &name = token(j);
+            if (std::find(interface.blocks.begin(), interface.blocks.end(), name) == interface.blocks.end())
+            {
+                interface.blocks.push_back(name);
+            }
+            while (j < tokens.size() && tokens[j] != "}")
+            {
+                ++j;
+            }
+            i = j;
+            continue;
+        }
+
+        // 普通 uniform：uniform type name[N], name2;
+        const GLenum type = glslType(token(j));
+        for (++j; j < tokens.size() && tokens[j] != ";"; ++j)
+        {
+            if (tokens[j] == ",")
+                continue;
+
+            UniformDeclaration declaration{tokens[j], type, 1};
+            if (token(j + 1) == "[")
+            {
+                declaration.size = std::max(1, std::atoi(token(j + 2).c_str()));
+                declaration.name += "[0]";
+                j += 3;
+            }
+            auto sameName = [&declaration](const UniformDeclaration &other)
+            { return other.name == declaration.name; };
+            if (std::none_of(interface.uniforms.begin(), interface.uniforms.end(), sameName))
+            {
+                interface.uniforms.push_back(declaration);
+            }
+        }
+        i = j;
+    }
+}
+
+void NullGLBackend::getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                                     GLenum *type, GLchar *name)
+{
+    auto it = m_programs.find(program);
+    if (it == m_programs.end() || index >= it->second.uniforms.size())
+    {
+        writeName("", bufSize, length, name);
+        *size = 0;
+        *type = 0;
+        return;
+    }
+    const UniformDeclaration &declaration = it->second.uniforms[index];
+    writeName(declaration.name, bufSize, length, name);
+    *size = declaration.size;
+    *type = declaration.type;
+}
+
+void NullGLBackend::getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize,
+                                              GLsizei *length, GLchar *uniformBlockName)
+{
+    auto it = m_programs.find(program);
+    const bool valid = it != m_programs.end() && uniformBlockIndex < it->second.blocks.size();
+    writeName(valid ? it->second.blocks[uniformBlockIndex] : std::string(), bufSize, length, uniformBlockName);
+}
+
+GLuint NullGLBackend::getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName)
+{
+    auto it = m_programs.find(program);
+    if (it == m_programs.end())
+    {
+        return GL_INVALID_INDEX;
+    }
+    const std::vector<std::string> &blocks = it->second.blocks;
+    auto block = std::find(blocks.begin(), blocks.end(), uniformBlockName);
+    return block != blocks.end() ? static_cast<GLuint>(block - blocks.begin()) : GL_INVALID_INDEX;
+}
+
+void NullGLBackend::getIntegerv(GLenum pname, GLint *data)
+{
+    // 返回常见桌面驱动的限制值，其他查询返回 0
+    switch (pname)
+    {
+    case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+        *data = 256;
+        break;
+    case GL_MAX_UNIFORM_BLOCK_SIZE:
+        *data = 65536;
+        break;
+    case GL_MAX_UNIFORM_BUFFER_BINDINGS:
+        *data = 72;
+        break;
+    default:
+        *data = 0;
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// RecordingGLBackend
+// ---------------------------------------------------------------------------
+
+void RecordingGLBackend::record(GLCallType type, std::int64_t arg0, std::int64_t arg1)
+{
+    ++m_counts[static_cast<size_t>(type)];
+    if (m_logEnabled)
+    {
+        m_calls.push_back({type, arg0, arg1});
+    }
+}
+
+std::uint64_t RecordingGLBackend::totalCalls() const
+{
+    std::uint64_t total = 0;
+    for (auto count : m_counts)
+    {
+        total += count;
+    }
+    return total;
+}
+
+void RecordingGLBackend::reset()
+{
+    m_counts.fill(0);
+    m_calls.clear();
+}
+
+std::string RecordingGLBackend::summary() const
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < m_counts.size(); ++i)
+    {
+        if (m_counts[i] > 0)
+        {
+            out << glCallTypeName(static_cast<GLCallType>(i)) << ": " << m_counts[i] << "\n";
+        }
+    }
+    out << "total: " << totalCalls() << "\n";
+    return out.str();
+}
+
+void RecordingGLBackend::genBuffers(GLsizei n, GLuint *buffers)
+{
+    record(GLCallType::GenBuffers, n);
+    NullGLBackend::genBuffers(n, buffers);
+}
+
+void RecordingGLBackend::deleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    record(GLCallType::DeleteBuffers, n);
+}
+
+void RecordingGLBackend::bindBuffer(GLenum target, GLuint buffer)
+{
+    record(GLCallType::BindBuffer, target, buffer);
+}
+
+void RecordingGLBackend::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    record(GLCallType::BufferData, target, size);
+}
+
+void RecordingGLBackend::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    record(GLCallType::BufferSubData, target, size);
+}
+
+void RecordingGLBackend::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    record(GLCallType::BindBufferRange, index, offset);
+}
+
+void RecordingGLBackend::genVertexArrays(GLsizei n, GLuint *arrays)
+{
+    record(GLCallType::GenVertexArrays, n);
+    NullGLBackend::genVertexArrays(n, arrays);
+}
+
+void RecordingGLBackend::deleteVertexArrays(GLsizei n, const GLuint *arrays)
+{
+    record(GLCallType::DeleteVertexArrays, n);
+}
+
+void RecordingGLBackend::bindVertexArray(GLuint array)
+{
+    record(GLCallType::BindVertexArray, array);
+}
+
+void RecordingGLBackend::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                             GLsizei stride, const void *pointer)
+{
+    record(GLCallType::VertexAttribPointer, index, size);
+}
+
+void RecordingGLBackend::enableVertexAttribArray(GLuint index)
+{
+    record(GLCallType::EnableVertexAttribArray, index);
+}
+
+void RecordingGLBackend::disableVertexAttribArray(GLuint index)
+{
+    record(GLCallType::DisableVertexAttribArray, index);
+}
+
+void RecordingGLBackend::vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    record(GLCallType::VertexAttribDivisor, index, divisor);
+}
+
+void RecordingGLBackend::genTextures(GLsizei n, GLuint *textures)
+{
+    record(GLCallType::GenTextures, n);
+    NullGLBackend::genTextures(n, textures);
+}
+
+void RecordingGLBackend::deleteTextures(GLsizei n, const GLuint *textures)
+{
+    record(GLCallType::DeleteTextures, n);
+}
+
+void RecordingGLBackend::bindTexture(GLenum target, GLuint texture)
+{
+    record(GLCallType::BindTexture, target, texture);
+}
+
+void RecordingGLBackend::activeTexture(GLenum texture)
+{
+    record(GLCallType::ActiveTexture, texture);
+}
+
+void RecordingGLBackend::texParameteri(GLenum target, GLenum pname, GLint param)
+{
+    record(GLCallType::TexParameteri, pname, param);
+}
+
+void RecordingGLBackend::texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                    GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    record(GLCallType::TexImage2D, width, height);
+}
+
+GLuint RecordingGLBackend::createShader(GLenum type)
+{
+    GLuint shader = NullGLBackend::createShader(type);
+    record(GLCallType::CreateShader, type, shader);
+    return shader;
+}
+
+void RecordingGLBackend::shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    record(GLCallType::ShaderSource, shader, count);
+    NullGLBackend::shaderSource(shader, count, string, length);
+}
+
+void RecordingGLBackend::compileShader(GLuint shader)
+{
+    record(GLCallType::CompileShader, shader);
+}
+
+void RecordingGLBackend::getShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    record(GLCallType::GetShaderiv, shader, pname);
+    NullGLBackend::getShaderiv(shader, pname, params);
+}
+
+void RecordingGLBackend::getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    record(GLCallType::GetShaderInfoLog, shader);
+    NullGLBackend::getShaderInfoLog(shader, bufSize, length, infoLog);
+}
+
+void RecordingGLBackend::deleteShader(GLuint shader)
+{
+    record(GLCallType::DeleteShader, shader);
+    NullGLBackend::deleteShader(shader);
+}
+
+GLuint RecordingGLBackend::createProgram()
+{
+    GLuint program = NullGLBackend::createProgram();
+    record(GLCallType::CreateProgram, program);
+    return program;
+}
+
+void RecordingGLBackend::attachShader(GLuint program, GLuint shader)
+{
+    record(GLCallType::AttachShader, program, shader);
+    NullGLBackend::attachShader(program, shader);
+}
+
+void RecordingGLBackend::linkProgram(GLuint program)
+{
+    record(GLCallType::LinkProgram, program);
+    NullGLBackend::linkProgram(program);
+}
+
+void RecordingGLBackend::getProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    record(GLCallType::GetProgramiv, program, pname);
+    NullGLBackend::getProgramiv(program, pname, params);
+}
+
+void RecordingGLBackend::getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    record(GLCallType::GetProgramInfoLog, program);
+    NullGLBackend::getProgramInfoLog(program, bufSize, length, infoLog);
+}
+
+void RecordingGLBackend::deleteProgram(GLuint program)
+{
+    record(GLCallType::DeleteProgram, program);
+    NullGLBackend::deleteProgram(program);
+}
+
+void RecordingGLBackend::useProgram(GLuint program)
+{
+    record(GLCallType::UseProgram, program);
+}
+
+GLint RecordingGLBackend::getUniformLocation(GLuint program, const GLchar *name)
+{
+    GLint location = NullGLBackend::getUniformLocation(program, name);
+    record(GLCallType::GetUniformLocation, program, location);
+    return location;
+}
+
+void RecordingGLBackend::getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                                          GLenum *type, GLchar *name)
+{
+    record(GLCallType::GetActiveUniform, program, index);
+    NullGLBackend::getActiveUniform(program, index, bufSize, length, size, type, name);
+}
+
+void RecordingGLBackend::getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize,
+                                                   GLsizei *length, GLchar *uniformBlockName)
+{
+    record(GLCallType::GetActiveUniformBlockName, program, uniformBlockIndex);
+    NullGLBackend::getActiveUniformBlockName(program, uniformBlockIndex, bufSize, length, uniformBlockName);
+}
+
+void RecordingGLBackend::uniform1i(GLint location, GLint v0)
+{
+    record(GLCallType::Uniform1i, location, v0);
+}
+
+void RecordingGLBackend::uniform1f(GLint location, GLfloat v0)
+{
+    record(GLCallType::Uniform1f, location);
+}
+
+void RecordingGLBackend::uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    record(GLCallType::Uniform3f, location);
+}
+
+void RecordingGLBackend::uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    record(GLCallType::Uniform4f, location);
+}
+
+GLuint RecordingGLBackend::getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName)
+{
+    GLuint index = NullGLBackend::getUniformBlockIndex(program, uniformBlockName);
+    record(GLCallType::GetUniformBlockIndex, program, index);
+    return index;
+}
+
+void RecordingGLBackend::uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+    record(GLCallType::UniformBlockBinding, uniformBlockIndex, uniformBlockBinding);
+}
+
+void RecordingGLBackend::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    record(GLCallType::DrawArrays, mode, count);
+}
+
+void RecordingGLBackend::drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    record(GLCallType::DrawElements, mode, count);
+}
+
+void RecordingGLBackend::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+    record(GLCallType::DrawArraysInstanced, count, instanceCount);
+}
+
+void RecordingGLBackend::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                               GLsizei instanceCount)
+{
+    record(GLCallType::DrawElementsInstanced, count, instanceCount);
+}
+
+void RecordingGLBackend::multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type,
+                                           const void *const *offsets, GLsizei drawcount)
+{
+    record(GLCallType::MultiDrawElementsWEBGL, mode, drawcount);
+}
+
+void RecordingGLBackend::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    record(GLCallType::ClearColor);
+}
+
+void RecordingGLBackend::clear(GLbitfield mask)
+{
+    record(GLCallType::Clear, mask);
+}
+
+void RecordingGLBackend::enable(GLenum cap)
+{
+    record(GLCallType::Enable, cap);
+}
+
+void RecordingGLBackend::disable(GLenum cap)
+{
+    record(GLCallType::Disable, cap);
+}
+
+void RecordingGLBackend::blendFunc(GLenum sfactor, GLenum dfactor)
+{
+    record(GLCallType::BlendFunc, sfactor, dfactor);
+}
+
+void RecordingGLBackend::depthFunc(GLenum func)
+{
+    record(GLCallType::DepthFunc, func);
+}
+
+void RecordingGLBackend::depthMask(GLboolean flag)
+{
+    record(GLCallType::DepthMask, flag);
+}
+
+void RecordingGLBackend::cullFace(GLenum mode)
+{
+    record(GLCallType::CullFace, mode);
+}
+
+void RecordingGLBackend::getIntegerv(GLenum pname, GLint *data)
+{
+    record(GLCallType::GetIntegerv, pname);
+    NullGLBackend::getIntegerv(pname, data);
+}
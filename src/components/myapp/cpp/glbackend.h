@@ -0,0 +1,372 @@
+#ifndef GLBACKEND_H
+#define GLBACKEND_H
+
+#include "glapi.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief GL 后端接口
+ *
+ * 原生主机构建中所有 gl* 函数都转发到当前后端，
+ * 便于在没有 GPU/浏览器的环境中运行引擎并做性能分析
+ */
+class GLBackend
+{
+public:
+    virtual ~GLBackend() = default;
+
+    // 缓冲对象
+    virtual void genBuffers(GLsizei n, GLuint *buffers) = 0;
+    virtual void deleteBuffers(GLsizei n, const GLuint *buffers) = 0;
+    virtual void bindBuffer(GLenum target, GLuint buffer) = 0;
+    virtual void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) = 0;
+    virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) = 0;
+    virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
+
+    // 顶点数组对象
+    virtual void genVertexArrays(GLsizei n, GLuint *arrays) = 0;
+    virtual void deleteVertexArrays(GLsizei n, const GLuint *arrays) = 0;
+    virtual void bindVertexArray(GLuint array) = 0;
+    virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                     GLsizei stride, const void *pointer) = 0;
+    virtual void enableVertexAttribArray(GLuint index) = 0;
+    virtual void disableVertexAttribArray(GLuint index) = 0;
+    virtual void vertexAttribDivisor(GLuint index, GLuint divisor) = 0;
+
+    // 纹理
+    virtual void genTextures(GLsizei n, GLuint *textures) = 0;
+    virtual void deleteTextures(GLsizei n, const GLuint *textures) = 0;
+    virtual void bindTexture(GLenum target, GLuint texture) = 0;
+    virtual void activeTexture(GLenum texture) = 0;
+    virtual void texParameteri(GLenum target, GLenum pname, GLint param) = 0;
+    virtual void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                            GLint border, GLenum format, GLenum type, const void *pixels) = 0;
+
+    // 着色器和程序
+    virtual GLuint createShader(GLenum type) = 0;
+    virtual void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) = 0;
+    virtual void compileShader(GLuint shader) = 0;
+    virtual void getShaderiv(GLuint shader, GLenum pname, GLint *params) = 0;
+    virtual void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) = 0;
+    virtual void deleteShader(GLuint shader) = 0;
+    virtual GLuint createProgram() = 0;
+    virtual void attachShader(GLuint program, GLuint shader) = 0;
+    virtual void linkProgram(GLuint program) = 0;
+    virtual void getProgramiv(GLuint program, GLenum pname, GLint *params) = 0;
+    virtual void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) = 0;
+    virtual void deleteProgram(GLuint program) = 0;
+    virtual void useProgram(GLuint program) = 0;
+    virtual GLint getUniformLocation(GLuint program, const GLchar *name) = 0;
+    virtual void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                                  GLenum *type, GLchar *name) = 0;
+    virtual void getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize,
+                                           GLsizei *length, GLchar *uniformBlockName) = 0;
+    virtual void uniform1i(GLint location, GLint v0) = 0;
+    virtual void uniform1f(GLint location, GLfloat v0) = 0;
+    virtual void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) = 0;
+    virtual void uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) = 0;
+    virtual GLuint getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName) = 0;
+    virtual void uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) = 0;
+
+    // 绘制
+    virtual void drawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) = 0;
+    virtual void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) = 0;
+    virtual void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                       GLsizei instanceCount) = 0;
+    virtual void multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                                   GLsizei drawcount) = 0;
+    virtual void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) = 0;
+    virtual void clear(GLbitfield mask) = 0;
+
+    // 渲染状态
+    virtual void enable(GLenum cap) = 0;
+    virtual void disable(GLenum cap) = 0;
+    virtual void blendFunc(GLenum sfactor, GLenum dfactor) = 0;
+    virtual void depthFunc(GLenum func) = 0;
+    virtual void depthMask(GLboolean flag) = 0;
+    virtual void cullFace(GLenum mode) = 0;
+
+    // 状态查询
+    virtual void getIntegerv(GLenum pname, GLint *data) = 0;
+
+    /**
+     * @brief 获取当前后端
+     * @return 当前后端（未设置时为全局空后端）
+     */
+    static GLBackend &current();
+
+    /**
+     * @brief 设置当前后端
+     * @param backend 后端对象，传入nullptr恢复为全局空后端
+     */
+    static void setCurrent(GLBackend *backend);
+};
+
+/**
+ * @brief 空 GL 后端
+ *
+ * 不做任何渲染，只分配对象名并对状态查询返回成功，
+ * 用于测量引擎自身的 CPU 开销
+ */
+class NullGLBackend : public GLBackend
+{
+public:
+    NullGLBackend() = default;
+    ~NullGLBackend() override = default;
+
+    void genBuffers(GLsizei n, GLuint *buffers) override;
+    void deleteBuffers(GLsizei n, const GLuint *buffers) override {}
+    void bindBuffer(GLenum target, GLuint buffer) override {}
+    void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) override {}
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) override {}
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override {}
+
+    void genVertexArrays(GLsizei n, GLuint *arrays) override;
+    void deleteVertexArrays(GLsizei n, const GLuint *arrays) override {}
+    void bindVertexArray(GLuint array) override {}
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                             GLsizei stride, const void *pointer) override {}
+    void enableVertexAttribArray(GLuint index) override {}
+    void disableVertexAttribArray(GLuint index) override {}
+    void vertexAttribDivisor(GLuint index, GLuint divisor) override {}
+
+    void genTextures(GLsizei n, GLuint *textures) override;
+    void deleteTextures(GLsizei n, const GLuint *textures) override {}
+    void bindTexture(GLenum target, GLuint texture) override {}
+    void activeTexture(GLenum texture) override {}
+    void texParameteri(GLenum target, GLenum pname, GLint param) override {}
+    void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                    GLint border, GLenum format, GLenum type, const void *pixels) override {}
+
+    GLuint createShader(GLenum type) override { return nextName(); }
+    void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) override;
+    void compileShader(GLuint shader) override {}
+    void getShaderiv(GLuint shader, GLenum pname, GLint *params) override;
+    void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) override;
+    void deleteShader(GLuint shader) override;
+    GLuint createProgram() override { return nextName(); }
+    void attachShader(GLuint program, GLuint shader) override;
+    void linkProgram(GLuint program) override;
+    void getProgramiv(GLuint program, GLenum pname, GLint *params) override;
+    void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) override;
+    void deleteProgram(GLuint program) override;
+    void useProgram(GLuint program) override {}
+    GLint getUniformLocation(GLuint program, const GLchar *name) override;
+    void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                          GLenum *type, GLchar *name) override;
+    void getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length,
+                                   GLchar *uniformBlockName) override;
+    void uniform1i(GLint location, GLint v0) override {}
+    void uniform1f(GLint location, GLfloat v0) override {}
+    void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) override {}
+    void uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) override {}
+    GLuint getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName) override;
+    void uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) override {}
+
+    void drawArrays(GLenum mode, GLint first, GLsizei count) override {}
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) override {}
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) override {}
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                               GLsizei instanceCount) override {}
+    void multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                           GLsizei drawcount) override {}
+    void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override {}
+    void clear(GLbitfield mask) override {}
+
+    void enable(GLenum cap) override {}
+    void disable(GLenum cap) override {}
+    void blendFunc(GLenum sfactor, GLenum dfactor) override {}
+    void depthFunc(GLenum func) override {}
+    void depthMask(GLboolean flag) override {}
+    void cullFace(GLenum mode) override {}
+
+    void getIntegerv(GLenum pname, GLint *data) override;
+
+    /**
+     * @brief 模拟异步链接：每个程序链接后前 polls 次查询 GL_COMPLETION_STATUS_KHR 返回 GL_FALSE
+     * @param polls 查询次数，0 表示链接立即完成
+     */
+    void setCompletionLatency(int polls) { m_completionLatency = polls; }
+
+protected:
+    GLuint nextName() { return ++m_lastName; }
+
+private:
+    GLuint m_lastName = 0;
+    int m_completionLatency = 0;
+    std::unordered_map<std::string, GLint> m_uniformLocations;
+    /**
+     * @brief 从源码中解析出的 uniform 声明
+     */
+    struct UniformDeclaration
+    {
+        std::string name;
+        GLenum type;
+        GLint size; // 数组长度，非数组为 1
+    };
+
+    /**
+     * @brief 链接时从源码解析的程序接口
+     */
+    struct ProgramInterface
+    {
+        std::vector<UniformDeclaration> uniforms; // 块外的 uniform，按声明顺序
+        std::vector<std::string> blocks;          // uniform 块名称，按声明顺序
+        int pendingPolls = 0;                     // 还要返回未完成的 GL_COMPLETION_STATUS_KHR 查询次数
+    };
+
+    /**
+     * @brief 解析 GLSL 源码中的 uniform 声明（只识别引擎着色器使用的写法）
+     */
+    static void parseInterface(const std::string &source, ProgramInterface &interface);
+
+    std::unordered_map<GLuint, std::string> m_shaderSources;           // 着色器源码，用于反射
+    std::unordered_map<GLuint, std::vector<GLuint>> m_attachedShaders; // 程序附加的着色器
+    std::unordered_map<GLuint, ProgramInterface> m_programs;           // 链接时解析的程序接口
+};
+
+/**
+ * @brief 单条录制的 GL 调用
+ *
+ * 只保留对分析有用的两个整数参数，例如 BindBuffer 的(target, buffer)、
+ * BufferData 的(target, size)、DrawElements 的(mode, count)
+ */
+struct GLCall
+{
+    GLCallType type;
+    std::int64_t arg0;
+    std::int64_t arg1;
+};
+
+/**
+ * @brief 录制 GL 后端
+ *
+ * 在空后端的基础上统计每种调用的次数，并可选地保存完整调用序列
+ */
+class RecordingGLBackend : public NullGLBackend
+{
+public:
+    RecordingGLBackend() = default;
+    ~RecordingGLBackend() override = default;
+
+    void genBuffers(GLsizei n, GLuint *buffers) override;
+    void deleteBuffers(GLsizei n, const GLuint *buffers) override;
+    void bindBuffer(GLenum target, GLuint buffer) override;
+    void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) override;
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) override;
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override;
+
+    void genVertexArrays(GLsizei n, GLuint *arrays) override;
+    void deleteVertexArrays(GLsizei n, const GLuint *arrays) override;
+    void bindVertexArray(GLuint array) override;
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                             GLsizei stride, const void *pointer) override;
+    void enableVertexAttribArray(GLuint index) override;
+    void disableVertexAttribArray(GLuint index) override;
+    void vertexAttribDivisor(GLuint index, GLuint divisor) override;
+
+    void genTextures(GLsizei n, GLuint *textures) override;
+    void deleteTextures(GLsizei n, const GLuint *textures) override;
+    void bindTexture(GLenum target, GLuint texture) override;
+    void activeTexture(GLenum texture) override;
+    void texParameteri(GLenum target, GLenum pname, GLint param) override;
+    void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                    GLint border, GLenum format, GLenum type, const void *pixels) override;
+
+    GLuint createShader(GLenum type) override;
+    void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) override;
+    void compileShader(GLuint shader) override;
+    void getShaderiv(GLuint shader, GLenum pname, GLint *params) override;
+    void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) override;
+    void deleteShader(GLuint shader) override;
+    GLuint createProgram() override;
+    void attachShader(GLuint program, GLuint shader) override;
+    void linkProgram(GLuint program) override;
+    void getProgramiv(GLuint program, GLenum pname, GLint *params) override;
+    void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) override;
+    void deleteProgram(GLuint program) override;
+    void useProgram(GLuint program) override;
+    GLint getUniformLocation(GLuint program, const GLchar *name) override;
+    void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                          GLenum *type, GLchar *name) override;
+    void getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length,
+                                   GLchar *uniformBlockName) override;
+    void uniform1i(GLint location, GLint v0) override;
+    void uniform1f(GLint location, GLfloat v0) override;
+    void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) override;
+    void uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) override;
+    GLuint getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName) override;
+    void uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) override;
+
+    void drawArrays(GLenum mode, GLint first, GLsizei count) override;
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) override;
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) override;
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                               GLsizei instanceCount) override;
+    void multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                           GLsizei drawcount) override;
+    void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override;
+    void clear(GLbitfield mask) override;
+
+    void enable(GLenum cap) override;
+    void disable(GLenum cap) override;
+    void blendFunc(GLenum sfactor, GLenum dfactor) override;
+    void depthFunc(GLenum func) override;
+    void depthMask(GLboolean flag) override;
+    void cullFace(GLenum mode) override;
+
+    void getIntegerv(GLenum pname, GLint *data) override;
+
+    /**
+     * @brief 启用/禁用完整调用序列录制（计数始终启用）
+     * @param enabled 是否录制
+     */
+    void setLogEnabled(bool enabled) { m_logEnabled = enabled; }
+
+    /**
+     * @brief 获取指定类型的调用次数
+     * @param type 调用类型
+     * @return 调用次数
+     */
+    std::uint64_t callCount(GLCallType type) const { return m_counts[static_cast<size_t>(type)]; }
+
+    /**
+     * @brief 获取所有类型的调用总数
+     * @return 调用总数
+     */
+    std::uint64_t totalCalls() const;
+
+    /**
+     * @brief 获取录制的调用序列
+     * @return 调用序列
+     */
+    const std::vector<GLCall> &calls() const { return m_calls; }
+
+    /**
+     * @brief 清空计数和调用序列
+     */
+    void reset();
+
+    /**
+     * @brief 生成调用统计文本（只包含非零项）
+     * @return 统计文本
+     */
+    std::string summary() const;
+
+private:
+    void record(GLCallType type, std::int64_t arg0 = 0, std::int64_t arg1 = 0);
+
+private:
+    std::array<std::uint64_t, static_cast<size_t>(GLCallType::Count)> m_counts{};
+    std::vector<GLCall> m_calls;
+    bool m_logEnabled = false;
+};
+
+#endif // GLBACKEND_H
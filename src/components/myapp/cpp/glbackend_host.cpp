@@ -0,0 +1,146 @@
+// 原生主机构建的 GL 入口实现
+// 不链接任何真实的 GL 驱动，所有调用都转发到 GLBackend::current()
+
+// 这里定义的就是 gl* 函数本身，不能被 GLStats 重定向
+#define GLSTATS_NO_REDIRECT
+#include "glbackend.h"
+
+extern "C"
+{
+    void glGenBuffers(GLsizei n, GLuint *buffers) { GLBackend::current().genBuffers(n, buffers); }
+    void glDeleteBuffers(GLsizei n, const GLuint *buffers) { GLBackend::current().deleteBuffers(n, buffers); }
+    void glBindBuffer(GLenum target, GLuint buffer) { GLBackend::current().bindBuffer(target, buffer); }
+    void glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+    {
+        GLBackend::current().bufferData(target, size, data, usage);
+    }
+    void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+    {
+        GLBackend::current().bufferSubData(target, offset, size, data);
+    }
+    void glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+    {
+        GLBackend::current().bindBufferRange(target, index, buffer, offset, size);
+    }
+
+    void glGenVertexArrays(GLsizei n, GLuint *arrays) { GLBackend::current().genVertexArrays(n, arrays); }
+    void glDeleteVertexArrays(GLsizei n, const GLuint *arrays) { GLBackend::current().deleteVertexArrays(n, arrays); }
+    void glBindVertexArray(GLuint array) { GLBackend::current().bindVertexArray(array); }
+    void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                               GLsizei stride, const void *pointer)
+    {
+        GLBackend::current().vertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+    void glEnableVertexAttribArray(GLuint index) { GLBackend::current().enableVertexAttribArray(index); }
+    void glDisableVertexAttribArray(GLuint index) { GLBackend::current().disableVertexAttribArray(index); }
+    void glVertexAttribDivisor(GLuint index, GLuint divisor) { GLBackend::current().vertexAttribDivisor(index, divisor); }
+
+    void glGenTextures(GLsizei n, GLuint *textures) { GLBackend::current().genTextures(n, textures); }
+    void glDeleteTextures(GLsizei n, const GLuint *textures) { GLBackend::current().deleteTextures(n, textures); }
+    void glBindTexture(GLenum target, GLuint texture) { GLBackend::current().bindTexture(target, texture); }
+    void glActiveTexture(GLenum texture) { GLBackend::current().activeTexture(texture); }
+    void glTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        GLBackend::current().texParameteri(target, pname, param);
+    }
+    void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                      GLint border, GLenum format, GLenum type, const void *pixels)
+    {
+        GLBackend::current().texImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    }
+
+    GLuint glCreateShader(GLenum type) { return GLBackend::current().createShader(type); }
+    void glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+    {
+        GLBackend::current().shaderSource(shader, count, string, length);
+    }
+    void glCompileShader(GLuint shader) { GLBackend::current().compileShader(shader); }
+    void glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+    {
+        GLBackend::current().getShaderiv(shader, pname, params);
+    }
+    void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+    {
+        GLBackend::current().getShaderInfoLog(shader, bufSize, length, infoLog);
+    }
+    void glDeleteShader(GLuint shader) { GLBackend::current().deleteShader(shader); }
+    GLuint glCreateProgram() { return GLBackend::current().createProgram(); }
+    void glAttachShader(GLuint program, GLuint shader) { GLBackend::current().attachShader(program, shader); }
+    void glLinkProgram(GLuint program) { GLBackend::current().linkProgram(program); }
+    void glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+    {
+        GLBackend::current().getProgramiv(program, pname, params);
+    }
+    void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+    {
+        GLBackend::current().getProgramInfoLog(program, bufSize, length, infoLog);
+    }
+    void glDeleteProgram(GLuint program) { GLBackend::current().deleteProgram(program); }
+    void glUseProgram(GLuint program) { GLBackend::current().useProgram(program); }
+    GLint glGetUniformLocation(GLuint program, const GLchar *name)
+    {
+        return GLBackend::current().getUniformLocation(program, name);
+    }
+    void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                            GLenum *type, GLchar *name)
+    {
+        GLBackend::current().getActiveUniform(program, index, bufSize, length, size, type, name);
+    }
+    void glGetActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length,
+                                     GLchar *uniformBlockName)
+    {
+        GLBackend::current().getActiveUniformBlockName(program, uniformBlockIndex, bufSize, length, uniformBlockName);
+    }
+    void glUniform1i(GLint location, GLint v0) { GLBackend::current().uniform1i(location, v0); }
+    void glUniform1f(GLint location, GLfloat v0) { GLBackend::current().uniform1f(location, v0); }
+    void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+    {
+        GLBackend::current().uniform3f(location, v0, v1, v2);
+    }
+    void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+    {
+        GLBackend::current().uniform4f(location, v0, v1, v2, v3);
+    }
+    GLuint glGetUniformBlockIndex(GLuint program, const GLchar *uniformBlockName)
+    {
+        return GLBackend::current().getUniformBlockIndex(program, uniformBlockName);
+    }
+    void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+    {
+        GLBackend::current().uniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding);
+    }
+
+    void glDrawArrays(GLenum mode, GLint first, GLsizei count) { GLBackend::current().drawArrays(mode, first, count); }
+    void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+    {
+        GLBackend::current().drawElements(mode, count, type, indices);
+    }
+    void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+    {
+        GLBackend::current().drawArraysInstanced(mode, first, count, instanceCount);
+    }
+    void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
+    {
+        GLBackend::current().drawElementsInstanced(mode, count, type, indices, instanceCount);
+    }
+    void glMultiDrawElementsWEBGL(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                                  GLsizei drawcount)
+    {
+        GLBackend::current().multiDrawElements(mode, counts, type, offsets, drawcount);
+    }
+    void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+    {
+        GLBackend::current().clearColor(red, green, blue, alpha);
+    }
+    void glClear(GLbitfield mask) { GLBackend::current().clear(mask); }
+
+    void glEnable(GLenum cap) { GLBackend::current().enable(cap); }
+    void glDisable(GLenum cap) { GLBackend::current().disable(cap); }
+    void glBlendFunc(GLenum sfactor, GLenum dfactor) { GLBackend::current().blendFunc(sfactor, dfactor); }
+    void glDepthFunc(GLenum func) { GLBackend::current().depthFunc(func); }
+    void glDepthMask(GLboolean flag) { GLBackend::current().depthMask(flag); }
+    void glCullFace(GLenum mode) { GLBackend::current().cullFace(mode); }
+
+    void glGetIntegerv(GLenum pname, GLint *data) { GLBackend::current().getIntegerv(pname, data); }
+
+} // extern "C"
@@ -0,0 +1,352 @@
+#include "glstate.h"
+#include "gltargets.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/html5_webgl.h>
+#endif
+
+namespace
+{
+    // 未知状态，保证下一次设置一定调用 GL
+    constexpr GLuint kUnknown = ~0u;
+
+    // 功能开关的三种状态
+    enum class Capability : signed char
+    {
+        Unknown = -1,
+        Disabled = 0,
+        Enabled = 1,
+    };
+
+    /**
+     * @brief uniform 缓冲绑定点上绑定的缓冲范围
+     */
+    struct UniformRange
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    /**
+     * @brief 缓存的上下文状态
+     */
+    struct ContextState
+    {
+        GLuint program;
+        GLuint vertexArray;
+        GLuint buffers[GLTargets::kBufferTargetCount];
+        GLuint textures[GLState::kMaxTextureUnits][GLTargets::kTextureTargetCount];
+        GLuint activeTextureUnit;
+        UniformRange uniformRanges[GLState::kMaxUniformBufferBindings];
+
+        Capability blend;
+        Capability depthTest;
+        Capability cullFace;
+        GLenum blendSource;
+        GLenum blendDestination;
+        GLenum depthFunc;
+        Capability depthMask;
+        GLenum cullFaceMode;
+    };
+
+    ContextState g_state;
+
+    // uniform 缓冲偏移对齐，0 表示未查询
+    GLint g_uniformBufferOffsetAlignment = 0;
+
+    // 扩展检测结果：-1 未检测，0 不可用，1 可用
+    int g_multiDrawAvailable = -1;
+    bool g_multiDrawEnabled = true;
+    int g_parallelShaderCompileAvailable = -1;
+
+    void resetState()
+    {
+        g_state.program = kUnknown;
+        g_state.vertexArray = kUnknown;
+        for (auto &buffer : g_state.buffers)
+        {
+            buffer = kUnknown;
+        }
+        for (auto &unit : g_state.textures)
+        {
+            for (auto &texture : unit)
+            {
+                texture = kUnknown;
+            }
+        }
+        g_state.activeTextureUnit = kUnknown;
+        for (auto &range : g_state.uniformRanges)
+        {
+            range.buffer = kUnknown;
+        }
+
+        g_state.blend = Capability::Unknown;
+        g_state.depthTest = Capability::Unknown;
+        g_state.cullFace = Capability::Unknown;
+        g_state.blendSource = kUnknown;
+        g_state.blendDestination = kUnknown;
+        g_state.depthFunc = kUnknown;
+        g_state.depthMask = Capability::Unknown;
+        g_state.cullFaceMode = kUnknown;
+    }
+
+    // 静态初始化时清空状态
+    const bool g_stateInitialized = (resetState(), true);
+
+    Capability *capabilityState(GLenum capability)
+    {
+        switch (capability)
+        {
+        case GL_BLEND:
+            return &g_state.blend;
+        case GL_DEPTH_TEST:
+            return &g_state.depthTest;
+        case GL_CULL_FACE:
+            return &g_state.cullFace;
+        default:
+            return nullptr;
+        }
+    }
+}
+
+void GLState::useProgram(GLuint program)
+{
+    if (g_state.program == program)
+        return;
+
+    g_state.program = program;
+    glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vertexArray)
+{
+    if (g_state.vertexArray == vertexArray)
+        return;
+
+    g_state.vertexArray = vertexArray;
+    // 索引缓冲绑定属于 VAO 状态
+    g_state.buffers[GLTargets::bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+    glBindVertexArray(vertexArray);
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+    int index = GLTargets::bufferTargetIndex(target);
+    if (index >= 0)
+    {
+        if (g_state.buffers[index] == buffer)
+            return;
+        g_state.buffers[index] = buffer;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GLState::bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    if (index < kMaxUniformBufferBindings)
+    {
+        UniformRange &range = g_state.uniformRanges[index];
+        if (range.buffer == buffer && range.offset == offset && range.size == size)
+            return;
+        range.buffer = buffer;
+        range.offset = offset;
+        range.size = size;
+    }
+    g_state.buffers[GLTargets::bufferTargetIndex(GL_UNIFORM_BUFFER)] = buffer;
+    glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+}
+
+GLint GLState::getUniformBufferOffsetAlignment()
+{
+    if (g_uniformBufferOffsetAlignment == 0)
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        // WebGL2 规范保证不超过 256，查询失败时按最坏情况处理
+        g_uniformBufferOffsetAlignment = alignment > 0 ? alignment : 256;
+    }
+    return g_uniformBufferOffsetAlignment;
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+    if (g_state.activeTextureUnit == unit)
+        return;
+
+    g_state.activeTextureUnit = unit;
+    glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+    GLuint unit = g_state.activeTextureUnit;
+    int index = GLTargets::textureTargetIndex(target);
+    if (unit < kMaxTextureUnits && index >= 0)
+    {
+        if (g_state.textures[unit][index] == texture)
+            return;
+        g_state.textures[unit][index] = texture;
+    }
+    glBindTexture(target, texture);
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    int index = GLTargets::textureTargetIndex(target);
+    if (unit < kMaxTextureUnits && index >= 0 && g_state.textures[unit][index] == texture)
+        return;
+
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void GLState::setCapability(GLenum capability, bool enabled)
+{
+    Capability *state = capabilityState(capability);
+    Capability value = enabled ? Capability::Enabled : Capability::Disabled;
+    if (state)
+    {
+        if (*state == value)
+            return;
+        *state = value;
+    }
+
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void GLState::blendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+    if (g_state.blendSource == sourceFactor && g_state.blendDestination == destinationFactor)
+        return;
+
+    g_state.blendSource = sourceFactor;
+    g_state.blendDestination = destinationFactor;
+    glBlendFunc(sourceFactor, destinationFactor);
+}
+
+void GLState::depthFunc(GLenum func)
+{
+    if (g_state.depthFunc == func)
+        return;
+
+    g_state.depthFunc = func;
+    glDepthFunc(func);
+}
+
+void GLState::depthMask(bool enabled)
+{
+    Capability value = enabled ? Capability::Enabled : Capability::Disabled;
+    if (g_state.depthMask == value)
+        return;
+
+    g_state.depthMask = value;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLState::cullFace(GLenum mode)
+{
+    if (g_state.cullFaceMode == mode)
+        return;
+
+    g_state.cullFaceMode = mode;
+    glCullFace(mode);
+}
+
+void GLState::programDeleted(GLuint id)
+{
+    // 正在使用的程序删除后仍然有效，但名称可能被复用
+    if (g_state.program == id)
+    {
+        g_state.program = kUnknown;
+    }
+}
+
+void GLState::vertexArrayDeleted(GLuint id)
+{
+    if (g_state.vertexArray == id)
+    {
+        g_state.vertexArray = 0;
+        g_state.buffers[GLTargets::bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+    }
+}
+
+void GLState::bufferDeleted(GLuint id)
+{
+    for (auto &buffer : g_state.buffers)
+    {
+        if (buffer == id)
+        {
+            buffer = 0;
+        }
+    }
+    for (auto &range : g_state.uniformRanges)
+    {
+        if (range.buffer == id)
+        {
+            range.buffer = kUnknown;
+        }
+    }
+}
+
+void GLState::textureDeleted(GLuint id)
+{
+    for (auto &unit : g_state.textures)
+    {
+        for (auto &texture : unit)
+        {
+            if (texture == id)
+            {
+                texture = 0;
+            }
+        }
+    }
+}
+
+void GLState::invalidate()
+{
+    resetState();
+}
+
+bool GLState::isMultiDrawSupported()
+{
+    if (g_multiDrawAvailable < 0)
+    {
+#ifdef __EMSCRIPTEN__
+        EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context = emscripten_webgl_get_current_context();
+        g_multiDrawAvailable = context > 0 && emscripten_webgl_enable_WEBGL_multi_draw(context) ? 1 : 0;
+#else
+        // 原生主机的入口由 GLBackend 实现，总是可用
+        g_multiDrawAvailable = 1;
+#endif
+    }
+    return g_multiDrawEnabled && g_multiDrawAvailable == 1;
+}
+
+void GLState::setMultiDrawEnabled(bool enabled)
+{
+    g_multiDrawEnabled = enabled;
+}
+
+bool GLState::isParallelShaderCompileSupported()
+{
+    if (g_parallelShaderCompileAvailable < 0)
+    {
+#ifdef __EMSCRIPTEN__
+        EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context = emscripten_webgl_get_current_context();
+        g_parallelShaderCompileAvailable =
+            context > 0 && emscripten_webgl_enable_extension(context, "KHR_parallel_shader_compile") ? 1 : 0;
+#else
+        // 原生主机由 GLBackend 回答 GL_COMPLETION_STATUS_KHR，总是可用
+        g_parallelShaderCompileAvailable = 1;
+#endif
+    }
+    return g_parallelShaderCompileAvailable == 1;
+}
@@ -0,0 +1,139 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include "glapi.h"
+#include "gltargets.h"
+
+/**
+ * @brief GL 上下文状态缓存
+ *
+ * 记录当前的程序、VAO、缓冲绑定、各纹理单元的纹理绑定、活动纹理单元以及混合/深度/剔除状态，
+ * 与缓存相同的设置直接返回，不再调用 GL（WebGL 中每次调用都要跨越 wasm→JS 边界）。
+ * Shader、VertexArrayObject、BufferObject、Texture 和 Material 都通过这里修改状态；
+ * 其他代码直接调用 GL 修改了这些状态后必须调用 invalidate()。只在持有 GL 上下文的线程上使用
+ */
+class GLState
+{
+public:
+    // 跟踪的纹理单元数量，超出的单元不做缓存（与 GLStats 共用 GLTargets 的定义）
+    static constexpr GLuint kMaxTextureUnits = GLTargets::kMaxTextureUnits;
+
+    // 跟踪的 uniform 缓冲绑定点数量，超出的绑定点不做缓存
+    static constexpr GLuint kMaxUniformBufferBindings = 16;
+
+    /**
+     * @brief 使用着色器程序
+     * @param program 程序 ID
+     */
+    static void useProgram(GLuint program);
+
+    /**
+     * @brief 绑定顶点数组对象（会改变索引缓冲绑定）
+     * @param vertexArray VAO ID，0 表示解绑
+     */
+    static void bindVertexArray(GLuint vertexArray);
+
+    /**
+     * @brief 绑定缓冲对象
+     * @param target 绑定目标
+     * @param buffer 缓冲 ID
+     */
+    static void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * @brief 把缓冲的一段绑定到 uniform 缓冲绑定点（同时改变通用 GL_UNIFORM_BUFFER 绑定）
+     * @param index 绑定点
+     * @param buffer 缓冲 ID
+     * @param offset 字节偏移，必须是 getUniformBufferOffsetAlignment() 的倍数
+     * @param size 字节数
+     */
+    static void bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    /**
+     * @brief 获取 uniform 缓冲偏移的对齐要求（第一次调用时查询 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT）
+     * @return 对齐字节数
+     */
+    static GLint getUniformBufferOffsetAlignment();
+
+    /**
+     * @brief 设置活动纹理单元
+     * @param unit 纹理单元序号（不是 GL_TEXTURE0 + unit）
+     */
+    static void activeTexture(GLuint unit);
+
+    /**
+     * @brief 绑定纹理到活动纹理单元
+     * @param target 纹理目标
+     * @param texture 纹理 ID
+     */
+    static void bindTexture(GLenum target, GLuint texture);
+
+    /**
+     * @brief 绑定纹理到指定纹理单元，已绑定时连活动单元也不切换
+     * @param unit 纹理单元序号
+     * @param target 纹理目标
+     * @param texture 纹理 ID
+     */
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief 启用/禁用功能（缓存 GL_BLEND、GL_DEPTH_TEST、GL_CULL_FACE，其他直接转发）
+     * @param capability 功能
+     * @param enabled 是否启用
+     */
+    static void setCapability(GLenum capability, bool enabled);
+
+    /**
+     * @brief 设置混合函数
+     */
+    static void blendFunc(GLenum sourceFactor, GLenum destinationFactor);
+
+    /**
+     * @brief 设置深度比较函数
+     */
+    static void depthFunc(GLenum func);
+
+    /**
+     * @brief 启用/禁用深度写入
+     */
+    static void depthMask(bool enabled);
+
+    /**
+     * @brief 设置剔除面
+     */
+    static void cullFace(GLenum mode);
+
+    /**
+     * @brief 对象删除通知：删除正在使用或已绑定的对象会改变绑定状态
+     * @param id 对象 ID
+     */
+    static void programDeleted(GLuint id);
+    static void vertexArrayDeleted(GLuint id);
+    static void bufferDeleted(GLuint id);
+    static void textureDeleted(GLuint id);
+
+    /**
+     * @brief 清空缓存，之后的每个设置都会调用一次 GL
+     */
+    static void invalidate();
+
+    /**
+     * @brief 检查能否使用 WEBGL_multi_draw（第一次调用时在当前上下文中启用扩展）
+     * @return 扩展可用且没有被禁止
+     */
+    static bool isMultiDrawSupported();
+
+    /**
+     * @brief 允许/禁止使用 WEBGL_multi_draw，禁止时多重绘制回退为逐个绘制（便于对比）
+     * @param enabled 是否允许
+     */
+    static void setMultiDrawEnabled(bool enabled);
+
+    /**
+     * @brief 检查能否使用 KHR_parallel_shader_compile（第一次调用时在当前上下文中启用扩展）
+     * @return 扩展是否可用
+     */
+    static bool isParallelShaderCompileSupported();
+};
+
+#endif // GLSTATE_H
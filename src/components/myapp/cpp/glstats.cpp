@@ -0,0 +1,760 @@
+#define GLSTATS_NO_REDIRECT
+#include "glapi.h"
+#include "gltargets.h"
+
+#include <cstring>
+#include <sstream>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+GLFrameStats GLStats::s_currentFrame = {};
+GLFrameStats GLStats::s_lastFrame = {};
+
+namespace
+{
+    const char *const kCallTypeNames[] = {
+        "glGenBuffers",
+        "glDeleteBuffers",
+        "glBindBuffer",
+        "glBufferData",
+        "glBufferSubData",
+        "glBindBufferRange",
+        "glGenVertexArrays",
+        "glDeleteVertexArrays",
+        "glBindVertexArray",
+        "glVertexAttribPointer",
+        "glEnableVertexAttribArray",
+        "glDisableVertexAttribArray",
+        "glVertexAttribDivisor",
+        "glGenTextures",
+        "glDeleteTextures",
+        "glBindTexture",
+        "glActiveTexture",
+        "glTexParameteri",
+        "glTexImage2D",
+        "glCreateShader",
+        "glShaderSource",
+        "glCompileShader",
+        "glGetShaderiv",
+        "glGetShaderInfoLog",
+        "glDeleteShader",
+        "glCreateProgram",
+        "glAttachShader",
+        "glLinkProgram",
+        "glGetProgramiv",
+        "glGetProgramInfoLog",
+        "glDeleteProgram",
+        "glUseProgram",
+        "glGetUniformLocation",
+        "glGetActiveUniform",
+        "glGetActiveUniformBlockName",
+        "glUniform1i",
+        "glUniform1f",
+        "glUniform3f",
+        "glUniform4f",
+        "glGetUniformBlockIndex",
+        "glUniformBlockBinding",
+        "glDrawArrays",
+        "glDrawElements",
+        "glDrawArraysInstanced",
+        "glDrawElementsInstanced",
+        "glMultiDrawElementsWEBGL",
+        "glClearColor",
+        "glClear",
+        "glEnable",
+        "glDisable",
+        "glBlendFunc",
+        "glDepthFunc",
+        "glDepthMask",
+        "glCullFace",
+        "glGetIntegerv",
+    };
+    static_assert(sizeof(kCallTypeNames) / sizeof(kCallTypeNames[0]) == static_cast<size_t>(GLCallType::Count),
+                  "kCallTypeNames must match GLCallType");
+
+    // 未知绑定状态，保证下一次绑定不会被误判为冗余
+    constexpr GLuint kUnknownBinding = ~0u;
+
+    /**
+     * @brief 跟踪的绑定状态，用于识别冗余绑定
+     */
+    struct BindingState
+    {
+        GLuint program;
+        GLuint vertexArray;
+        GLuint buffers[GLTargets::kBufferTargetCount];
+        GLuint textures[GLTargets::kMaxTextureUnits][GLTargets::kTextureTargetCount];
+        GLenum activeTexture;
+    };
+
+    BindingState g_state;
+
+    void resetState()
+    {
+        g_state.program = kUnknownBinding;
+        g_state.vertexArray = kUnknownBinding;
+        for (auto &buffer : g_state.buffers)
+        {
+            buffer = kUnknownBinding;
+        }
+        for (auto &unit : g_state.textures)
+        {
+            for (auto &texture : unit)
+            {
+                texture = kUnknownBinding;
+            }
+        }
+        g_state.activeTexture = kUnknownBinding;
+    }
+
+    // 静态初始化时清空状态
+    const bool g_stateInitialized = (resetState(), true);
+
+    int activeTextureUnit()
+    {
+        if (g_state.activeTexture == kUnknownBinding)
+        {
+            return -1;
+        }
+        int unit = static_cast<int>(g_state.activeTexture - GL_TEXTURE0);
+        return unit >= 0 && unit < GLTargets::kMaxTextureUnits ? unit : -1;
+    }
+
+    std::uint64_t bytesPerPixel(GLenum format, GLenum type)
+    {
+        switch (type)
+        {
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+            return 2;
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_10F_11F_11F_REV:
+        case GL_UNSIGNED_INT_5_9_9_9_REV:
+        case GL_UNSIGNED_INT_24_8:
+            return 4;
+        default:
+            break;
+        }
+
+        std::uint64_t componentSize = 1;
+        switch (type)
+        {
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            componentSize = 2;
+            break;
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:
+            componentSize = 4;
+            break;
+        default:
+            break;
+        }
+
+        std::uint64_t components = 4;
+        switch (format)
+        {
+        case GL_RED:
+        case GL_RED_INTEGER:
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+        case GL_DEPTH_COMPONENT:
+            components = 1;
+            break;
+        case GL_RG:
+        case GL_RG_INTEGER:
+        case GL_LUMINANCE_ALPHA:
+            components = 2;
+            break;
+        case GL_RGB:
+        case GL_RGB_INTEGER:
+            components = 3;
+            break;
+        default:
+            break;
+        }
+        return components * componentSize;
+    }
+
+    std::uint64_t trianglesForDraw(GLenum mode, GLsizei count)
+    {
+        switch (mode)
+        {
+        case GL_TRIANGLES:
+            return count / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+            return count > 2 ? count - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    inline void countCall(GLFrameStats &stats, GLCallType type)
+    {
+        ++stats.calls[static_cast<size_t>(type)];
+    }
+
+    inline void countRedundant(GLFrameStats &stats, GLCallType type)
+    {
+        ++stats.redundant[static_cast<size_t>(type)];
+    }
+}
+
+const char *glCallTypeName(GLCallType type)
+{
+    size_t index = static_cast<size_t>(type);
+    if (index >= static_cast<size_t>(GLCallType::Count))
+    {
+        return "unknown";
+    }
+    return kCallTypeNames[index];
+}
+
+std::uint32_t GLFrameStats::totalCalls() const
+{
+    std::uint32_t total = 0;
+    for (std::uint32_t count : calls)
+    {
+        total += count;
+    }
+    return total;
+}
+
+std::uint32_t GLFrameStats::totalRedundant() const
+{
+    std::uint32_t total = 0;
+    for (std::uint32_t count : redundant)
+    {
+        total += count;
+    }
+    return total;
+}
+
+std::string GLFrameStats::toJson() const
+{
+    std::ostringstream out;
+    out << "{\"totalCalls\":" << totalCalls()
+        << ",\"redundantBinds\":" << totalRedundant()
+        << ",\"drawCalls\":" << drawCalls
+        << ",\"triangles\":" << triangles
+        << ",\"bytesUploaded\":" << bytesUploaded
+        << ",\"calls\":{";
+
+    bool first = true;
+    for (size_t i = 0; i < static_cast<size_t>(GLCallType::Count); ++i)
+    {
+        if (calls[i] == 0)
+        {
+            continue;
+        }
+        out << (first ? "" : ",") << '"' << kCallTypeNames[i] << "\":" << calls[i];
+        first = false;
+    }
+
+    out << "},\"redundant\":{";
+    first = true;
+    for (size_t i = 0; i < static_cast<size_t>(GLCallType::Count); ++i)
+    {
+        if (redundant[i] == 0)
+        {
+            continue;
+        }
+        out << (first ? "" : ",") << '"' << kCallTypeNames[i] << "\":" << redundant[i];
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
+
+void GLStats::endFrame()
+{
+    s_lastFrame = s_currentFrame;
+    std::memset(&s_currentFrame, 0, sizeof(s_currentFrame));
+}
+
+void GLStats::invalidateState()
+{
+    resetState();
+}
+
+// 缓冲对象
+void GLStats::genBuffers(GLsizei n, GLuint *buffers)
+{
+    countCall(s_currentFrame, GLCallType::GenBuffers);
+    ::glGenBuffers(n, buffers);
+}
+
+void GLStats::deleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    countCall(s_currentFrame, GLCallType::DeleteBuffers);
+    // 删除已绑定的缓冲会解除绑定
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (auto &bound : g_state.buffers)
+        {
+            if (bound == buffers[i])
+            {
+                bound = 0;
+            }
+        }
+    }
+    ::glDeleteBuffers(n, buffers);
+}
+
+void GLStats::bindBuffer(GLenum target, GLuint buffer)
+{
+    countCall(s_currentFrame, GLCallType::BindBuffer);
+    int index = GLTargets::bufferTargetIndex(target);
+    if (index >= 0)
+    {
+        if (g_state.buffers[index] == buffer)
+        {
+            countRedundant(s_currentFrame, GLCallType::BindBuffer);
+        }
+        g_state.buffers[index] = buffer;
+    }
+    ::glBindBuffer(target, buffer);
+}
+
+void GLStats::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    countCall(s_currentFrame, GLCallType::BufferData);
+    if (data && size > 0)
+    {
+        s_currentFrame.bytesUploaded += static_cast<std::uint64_t>(size);
+    }
+    ::glBufferData(target, size, data, usage);
+}
+
+void GLStats::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    countCall(s_currentFrame, GLCallType::BufferSubData);
+    if (data && size > 0)
+    {
+        s_currentFrame.bytesUploaded += static_cast<std::uint64_t>(size);
+    }
+    ::glBufferSubData(target, offset, size, data);
+}
+
+void GLStats::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    // 同时改变通用绑定点
+    countCall(s_currentFrame, GLCallType::BindBufferRange);
+    int targetIndex = GLTargets::bufferTargetIndex(target);
+    if (targetIndex >= 0)
+    {
+        g_state.buffers[targetIndex] = buffer;
+    }
+    ::glBindBufferRange(target, index, buffer, offset, size);
+}
+
+// 顶点数组对象
+void GLStats::genVertexArrays(GLsizei n, GLuint *arrays)
+{
+    countCall(s_currentFrame, GLCallType::GenVertexArrays);
+    ::glGenVertexArrays(n, arrays);
+}
+
+void GLStats::deleteVertexArrays(GLsizei n, const GLuint *arrays)
+{
+    countCall(s_currentFrame, GLCallType::DeleteVertexArrays);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (g_state.vertexArray == arrays[i])
+        {
+            g_state.vertexArray = 0;
+            g_state.buffers[GLTargets::bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = kUnknownBinding;
+        }
+    }
+    ::glDeleteVertexArrays(n, arrays);
+}
+
+void GLStats::bindVertexArray(GLuint array)
+{
+    countCall(s_currentFrame, GLCallType::BindVertexArray);
+    if (g_state.vertexArray == array)
+    {
+        countRedundant(s_currentFrame, GLCallType::BindVertexArray);
+    }
+    else
+    {
+        // 索引缓冲绑定属于 VAO 状态
+        g_state.buffers[GLTargets::bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = kUnknownBinding;
+    }
+    g_state.vertexArray = array;
+    ::glBindVertexArray(array);
+}
+
+void GLStats::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                  GLsizei stride, const void *pointer)
+{
+    countCall(s_currentFrame, GLCallType::VertexAttribPointer);
+    ::glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+void GLStats::enableVertexAttribArray(GLuint index)
+{
+    countCall(s_currentFrame, GLCallType::EnableVertexAttribArray);
+    ::glEnableVertexAttribArray(index);
+}
+
+void GLStats::disableVertexAttribArray(GLuint index)
+{
+    countCall(s_currentFrame, GLCallType::DisableVertexAttribArray);
+    ::glDisableVertexAttribArray(index);
+}
+
+void GLStats::vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    countCall(s_currentFrame, GLCallType::VertexAttribDivisor);
+    ::glVertexAttribDivisor(index, divisor);
+}
+
+// 纹理
+void GLStats::genTextures(GLsizei n, GLuint *textures)
+{
+    countCall(s_currentFrame, GLCallType::GenTextures);
+    ::glGenTextures(n, textures);
+}
+
+void GLStats::deleteTextures(GLsizei n, const GLuint *textures)
+{
+    countCall(s_currentFrame, GLCallType::DeleteTextures);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (auto &unit : g_state.textures)
+        {
+            for (auto &bound : unit)
+            {
+                if (bound == textures[i])
+                {
+                    bound = 0;
+                }
+            }
+        }
+    }
+    ::glDeleteTextures(n, textures);
+}
+
+void GLStats::bindTexture(GLenum target, GLuint texture)
+{
+    countCall(s_currentFrame, GLCallType::BindTexture);
+    int unit = activeTextureUnit();
+    int index = GLTargets::textureTargetIndex(target);
+    if (unit >= 0 && index >= 0)
+    {
+        if (g_state.textures[unit][index] == texture)
+        {
+            countRedundant(s_currentFrame, GLCallType::BindTexture);
+        }
+        g_state.textures[unit][index] = texture;
+    }
+    ::glBindTexture(target, texture);
+}
+
+void GLStats::activeTexture(GLenum texture)
+{
+    countCall(s_currentFrame, GLCallType::ActiveTexture);
+    if (g_state.activeTexture == texture)
+    {
+        countRedundant(s_currentFrame, GLCallType::ActiveTexture);
+    }
+    g_state.activeTexture = texture;
+    ::glActiveTexture(texture);
+}
+
+void GLStats::texParameteri(GLenum target, GLenum pname, GLint param)
+{
+    countCall(s_currentFrame, GLCallType::TexParameteri);
+    ::glTexParameteri(target, pname, param);
+}
+
+void GLStats::texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                         GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    countCall(s_currentFrame, GLCallType::TexImage2D);
+    if (pixels && width > 0 && height > 0)
+    {
+        s_currentFrame.bytesUploaded += static_cast<std::uint64_t>(width) * height * bytesPerPixel(format, type);
+    }
+    ::glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+// 着色器和程序
+GLuint GLStats::createShader(GLenum type)
+{
+    countCall(s_currentFrame, GLCallType::CreateShader);
+    return ::glCreateShader(type);
+}
+
+void GLStats::shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    countCall(s_currentFrame, GLCallType::ShaderSource);
+    ::glShaderSource(shader, count, string, length);
+}
+
+void GLStats::compileShader(GLuint shader)
+{
+    countCall(s_currentFrame, GLCallType::CompileShader);
+    ::glCompileShader(shader);
+}
+
+void GLStats::getShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    countCall(s_currentFrame, GLCallType::GetShaderiv);
+    ::glGetShaderiv(shader, pname, params);
+}
+
+void GLStats::getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    countCall(s_currentFrame, GLCallType::GetShaderInfoLog);
+    ::glGetShaderInfoLog(shader, bufSize, length, infoLog);
+}
+
+void GLStats::deleteShader(GLuint shader)
+{
+    countCall(s_currentFrame, GLCallType::DeleteShader);
+    ::glDeleteShader(shader);
+}
+
+GLuint GLStats::createProgram()
+{
+    countCall(s_currentFrame, GLCallType::CreateProgram);
+    return ::glCreateProgram();
+}
+
+void GLStats::attachShader(GLuint program, GLuint shader)
+{
+    countCall(s_currentFrame, GLCallType::AttachShader);
+    ::glAttachShader(program, shader);
+}
+
+void GLStats::linkProgram(GLuint program)
+{
+    countCall(s_currentFrame, GLCallType::LinkProgram);
+    ::glLinkProgram(program);
+}
+
+void GLStats::getProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    countCall(s_currentFrame, GLCallType::GetProgramiv);
+    ::glGetProgramiv(program, pname, params);
+}
+
+void GLStats::getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    countCall(s_currentFrame, GLCallType::GetProgramInfoLog);
+    ::glGetProgramInfoLog(program, bufSize, length, infoLog);
+}
+
+void GLStats::deleteProgram(GLuint program)
+{
+    countCall(s_currentFrame, GLCallType::DeleteProgram);
+    // 正在使用的程序删除后仍保持绑定，但名称可能被复用
+    if (g_state.program == program)
+    {
+        g_state.program = kUnknownBinding;
+    }
+    ::glDeleteProgram(program);
+}
+
+void GLStats::useProgram(GLuint program)
+{
+    countCall(s_currentFrame, GLCallType::UseProgram);
+    if (g_state.program == program)
+    {
+        countRedundant(s_currentFrame, GLCallType::UseProgram);
+    }
+    g_state.program = program;
+    ::glUseProgram(program);
+}
+
+GLint GLStats::getUniformLocation(GLuint program, const GLchar *name)
+{
+    countCall(s_currentFrame, GLCallType::GetUniformLocation);
+    return ::glGetUniformLocation(program, name);
+}
+
+void GLStats::getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                               GLenum *type, GLchar *name)
+{
+    countCall(s_currentFrame, GLCallType::GetActiveUniform);
+    ::glGetActiveUniform(program, index, bufSize, length, size, type, name);
+}
+
+void GLStats::getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length,
+                                        GLchar *uniformBlockName)
+{
+    countCall(s_currentFrame, GLCallType::GetActiveUniformBlockName);
+    ::glGetActiveUniformBlockName(program, uniformBlockIndex, bufSize, length, uniformBlockName);
+}
+
+void GLStats::uniform1i(GLint location, GLint v0)
+{
+    countCall(s_currentFrame, GLCallType::Uniform1i);
+    ::glUniform1i(location, v0);
+}
+
+void GLStats::uniform1f(GLint location, GLfloat v0)
+{
+    countCall(s_currentFrame, GLCallType::Uniform1f);
+    ::glUniform1f(location, v0);
+}
+
+void GLStats::uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    countCall(s_currentFrame, GLCallType::Uniform3f);
+    ::glUniform3f(location, v0, v1, v2);
+}
+
+void GLStats::uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    countCall(s_currentFrame, GLCallType::Uniform4f);
+    ::glUniform4f(location, v0, v1, v2, v3);
+}
+
+GLuint GLStats::getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName)
+{
+    countCall(s_currentFrame, GLCallType::GetUniformBlockIndex);
+    return ::glGetUniformBlockIndex(program, uniformBlockName);
+}
+
+void GLStats::uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+    countCall(s_currentFrame, GLCallType::UniformBlockBinding);
+    ::glUniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding);
+}
+
+// 绘制
+void GLStats::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    countCall(s_currentFrame, GLCallType::DrawArrays);
+    ++s_currentFrame.drawCalls;
+    s_currentFrame.triangles += trianglesForDraw(mode, count);
+    ::glDrawArrays(mode, first, count);
+}
+
+void GLStats::drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    countCall(s_currentFrame, GLCallType::DrawElements);
+    ++s_currentFrame.drawCalls;
+    s_currentFrame.triangles += trianglesForDraw(mode, count);
+    ::glDrawElements(mode, count, type, indices);
+}
+
+void GLStats::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+    countCall(s_currentFrame, GLCallType::DrawArraysInstanced);
+    ++s_currentFrame.drawCalls;
+    s_currentFrame.triangles += trianglesForDraw(mode, count) * static_cast<std::uint64_t>(instanceCount);
+    ::glDrawArraysInstanced(mode, first, count, instanceCount);
+}
+
+void GLStats::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                    GLsizei instanceCount)
+{
+    countCall(s_currentFrame, GLCallType::DrawElementsInstanced);
+    ++s_currentFrame.drawCalls;
+    s_currentFrame.triangles += trianglesForDraw(mode, count) * static_cast<std::uint64_t>(instanceCount);
+    ::glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+}
+
+void GLStats::multiDrawElementsWEBGL(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                                     GLsizei drawcount)
+{
+    // 一次提交算作一次绘制调用
+    countCall(s_currentFrame, GLCallType::MultiDrawElementsWEBGL);
+    ++s_currentFrame.drawCalls;
+    for (GLsizei i = 0; i < drawcount; ++i)
+    {
+        s_currentFrame.triangles += trianglesForDraw(mode, counts[i]);
+    }
+    ::glMultiDrawElementsWEBGL(mode, counts, type, offsets, drawcount);
+}
+
+void GLStats::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    countCall(s_currentFrame, GLCallType::ClearColor);
+    ::glClearColor(red, green, blue, alpha);
+}
+
+void GLStats::clear(GLbitfield mask)
+{
+    countCall(s_currentFrame, GLCallType::Clear);
+    ::glClear(mask);
+}
+
+// 渲染状态
+void GLStats::enable(GLenum cap)
+{
+    countCall(s_currentFrame, GLCallType::Enable);
+    ::glEnable(cap);
+}
+
+void GLStats::disable(GLenum cap)
+{
+    countCall(s_currentFrame, GLCallType::Disable);
+    ::glDisable(cap);
+}
+
+void GLStats::blendFunc(GLenum sfactor, GLenum dfactor)
+{
+    countCall(s_currentFrame, GLCallType::BlendFunc);
+    ::glBlendFunc(sfactor, dfactor);
+}
+
+void GLStats::depthFunc(GLenum func)
+{
+    countCall(s_currentFrame, GLCallType::DepthFunc);
+    ::glDepthFunc(func);
+}
+
+void GLStats::depthMask(GLboolean flag)
+{
+    countCall(s_currentFrame, GLCallType::DepthMask);
+    ::glDepthMask(flag);
+}
+
+void GLStats::cullFace(GLenum mode)
+{
+    countCall(s_currentFrame, GLCallType::CullFace);
+    ::glCullFace(mode);
+}
+
+void GLStats::getIntegerv(GLenum pname, GLint *data)
+{
+    countCall(s_currentFrame, GLCallType::GetIntegerv);
+    ::glGetIntegerv(pname, data);
+}
+
+// Electron 绑定接口 - 供 JS 读取每帧 GL 统计
+#ifdef __EMSCRIPTEN__
+extern "C"
+{
+    // 上一帧统计的 JSON，返回的字符串在下一次调用前有效
+    EMSCRIPTEN_KEEPALIVE
+    const char *engine_gl_stats_json()
+    {
+        static std::string json;
+        json = GLStats::lastFrame().toJson();
+        return json.c_str();
+    }
+
+    // 上一帧指定类型（GLCallType 序号）的调用次数
+    EMSCRIPTEN_KEEPALIVE
+    int engine_gl_stats_call_count(int type)
+    {
+        if (type < 0 || type >= static_cast<int>(GLCallType::Count))
+        {
+            return 0;
+        }
+        return static_cast<int>(GLStats::lastFrame().calls[type]);
+    }
+}
+#endif
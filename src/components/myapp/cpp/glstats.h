@@ -0,0 +1,277 @@
+#ifndef GLSTATS_H
+#define GLSTATS_H
+
+#include <GLES3/gl3.h>
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief GL 调用类型
+ *
+ * 与引擎使用到的 GL 入口一一对应，用于统计和录制
+ */
+enum class GLCallType
+{
+    GenBuffers,
+    DeleteBuffers,
+    BindBuffer,
+    BufferData,
+    BufferSubData,
+    BindBufferRange,
+    GenVertexArrays,
+    DeleteVertexArrays,
+    BindVertexArray,
+    VertexAttribPointer,
+    EnableVertexAttribArray,
+    DisableVertexAttribArray,
+    VertexAttribDivisor,
+    GenTextures,
+    DeleteTextures,
+    BindTexture,
+    ActiveTexture,
+    TexParameteri,
+    TexImage2D,
+    CreateShader,
+    ShaderSource,
+    CompileShader,
+    GetShaderiv,
+    GetShaderInfoLog,
+    DeleteShader,
+    CreateProgram,
+    AttachShader,
+    LinkProgram,
+    GetProgramiv,
+    GetProgramInfoLog,
+    DeleteProgram,
+    UseProgram,
+    GetUniformLocation,
+    GetActiveUniform,
+    GetActiveUniformBlockName,
+    Uniform1i,
+    Uniform1f,
+    Uniform3f,
+    Uniform4f,
+    GetUniformBlockIndex,
+    UniformBlockBinding,
+    DrawArrays,
+    DrawElements,
+    DrawArraysInstanced,
+    DrawElementsInstanced,
+    MultiDrawElementsWEBGL,
+    ClearColor,
+    Clear,
+    Enable,
+    Disable,
+    BlendFunc,
+    DepthFunc,
+    DepthMask,
+    CullFace,
+    GetIntegerv,
+    Count
+};
+
+/**
+ * @brief 获取 GL 调用类型名称
+ * @param type 调用类型
+ * @return 对应的 GL 函数名
+ */
+const char *glCallTypeName(GLCallType type);
+
+/**
+ * @brief 一帧的 GL 调用统计
+ */
+struct GLFrameStats
+{
+    std::uint32_t calls[static_cast<size_t>(GLCallType::Count)];     // 按类型的调用次数
+    std::uint32_t redundant[static_cast<size_t>(GLCallType::Count)]; // 按类型的冗余绑定次数（绑定已绑定的对象）
+    std::uint64_t bytesUploaded;                                     // glBufferData/glBufferSubData/glTexImage2D 上传的字节数
+    std::uint64_t triangles;                                         // 绘制的三角形数量
+    std::uint32_t drawCalls;
+
+    /**
+     * @brief 所有类型的调用总数
+     */
+    std::uint32_t totalCalls() const;
+
+    /**
+     * @brief 所有类型的冗余绑定总数
+     */
+    std::uint32_t totalRedundant() const;
+
+    /**
+     * @brief 转换为 JSON，便于 JS 读取
+     * @return JSON 字符串
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @brief GL 调用拦截层
+ *
+ * ENGINE_GL_STATS 启用时，glapi.h 把引擎使用的 gl* 入口重定向到这里的同名包装函数，
+ * 包装函数统计调用次数、冗余绑定、上传字节数和三角形数量后再调用真实的 GL 函数。
+ * 只在持有 GL 上下文的线程上调用，不做同步。
+ */
+class GLStats
+{
+public:
+    /**
+     * @brief 结束当前帧：保存本帧统计并清零计数
+     */
+    static void endFrame();
+
+    /**
+     * @brief 获取上一帧的统计
+     * @return 统计数据
+     */
+    static const GLFrameStats &lastFrame() { return s_lastFrame; }
+
+    /**
+     * @brief 获取当前帧到目前为止的统计
+     * @return 统计数据
+     */
+    static const GLFrameStats &currentFrame() { return s_currentFrame; }
+
+    /**
+     * @brief 清空绑定状态跟踪（GL 状态被外部代码修改后调用）
+     */
+    static void invalidateState();
+
+    // 包装函数
+    static void genBuffers(GLsizei n, GLuint *buffers);
+    static void deleteBuffers(GLsizei n, const GLuint *buffers);
+    static void bindBuffer(GLenum target, GLuint buffer);
+    static void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+    static void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+    static void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    static void genVertexArrays(GLsizei n, GLuint *arrays);
+    static void deleteVertexArrays(GLsizei n, const GLuint *arrays);
+    static void bindVertexArray(GLuint array);
+    static void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                    GLsizei stride, const void *pointer);
+    static void enableVertexAttribArray(GLuint index);
+    static void disableVertexAttribArray(GLuint index);
+    static void vertexAttribDivisor(GLuint index, GLuint divisor);
+
+    static void genTextures(GLsizei n, GLuint *textures);
+    static void deleteTextures(GLsizei n, const GLuint *textures);
+    static void bindTexture(GLenum target, GLuint texture);
+    static void activeTexture(GLenum texture);
+    static void texParameteri(GLenum target, GLenum pname, GLint param);
+    static void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                           GLint border, GLenum format, GLenum type, const void *pixels);
+
+    static GLuint createShader(GLenum type);
+    static void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length);
+    static void compileShader(GLuint shader);
+    static void getShaderiv(GLuint shader, GLenum pname, GLint *params);
+    static void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+    static void deleteShader(GLuint shader);
+    static GLuint createProgram();
+    static void attachShader(GLuint program, GLuint shader);
+    static void linkProgram(GLuint program);
+    static void getProgramiv(GLuint program, GLenum pname, GLint *params);
+    static void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+    static void deleteProgram(GLuint program);
+    static void useProgram(GLuint program);
+    static GLint getUniformLocation(GLuint program, const GLchar *name);
+    static void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size,
+                                 GLenum *type, GLchar *name);
+    static void getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length,
+                                          GLchar *uniformBlockName);
+    static void uniform1i(GLint location, GLint v0);
+    static void uniform1f(GLint location, GLfloat v0);
+    static void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+    static void uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+    static GLuint getUniformBlockIndex(GLuint program, const GLchar *uniformBlockName);
+    static void uniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+    static void drawArrays(GLenum mode, GLint first, GLsizei count);
+    static void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices);
+    static void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+    static void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                      GLsizei instanceCount);
+    static void multiDrawElementsWEBGL(GLenum mode, const GLsizei *counts, GLenum type, const void *const *offsets,
+                                       GLsizei drawcount);
+    static void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    static void clear(GLbitfield mask);
+
+    static void enable(GLenum cap);
+    static void disable(GLenum cap);
+    static void blendFunc(GLenum sfactor, GLenum dfactor);
+    static void depthFunc(GLenum func);
+    static void depthMask(GLboolean flag);
+    static void cullFace(GLenum mode);
+    static void getIntegerv(GLenum pname, GLint *data);
+
+private:
+    static GLFrameStats s_currentFrame;
+    static GLFrameStats s_lastFrame;
+};
+
+// 重定向 gl* 入口；实现 GL 函数本身的文件（glstats.cpp、glbackend_host.cpp）定义 GLSTATS_NO_REDIRECT
+#ifndef ENGINE_GL_STATS
+#define ENGINE_GL_STATS 1
+#endif
+
+#if ENGINE_GL_STATS && !defined(GLSTATS_NO_REDIRECT)
+#define glGenBuffers GLStats::genBuffers
+#define glDeleteBuffers GLStats::deleteBuffers
+#define glBindBuffer GLStats::bindBuffer
+#define glBufferData GLStats::bufferData
+#define glBufferSubData GLStats::bufferSubData
+#define glBindBufferRange GLStats::bindBufferRange
+#define glGenVertexArrays GLStats::genVertexArrays
+#define glDeleteVertexArrays GLStats::deleteVertexArrays
+#define glBindVertexArray GLStats::bindVertexArray
+#define glVertexAttribPointer GLStats::vertexAttribPointer
+#define glEnableVertexAttribArray GLStats::enableVertexAttribArray
+#define glDisableVertexAttribArray GLStats::disableVertexAttribArray
+#define glVertexAttribDivisor GLStats::vertexAttribDivisor
+#define glGenTextures GLStats::genTextures
+#define glDeleteTextures GLStats::deleteTextures
+#define glBindTexture GLStats::bindTexture
+#define glActiveTexture GLStats::activeTexture
+#define glTexParameteri GLStats::texParameteri
+#define glTexImage2D GLStats::texImage2D
+#define glCreateShader GLStats::createShader
+#define glShaderSource GLStats::shaderSource
+#define glCompileShader GLStats::compileShader
+#define glGetShaderiv GLStats::getShaderiv
+#define glGetShaderInfoLog GLStats::getShaderInfoLog
+#define glDeleteShader GLStats::deleteShader
+#define glCreateProgram GLStats::createProgram
+#define glAttachShader GLStats::attachShader
+#define glLinkProgram GLStats::linkProgram
+#define glGetProgramiv GLStats::getProgramiv
+#define glGetProgramInfoLog GLStats::getProgramInfoLog
+#define glDeleteProgram GLStats::deleteProgram
+#define glUseProgram GLStats::useProgram
+#define glGetUniformLocation GLStats::getUniformLocation
+#define glGetActiveUniform GLStats::getActiveUniform
+#define glGetActiveUniformBlockName GLStats::getActiveUniformBlockName
+#define glUniform1i GLStats::uniform1i
+#define glUniform1f GLStats::uniform1f
+#define glUniform3f GLStats::uniform3f
+#define glUniform4f GLStats::uniform4f
+#define glGetUniformBlockIndex GLStats::getUniformBlockIndex
+#define glUniformBlockBinding GLStats::uniformBlockBinding
+#define glDrawArrays GLStats::drawArrays
+#define glDrawElements GLStats::drawElements
+#define glDrawArraysInstanced GLStats::drawArraysInstanced
+#define glDrawElementsInstanced GLStats::drawElementsInstanced
+#define glMultiDrawElementsWEBGL GLStats::multiDrawElementsWEBGL
+#define glClearColor GLStats::clearColor
+#define glClear GLStats::clear
+#define glEnable GLStats::enable
+#define glDisable GLStats::disable
+#define glBlendFunc GLStats::blendFunc
+#define glDepthFunc GLStats::depthFunc
+#define glDepthMask GLStats::depthMask
+#define glCullFace GLStats::cullFace
+#define glGetIntegerv GLStats::getIntegerv
+#endif
+
+#endif // GLSTATS_H
@@ -0,0 +1,74 @@
+#ifndef GLTARGETS_H
+#define GLTARGETS_H
+
+#include "glapi.h"
+
+/**
+ * @brief 绑定目标到状态表下标的映射
+ *
+ * GLState 的状态缓存和 GLStats 的冗余绑定统计按同一套下标和纹理单元数量记录每个目标的绑定，
+ * 新增目标或调整跟踪的纹理单元数量时只需要修改这里
+ */
+class GLTargets
+{
+public:
+    static constexpr int kBufferTargetCount = 8;
+    static constexpr int kTextureTargetCount = 4;
+
+    // 跟踪的纹理单元数量，超出的单元不做缓存和统计
+    static constexpr int kMaxTextureUnits = 32;
+
+    /**
+     * @brief 获取缓冲目标的下标
+     * @param target 缓冲目标
+     * @return [0, kBufferTargetCount) 中的下标，不跟踪的目标返回 -1
+     */
+    static int bufferTargetIndex(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_ARRAY_BUFFER:
+            return 0;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return 1;
+        case GL_UNIFORM_BUFFER:
+            return 2;
+        case GL_COPY_READ_BUFFER:
+            return 3;
+        case GL_COPY_WRITE_BUFFER:
+            return 4;
+        case GL_PIXEL_PACK_BUFFER:
+            return 5;
+        case GL_PIXEL_UNPACK_BUFFER:
+            return 6;
+        case GL_TRANSFORM_FEEDBACK_BUFFER:
+            return 7;
+        default:
+            return -1;
+        }
+    }
+
+    /**
+     * @brief 获取纹理目标的下标
+     * @param target 纹理目标
+     * @return [0, kTextureTargetCount) 中的下标，不跟踪的目标返回 -1
+     */
+    static int textureTargetIndex(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_TEXTURE_CUBE_MAP:
+            return 1;
+        case GL_TEXTURE_3D:
+            return 2;
+        case GL_TEXTURE_2D_ARRAY:
+            return 3;
+        default:
+            return -1;
+        }
+    }
+};
+
+#endif // GLTARGETS_H
@@ -0,0 +1,695 @@
+// 原生主机入口 - 在没有浏览器/GPU的环境中运行引擎核心
+// 用于 perf / valgrind / sanitizer 分析，GL 调用由 GLBackend 接管
+//
+// 用法: engine_host [--frames N] [--objects N] [--backend null|recording] [--workers N] [--materials N] [--trace FILE]
+//                    [--check-parallel] [--instanced] [--static] [--hide-every N] [--no-multi-draw] [--ubo]
+//                    [--material-uniforms] [--material-instances N] [--async-shaders N]
+//                    [--warm-up FILE] [--particles N] [--byte-indices] [--vertex-colors] [--quantize]
+//   --trace 记录帧分析区域并导出 Chrome trace JSON
+//   --check-parallel 分别串行和并行录制一帧，比较两次产生的 GL 调用序列
+//   --instanced 网格声明标准实例属性布局，共享网格的对象合并为实例化绘制
+//   --static 所有对象标记为静态，场景初始化时按材质合批
+//   --hide-every 每 N 个对象隐藏一个，静态合批的可见范围因此断开
+//   --no-multi-draw 不使用 WEBGL_multi_draw，多重绘制回退为逐个绘制
+//   --ubo 着色器声明 FrameBlock/ViewBlock/ObjectBlock，逐对象数据通过 uniform 缓冲环绑定
+//   --material-uniforms 片段着色器声明材质 uniform，每个材质设置不同的颜色和强度
+//   --material-instances N 每个网格使用同一父材质的实例，颜色在 N 种之间轮换，初始化前合并内容相同的实例
+//   --async-shaders N 着色器通过 ShaderCache 异步编译，空后端在链接后的前 N 次完成状态查询返回未完成，期间绘制后备材质
+//   --warm-up FILE 加载时预先编译 FILE 中列出的着色器变体，退出时把本次用过的变体写回 FILE
+//   --particles N 每帧在 CPU 上重新生成 N 个粒子四边形，通过动态缓冲环流式上传顶点和索引，一次绘制
+//   --byte-indices 顶点不超过 255 个的网格使用 8 位索引（默认最窄使用 16 位）
+//   --vertex-colors 网格的顶点布局增加第二个流，存放归一化的 8 位顶点颜色
+//   --quantize 网格从导入器格式（位置、法线、UV、颜色共 48 字节的浮点顶点）量化后上传，输出误差
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dynamicbufferring.h"
+#include "glbackend.h"
+#include "glstate.h"
+#include "glstats.h"
+#include "indexformat.h"
+#include "material.h"
+#include "materialregistry.h"
+#include "mesh.h"
+#include "gameobject.h"
+#include "scene.h"
+#include "scenemanager.h"
+#include "shadercache.h"
+#include "shaderpermutations.h"
+#include "renderpass.h"
+#include "renderpipeline.h"
+#include "taskscheduler.h"
+#include "vertexarrayobject.h"
+#include "vertexlayout.h"
+#include "vertexquantizer.h"
+#include "profiler.h"
+
+namespace
+{
+    // 所有命令行组合共用一对源码，按关键字选择变体
+    const char *quadVertexShaderSource = "#version 300 es\n"
+                                         "#pragma keywords INSTANCED UNIFORM_BLOCKS\n"
+                                         "layout (location = 0) in vec3 aPos;\n"
+                                         "#ifdef INSTANCED\n"
+                                         "layout (location = 4) in mat4 aModel;\n"
+                                         "layout (location = 8) in vec4 aColor;\n"
+                                         "out vec4 vColor;\n"
+                                         "#endif\n"
+                                         "#ifdef UNIFORM_BLOCKS\n"
+                                         "layout (std140) uniform FrameBlock { vec4 uFrame; };\n"
+                                         "layout (std140) uniform ViewBlock { mat4 uViewProjection; vec4 uDepthRange; };\n"
+                                         "layout (std140) uniform ObjectBlock { mat4 uModel; vec4 uColor; vec4 uParams; };\n"
+                                         "#ifndef INSTANCED\n"
+                                         "out vec4 vColor;\n"
+                                         "#endif\n"
+                                         "#endif\n"
+                                         "void main()\n"
+                                         "{\n"
+                                         "#if defined(INSTANCED)\n"
+                                         "   vColor = aColor;\n"
+                                         "   gl_Position = aModel * vec4(aPos, 1.0);\n"
+                                         "#elif defined(UNIFORM_BLOCKS)\n"
+                                         "   vColor = uColor;\n"
+                                         "   gl_Position = uViewProjection * uModel * vec4(aPos, 1.0);\n"
+                                         "#else\n"
+                                         "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
+                                         "#endif\n"
+                                         "}\n";
+
+    const char *quadFragmentShaderSource = "#version 300 es\n"
+                                           "#pragma keywords MATERIAL_UNIFORMS\n"
+                                           "precision mediump float;\n"
+                                           "#ifdef MATERIAL_UNIFORMS\n"
+                                           "uniform vec4 uTint;\n"
+                                           "uniform float uIntensity;\n"
+                                           "#endif\n"
+                                           "out vec4 FragColor;\n"
+                                           "void main()\n"
+                                           "{\n"
+                                           "#ifdef MATERIAL_UNIFORMS\n"
+                                           "   FragColor = uTint * uIntensity;\n"
+                                           "#else\n"
+                                           "   FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);\n"
+                                           "#endif\n"
+                                           "}\n";
+
+    struct HostOptions
+    {
+        int frames = 600;
+        int objects = 1;
+        bool recording = false;
+        int workers = -1; // -1 表示使用默认工作线程数
+        int materials = 1; // 对象轮流使用的材质/网格数量
+        std::string tracePath;
+        bool checkParallel = false;
+        bool instanced = false;
+        bool staticObjects = false;
+        int hideEvery = 0;
+        bool multiDraw = true;
+        bool uniformBlocks = false;
+        bool materialUniforms = false;
+        int materialInstances = 0; // 实例颜色种类，0 表示不使用材质实例
+        int asyncShaders = -1;     // 模拟的编译轮询次数，-1 表示同步编译
+        std::string warmUpPath;
+        int particles = 0; // 每帧流式上传的粒子数量
+        bool byteIndices = false;
+        bool vertexColors = false;
+        bool quantize = false;
+    };
+
+    /**
+     * @brief 每帧重新生成的粒子几何，顶点和索引通过动态缓冲环上传
+     *
+     * 两个环同步轮换，环中每个位置一个 VAO，第一次使用时绑定该位置的顶点和索引缓冲
+     */
+    class ParticleStream
+    {
+    public:
+        ParticleStream()
+            : m_vertices(BufferObject::Type::VertexBuffer), m_indices(BufferObject::Type::ElementBuffer),
+              m_vertexArrays(m_vertices.getFrameCount()), m_configured(m_vertices.getFrameCount(), false)
+        {
+        }
+
+        void draw(Shader &shader, int count, float time)
+        {
+            if (!shader.isValid())
+                return;
+
+            const GLsizeiptr stride = 3 * sizeof(float);
+            m_vertices.beginFrame();
+            m_indices.beginFrame();
+
+            DynamicBufferRing::Allocation vertexAllocation;
+            DynamicBufferRing::Allocation indexAllocation;
+            float *vertices = static_cast<float *>(m_vertices.allocate(count * 4 * stride, stride, vertexAllocation));
+            GLuint *indices = static_cast<GLuint *>(
+                m_indices.allocate(count * 6 * static_cast<GLsizeiptr>(sizeof(GLuint)), sizeof(GLuint), indexAllocation));
+            if (!vertices || !indices)
+                return;
+
+            // 顶点按步长对齐，offset / stride 就是本帧第一个顶点的序号
+            const GLuint baseVertex = static_cast<GLuint>(vertexAllocation.offset / stride);
+            for (int i = 0; i < count; ++i)
+            {
+                const float x = static_cast<float>(i % 100) * 0.02f - 1.0f;
+                const float y = static_cast<float>(i / 100 % 100) * 0.02f - 1.0f + 0.01f * (time - static_cast<int>(time));
+                const float corners[4][2] = {{0.005f, 0.005f}, {0.005f, -0.005f}, {-0.005f, -0.005f}, {-0.005f, 0.005f}};
+                for (int corner = 0; corner < 4; ++corner)
+                {
+                    *vertices++ = x + corners[corner][0];
+                    *vertices++ = y + corners[corner][1];
+                    *vertices++ = 0.0f;
+                }
+                const GLuint first = baseVertex + static_cast<GLuint>(i) * 4;
+                const GLuint quad[6] = {first, first + 1, first + 3, first + 1, first + 2, first + 3};
+                std::copy(quad, quad + 6, indices);
+                indices += 6;
+            }
+
+            m_vertices.flush();
+            m_indices.flush();
+
+            const int slot = m_vertices.getFrameIndex();
+            VertexArrayObject &vertexArray = m_vertexArrays[slot];
+            if (!m_configured[slot])
+            {
+                const GLuint vertexBuffer = m_vertices.getCurrentBuffer();
+                vertexArray.setVertexLayout(*VertexLayout::position(), &vertexBuffer);
+                GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices.getCurrentBuffer());
+                m_configured[slot] = true;
+            }
+
+            shader.use();
+            vertexArray.bind();
+            glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT,
+                           reinterpret_cast<const void *>(indexAllocation.offset));
+        }
+
+        const DynamicBufferRing &getVertexRing() const { return m_vertices; }
+        const DynamicBufferRing &getIndexRing() const { return m_indices; }
+
+    private:
+        DynamicBufferRing m_vertices;
+        DynamicBufferRing m_indices;
+        std::vector<VertexArrayObject> m_vertexArrays;
+        std::vector<bool> m_configured;
+    };
+
+    /**
+     * @brief 用录制后端渲染一帧，返回 GL 调用序列
+     */
+    std::vector<GLCall> captureFrame(RenderPass &renderPass, bool parallel)
+    {
+        RecordingGLBackend backend;
+        backend.setLogEnabled(true);
+        GLBackend *previous = &GLBackend::current();
+        GLBackend::setCurrent(&backend);
+
+        GLState::invalidate();
+        renderPass.setParallelRecordingEnabled(parallel);
+        renderPass.setCommandCacheEnabled(false);
+        renderPass.render();
+        renderPass.setCommandCacheEnabled(true);
+        renderPass.setParallelRecordingEnabled(true);
+        GLState::invalidate();
+
+        GLBackend::setCurrent(previous);
+        return backend.calls();
+    }
+
+    bool sameCalls(const std::vector<GLCall> &a, const std::vector<GLCall> &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](const GLCall &x, const GLCall &y)
+                          { return x.type == y.type && x.arg0 == y.arg0 && x.arg1 == y.arg1; });
+    }
+
+    bool parseOptions(int argc, char **argv, HostOptions &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(arg, "--frames") == 0 && hasValue)
+            {
+                options.frames = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--objects") == 0 && hasValue)
+            {
+                options.objects = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--backend") == 0 && hasValue)
+            {
+                std::string backend = argv[++i];
+                if (backend != "null" && backend != "recording")
+                {
+                    std::cerr << "Unknown backend: " << backend << std::endl;
+                    return false;
+                }
+                options.recording = (backend == "recording");
+            }
+            else if (std::strcmp(arg, "--workers") == 0 && hasValue)
+            {
+                options.workers = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--materials") == 0 && hasValue)
+            {
+                options.materials = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--trace") == 0 && hasValue)
+            {
+                options.tracePath = argv[++i];
+            }
+            else if (std::strcmp(arg, "--check-parallel") == 0)
+            {
+                options.checkParallel = true;
+            }
+            else if (std::strcmp(arg, "--instanced") == 0)
+            {
+                options.instanced = true;
+            }
+            else if (std::strcmp(arg, "--static") == 0)
+            {
+                options.staticObjects = true;
+            }
+            else if (std::strcmp(arg, "--hide-every") == 0 && hasValue)
+            {
+                options.hideEvery = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--no-multi-draw") == 0)
+            {
+                options.multiDraw = false;
+            }
+            else if (std::strcmp(arg, "--ubo") == 0)
+            {
+                options.uniformBlocks = true;
+            }
+            else if (std::strcmp(arg, "--material-uniforms") == 0)
+            {
+                options.materialUniforms = true;
+            }
+            else if (std::strcmp(arg, "--warm-up") == 0 && hasValue)
+            {
+                options.warmUpPath = argv[++i];
+            }
+            else if (std::strcmp(arg, "--particles") == 0 && hasValue)
+            {
+                options.particles = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--byte-indices") == 0)
+            {
+                options.byteIndices = true;
+            }
+            else if (std::strcmp(arg, "--vertex-colors") == 0)
+            {
+                options.vertexColors = true;
+            }
+            else if (std::strcmp(arg, "--quantize") == 0)
+            {
+                options.quantize = true;
+            }
+            else if (std::strcmp(arg, "--async-shaders") == 0 && hasValue)
+            {
+                options.asyncShaders = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--material-instances") == 0 && hasValue)
+            {
+                options.materialInstances = std::atoi(argv[++i]);
+                options.materialUniforms = true;
+            }
+            else
+            {
+                std::cerr << "Usage: " << argv[0] << " [--frames N] [--objects N] [--backend null|recording] [--workers N] [--materials N] [--trace FILE] [--check-parallel] [--instanced] [--static] [--hide-every N] [--no-multi-draw] [--ubo] [--material-uniforms] [--material-instances N] [--async-shaders N] [--warm-up FILE] [--particles N] [--byte-indices] [--vertex-colors] [--quantize]" << std::endl;
+                return false;
+            }
+        }
+        return options.frames > 0 && options.objects > 0 && options.materials > 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    HostOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    TaskScheduler::instance().initialize(options.workers < 0 ? TaskScheduler::defaultWorkerCount()
+                                                             : static_cast<unsigned>(options.workers));
+
+    NullGLBackend nullBackend;
+    RecordingGLBackend recordingBackend;
+    GLBackend::setCurrent(options.recording ? static_cast<GLBackend *>(&recordingBackend) : &nullBackend);
+    if (options.asyncShaders >= 0)
+    {
+        nullBackend.setCompletionLatency(options.asyncShaders);
+        recordingBackend.setCompletionLatency(options.asyncShaders);
+    }
+    GLState::setMultiDrawEnabled(options.multiDraw);
+    IndexFormat::setByteIndicesEnabled(options.byteIndices);
+
+    // 构建与 main.cpp 相同的演示场景，按需复制多个对象
+    float vertices[] = {
+        0.5f, 0.5f, 0.0f,   // top right
+        0.5f, -0.5f, 0.0f,  // bottom right
+        -0.5f, -0.5f, 0.0f, // bottom left
+        -0.5f, 0.5f, 0.0f   // top left
+    };
+    unsigned int indices[] = {
+        0, 1, 3, // first Triangle
+        1, 2, 3  // second Triangle
+    };
+    const unsigned char colors[] = {
+        255, 0, 0, 255,
+        0, 255, 0, 255,
+        0, 0, 255, 255,
+        255, 255, 255, 255
+    };
+    // 导入器的顶点格式（与 FBXVertex 相同）：位置、法线、UV、颜色
+    const float importedVertices[] = {
+        0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
+        -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+        -0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f
+    };
+    QuantizedVertices quantizedVertices;
+    if (options.quantize)
+    {
+        VertexSource source;
+        source.positions = importedVertices;
+        source.normals = importedVertices + 3;
+        source.texcoords = importedVertices + 6;
+        source.colors = importedVertices + 8;
+        source.stride = 12 * sizeof(float);
+        quantizedVertices = VertexQuantizer::quantize(source, 4);
+    }
+
+    // 每个网格各自构造布局，共享表把它们合并为同一个对象
+    auto makeColorLayout = []()
+    {
+        return VertexLayout::share(VertexLayout()
+                                       .add(VertexSemantic::Position, 3, GL_FLOAT)
+                                       .add(VertexSemantic::Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 1));
+    };
+
+    ShaderPermutations permutations("quad", quadVertexShaderSource, quadFragmentShaderSource);
+    std::vector<std::string> keywords;
+    if (options.instanced)
+    {
+        keywords.push_back("INSTANCED");
+    }
+    else if (options.uniformBlocks)
+    {
+        keywords.push_back("UNIFORM_BLOCKS");
+    }
+    if (options.materialUniforms)
+    {
+        keywords.push_back("MATERIAL_UNIFORMS");
+    }
+    const ShaderPermutations::VariantKey variant = permutations.makeKey(keywords);
+
+    // 加载阶段：提交上次用过的变体并等待完成
+    size_t warmedUp = 0;
+    if (!options.warmUpPath.empty())
+    {
+        std::ifstream warmUpFile(options.warmUpPath);
+        if (warmUpFile)
+        {
+            warmedUp = permutations.warmUp(ShaderPermutations::readWarmUpList(warmUpFile));
+            ShaderCache::instance().finishAll();
+        }
+    }
+
+    const Shader::CompileMode compileMode =
+        options.asyncShaders >= 0 ? Shader::CompileMode::Deferred : Shader::CompileMode::Immediate;
+    if (options.asyncShaders >= 0)
+    {
+        // 后备材质使用不带关键字的源码同步编译，编译期间代替其他材质绘制
+        auto fallbackShader = std::make_shared<Shader>(quadVertexShaderSource, quadFragmentShaderSource, true);
+        Material::setFallback(std::make_shared<Material>(fallbackShader));
+    }
+    auto shader = permutations.getVariant(variant, compileMode);
+    auto baseMaterial = std::make_shared<Material>(shader);
+    baseMaterial->setColor("uTint", 1.0f, 1.0f, 1.0f, 1.0f);
+    baseMaterial->setFloat("uIntensity", 1.0f);
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    for (int i = 0; i < options.materials; ++i)
+    {
+        auto mesh = std::make_shared<Mesh>();
+        // 静态合批需要读取顶点和索引的 CPU 副本
+        mesh->setKeepGeometry(options.staticObjects);
+        if (options.quantize)
+        {
+            mesh->setVertices(quantizedVertices);
+        }
+        else if (options.vertexColors)
+        {
+            const void *streams[] = {vertices, colors};
+            mesh->setVertices(makeColorLayout(), streams, 4);
+        }
+        else
+        {
+            mesh->setVertices(vertices, 4, 3 * sizeof(float));
+        }
+        mesh->setIndices(indices, 6);
+        // 每个材质都按变体键请求程序，同一个变体只编译一次
+        std::shared_ptr<Shader> materialShader = permutations.getVariant(variant, compileMode);
+        std::shared_ptr<Material> material;
+        if (options.materialInstances > 0)
+        {
+            material = Material::createInstance(baseMaterial);
+            material->setColor("uTint", 1.0f, 0.5f, static_cast<float>(i % options.materialInstances) / options.materialInstances, 1.0f);
+        }
+        else if (options.materialUniforms)
+        {
+            material = std::make_shared<Material>(materialShader);
+            material->setColor("uTint", 1.0f, 0.5f, static_cast<float>(i) / options.materials, 1.0f);
+            material->setFloat("uIntensity", 1.0f);
+        }
+        else
+        {
+            material = std::make_shared<Material>(materialShader);
+        }
+        mesh->setMaterial(material);
+        if (options.instanced)
+        {
+            mesh->setInstanceLayout(InstanceLayout::standard());
+        }
+        meshes.push_back(mesh);
+    }
+
+    auto scene = std::make_shared<Scene>("MainScene");
+    for (int i = 0; i < options.objects; ++i)
+    {
+        // 材质交替出现，按录制顺序绘制时每个对象都要切换状态
+        auto gameObject = std::make_shared<GameObject>("Quad" + std::to_string(i));
+        gameObject->addMesh(meshes[i % meshes.size()]);
+        gameObject->setPosition(static_cast<float>(i % 100) * 0.02f - 1.0f, static_cast<float>(i / 100) * 0.02f - 1.0f, 0.0f);
+        gameObject->setStatic(options.staticObjects);
+        gameObject->setVisible(options.hideEvery <= 0 || i % options.hideEvery != 0);
+        scene->addGameObject(gameObject);
+    }
+
+    if (options.materialInstances > 0)
+    {
+        MaterialRegistry registry;
+        size_t replaced = scene->deduplicateMaterials(registry);
+        std::cout << "material registry: " << replaced << " meshes merged, " << registry.getMaterialCount()
+                  << " unique materials" << std::endl;
+    }
+
+    auto sceneManager = std::make_shared<SceneManager>();
+    sceneManager->addScene("main", scene);
+    sceneManager->initializeCurrentScene();
+
+    auto renderPass = std::make_shared<RenderPass>();
+    renderPass->setClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    renderPass->setClearMask(GL_COLOR_BUFFER_BIT);
+    for (auto &obj : scene->getGameObjects())
+    {
+        renderPass->addGameObject(obj);
+    }
+    for (auto &batch : scene->getStaticBatches())
+    {
+        renderPass->addStaticBatch(batch);
+    }
+
+    auto renderPipeline = std::make_shared<RenderPipeline>();
+    renderPipeline->addRenderPass("main", renderPass);
+
+    std::unique_ptr<ParticleStream> particles;
+    std::shared_ptr<Shader> particleShader;
+    if (options.particles > 0)
+    {
+        particles = std::make_unique<ParticleStream>();
+        particleShader = permutations.getVariant(permutations.makeKey({}), compileMode);
+    }
+
+    if (options.checkParallel)
+    {
+        // 比较的两帧必须使用同一组程序
+        ShaderCache::instance().finishAll();
+
+        // 先把 uniform 缓冲环的每个缓冲都渲染一遍，排除第一次录制时创建缓冲区等一次性调用；
+        // 两次比较的帧之间相隔一整轮，使用环中的同一个缓冲
+        const int ringFrames = UniformBufferRing::kDefaultFrameCount;
+        for (int i = 0; i < ringFrames; ++i)
+        {
+            captureFrame(*renderPass, false);
+        }
+        std::vector<GLCall> serialCalls = captureFrame(*renderPass, false);
+        for (int i = 1; i < ringFrames; ++i)
+        {
+            captureFrame(*renderPass, false);
+        }
+        std::vector<GLCall> parallelCalls = captureFrame(*renderPass, true);
+        bool same = sameCalls(serialCalls, parallelCalls);
+        std::cout << "parallel recording: " << (same ? "identical" : "MISMATCH") << " ("
+                  << serialCalls.size() << " serial / " << parallelCalls.size() << " parallel GL calls)" << std::endl;
+        if (!same)
+        {
+            Material::setFallback(nullptr);
+            ShaderCache::instance().clear();
+            GLBackend::setCurrent(nullptr);
+            TaskScheduler::instance().shutdown();
+            return 1;
+        }
+        renderPass->resetCommandCacheStats();
+    }
+
+    // 只统计帧循环中的调用
+    recordingBackend.reset();
+
+    Profiler::setEnabled(!options.tracePath.empty());
+
+    const float deltaTime = 1.0f / 60.0f;
+    int shadersReadyFrame = ShaderCache::instance().getPendingCount() == 0 ? 0 : -1;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < options.frames; ++frame)
+    {
+        PROFILE_ZONE("Frame");
+
+        // 与 main.cpp 相同的帧作业图：场景更新 -> 渲染准备
+        TaskScheduler &scheduler = TaskScheduler::instance();
+        Job *frameJob = scheduler.createJob(nullptr);
+        Job *updateJob = scene->createUpdateJob(deltaTime, frameJob);
+        Job *prepareJob = renderPipeline->createPrepareJob(frameJob);
+        scheduler.addContinuation(updateJob, prepareJob);
+        scheduler.run(updateJob);
+        scheduler.run(frameJob);
+        scheduler.wait(frameJob);
+
+        renderPass->setFrameTime(frame * deltaTime, deltaTime);
+        renderPipeline->render();
+        if (particles)
+        {
+            particles->draw(*particleShader, options.particles, frame * deltaTime);
+        }
+        GLStats::endFrame();
+        if (shadersReadyFrame < 0 && ShaderCache::instance().getPendingCount() == 0)
+        {
+            shadersReadyFrame = frame + 1;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    Profiler::setEnabled(false);
+
+    double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "frames: " << options.frames << ", objects: " << options.objects << std::endl;
+    std::cout << "total: " << totalMs << " ms, per frame: " << totalMs / options.frames << " ms" << std::endl;
+
+    const RenderQueueStats &queueStats = renderPass->getCommandStats();
+    std::cout << "draw sort: " << queueStats.drawCount << " draws, state changes program/material/vao "
+              << queueStats.programChanges << "/" << queueStats.materialChanges << "/" << queueStats.vertexArrayChanges
+              << " (unsorted " << queueStats.unsortedProgramChanges << "/" << queueStats.unsortedMaterialChanges
+              << "/" << queueStats.unsortedVertexArrayChanges << ", saved " << queueStats.savedStateChanges() << ")"
+              << std::endl;
+    const RenderPass::InstancingStats &instancingStats = renderPass->getInstancingStats();
+    std::cout << "instancing: " << instancingStats.instanceCount << " instances in " << instancingStats.drawCount
+              << " instanced draws" << std::endl;
+    size_t batchedRanges = 0;
+    for (auto &batch : scene->getStaticBatches())
+    {
+        batchedRanges += batch->getRanges().size();
+    }
+    std::cout << "static batching: " << scene->getStaticBatches().size() << " batches, " << batchedRanges
+              << " object ranges" << std::endl;
+    const RenderPass::CommandCacheStats &cacheStats = renderPass->getCommandCacheStats();
+    std::cout << "command cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, hit rate "
+              << cacheStats.hitRate() * 100.0 << "%" << std::endl;
+    const RenderPass::UniformStats &uniformStats = renderPass->getUniformStats();
+    std::cout << "uniform ring: " << uniformStats.objectBlocks << " object blocks, " << uniformStats.bytesUploaded
+              << " bytes uploaded per frame" << std::endl;
+    std::cout << "vertex layouts: " << VertexLayout::getSharedCount() << " shared" << std::endl;
+    if (options.quantize)
+    {
+        const QuantizationError &error = quantizedVertices.error;
+        std::cout << "vertex quantization: " << 12 * sizeof(float) << " -> " << quantizedVertices.layout->getStride(0)
+                  << " bytes per vertex, max error position " << error.position << ", normal " << error.normalDegrees
+                  << " deg, uv " << error.texcoord << ", color " << error.color << std::endl;
+    }
+    const IndexFormat::Stats &indexBufferStats = IndexFormat::getStats();
+    std::cout << "index buffers: " << indexBufferStats.byteBuffers << " u8 / " << indexBufferStats.shortBuffers << " u16 / "
+              << indexBufferStats.intBuffers << " u32, " << indexBufferStats.bytes << " bytes (" << indexBufferStats.bytesSaved()
+              << " saved vs 32-bit)" << std::endl;
+    if (particles)
+    {
+        const DynamicBufferRing::Stats &vertexStats = particles->getVertexRing().getStats();
+        const DynamicBufferRing::Stats &indexStats = particles->getIndexRing().getStats();
+        std::cout << "dynamic rings: " << options.particles << " particles, " << vertexStats.bytesUploaded
+                  << " vertex / " << indexStats.bytesUploaded << " index bytes uploaded per frame, "
+                  << vertexStats.orphans + indexStats.orphans << " orphans, "
+                  << particles->getVertexRing().getCapacity() << " / " << particles->getIndexRing().getCapacity()
+                  << " bytes capacity" << std::endl;
+    }
+    if (options.asyncShaders >= 0)
+    {
+        const ShaderCache::Stats &shaderStats = ShaderCache::instance().getStats();
+        std::cout << "shader cache: " << ShaderCache::instance().getProgramCount() << " programs, "
+                  << shaderStats.hits << " hits, " << ShaderCache::instance().getPendingCount() << " pending, ";
+        if (shadersReadyFrame >= 0)
+        {
+            std::cout << "ready after " << shadersReadyFrame << " frames" << std::endl;
+        }
+        else
+        {
+            std::cout << "not ready" << std::endl;
+        }
+    }
+    if (!options.warmUpPath.empty())
+    {
+        std::cout << "shader variants: " << permutations.getUsedVariants().size() << " used, " << warmedUp
+                  << " warmed up" << std::endl;
+        std::ofstream warmUpFile(options.warmUpPath);
+        permutations.writeWarmUpList(warmUpFile);
+    }
+    std::cout << "last frame GL stats: " << GLStats::lastFrame().toJson() << std::endl;
+
+    if (options.recording)
+    {
+        std::cout << "GL calls (" << options.frames << " frames):\n"
+                  << recordingBackend.summary();
+    }
+
+    if (!options.tracePath.empty() && Profiler::writeChromeTrace(options.tracePath))
+    {
+        std::cout << "trace written to " << options.tracePath << std::endl;
+    }
+
+    particles.reset();
+    Material::setFallback(nullptr);
+    ShaderCache::instance().clear();
+    GLBackend::setCurrent(nullptr);
+    TaskScheduler::instance().shutdown();
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "indexformat.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    template <typename T, typename Source>
+    void packAs(const Source *indices, size_t count, std::vector<std::uint8_t> &data)
+    {
+        data.resize(count * sizeof(T));
+        std::uint8_t *out = data.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const T index = static_cast<T>(indices[i]);
+            std::memcpy(out + i * sizeof(T), &index, sizeof(T));
+        }
+    }
+
+    template <typename Source>
+    GLenum packIndices(const Source *indices, size_t count, std::vector<std::uint8_t> &data)
+    {
+        const std::uint32_t maxIndex = count > 0 ? *std::max_element(indices, indices + count) : 0;
+        const GLenum type = IndexFormat::choose(maxIndex);
+        data.clear();
+        if (static_cast<size_t>(IndexFormat::size(type)) == sizeof(Source))
+            return type;
+
+        switch (type)
+        {
+        case GL_UNSIGNED_BYTE:
+            packAs<std::uint8_t>(indices, count, data);
+            break;
+        case GL_UNSIGNED_SHORT:
+            packAs<std::uint16_t>(indices, count, data);
+            break;
+        default:
+            packAs<std::uint32_t>(indices, count, data);
+            break;
+        }
+        return type;
+    }
+
+    std::uint32_t *bufferCounter(IndexFormat::Stats &stats, GLenum type)
+    {
+        switch (type)
+        {
+        case GL_UNSIGNED_BYTE:
+            return &stats.byteBuffers;
+        case GL_UNSIGNED_SHORT:
+            return &stats.shortBuffers;
+        case GL_UNSIGNED_INT:
+            return &stats.intBuffers;
+        default:
+            return nullptr;
+        }
+    }
+}
+
+GLenum IndexFormat::choose(std::uint32_t maxIndex)
+{
+    // 全 1 的值是 WebGL2 始终开启的图元重启索引，不能作为顶点索引
+    if (s_byteIndices && maxIndex < 0xFFu)
+        return GL_UNSIGNED_BYTE;
+    if (maxIndex < 0xFFFFu)
+        return GL_UNSIGNED_SHORT;
+    return GL_UNSIGNED_INT;
+}
+
+GLsizei IndexFormat::size(GLenum type)
+{
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_UNSIGNED_INT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+GLenum IndexFormat::pack(const std::uint32_t *indices, size_t count, std::vector<std::uint8_t> &data)
+{
+    return packIndices(indices, count, data);
+}
+
+GLenum IndexFormat::pack(const std::uint16_t *indices, size_t count, std::vector<std::uint8_t> &data)
+{
+    return packIndices(indices, count, data);
+}
+
+GLenum IndexFormat::pack(const std::uint8_t *indices, size_t count, std::vector<std::uint8_t> &data)
+{
+    return packIndices(indices, count, data);
+}
+
+void IndexFormat::addBuffer(GLenum type, size_t count)
+{
+    std::uint32_t *counter = bufferCounter(s_stats, type);
+    if (!counter)
+        return;
+
+    ++*counter;
+    s_stats.indexCount += count;
+    s_stats.bytes += count * static_cast<size_t>(size(type));
+}
+
+void IndexFormat::removeBuffer(GLenum type, size_t count)
+{
+    std::uint32_t *counter = bufferCounter(s_stats, type);
+    if (!counter)
+        return;
+
+    --*counter;
+    s_stats.indexCount -= count;
+    s_stats.bytes -= count * static_cast<size_t>(size(type));
+}
@@ -0,0 +1,97 @@
+#ifndef INDEXFORMAT_H
+#define INDEXFORMAT_H
+
+#include "glapi.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 索引缓冲的类型选择、打包和显存统计
+ *
+ * 按最大索引值选择能容纳它的最窄类型：不超过 65535 个顶点（最大索引 65534）的网格使用 GL_UNSIGNED_SHORT，
+ * 索引带宽和显存都减半。WebGL2 始终开启 PRIMITIVE_RESTART_FIXED_INDEX，类型的最大值（0xFF、0xFFFF）
+ * 被当作图元重启，因此不能作为顶点索引。GL_UNSIGNED_BYTE 默认不使用：ANGLE 的 D3D11 后端不支持 8 位索引，
+ * 每次绘制都要在 CPU 上转换成 16 位，只有确认目标平台原生支持时才通过 setByteIndicesEnabled() 启用。
+ * 统计只在持有 GL 上下文的线程上更新
+ */
+class IndexFormat
+{
+public:
+    /**
+     * @brief 索引缓冲的显存统计（当前存在的缓冲）
+     */
+    struct Stats
+    {
+        std::uint32_t byteBuffers;   // GL_UNSIGNED_BYTE 缓冲数量
+        std::uint32_t shortBuffers;  // GL_UNSIGNED_SHORT 缓冲数量
+        std::uint32_t intBuffers;    // GL_UNSIGNED_INT 缓冲数量
+        std::uint64_t indexCount;    // 索引总数
+        std::uint64_t bytes;         // 实际占用的字节数
+        std::uint64_t bytesSaved() const { return indexCount * sizeof(std::uint32_t) - bytes; } // 相对全部使用 32 位索引节省的字节数
+    };
+
+    /**
+     * @brief 选择能容纳最大索引值的最窄类型（最大索引必须小于类型的图元重启值）
+     * @param maxIndex 最大索引值
+     * @return GL_UNSIGNED_BYTE、GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT
+     */
+    static GLenum choose(std::uint32_t maxIndex);
+
+    /**
+     * @brief 获取索引类型的字节数
+     * @param type 索引类型
+     * @return 字节数，未知类型返回 0
+     */
+    static GLsizei size(GLenum type);
+
+    /**
+     * @brief 按 choose() 选择的类型把索引打包成缓冲数据
+     *
+     * 源索引已经是选择的宽度时不复制，data 保持为空，调用方直接上传源索引
+     * @param indices 索引
+     * @param count 索引数量
+     * @param data 输出打包后的字节，不需要转换时为空
+     * @return 选择的索引类型
+     */
+    static GLenum pack(const std::uint32_t *indices, size_t count, std::vector<std::uint8_t> &data);
+    static GLenum pack(const std::uint16_t *indices, size_t count, std::vector<std::uint8_t> &data);
+    static GLenum pack(const std::uint8_t *indices, size_t count, std::vector<std::uint8_t> &data);
+
+    /**
+     * @brief 启用/禁用 8 位索引（默认禁用）
+     * @param enabled 是否启用
+     */
+    static void setByteIndicesEnabled(bool enabled) { s_byteIndices = enabled; }
+
+    /**
+     * @brief 检查是否启用了 8 位索引
+     * @return 是否启用
+     */
+    static bool isByteIndicesEnabled() { return s_byteIndices; }
+
+    /**
+     * @brief 记录创建的索引缓冲
+     * @param type 索引类型
+     * @param count 索引数量
+     */
+    static void addBuffer(GLenum type, size_t count);
+
+    /**
+     * @brief 记录释放（或被替换）的索引缓冲
+     * @param type 索引类型
+     * @param count 索引数量
+     */
+    static void removeBuffer(GLenum type, size_t count);
+
+    /**
+     * @brief 获取当前的统计
+     * @return 统计数据
+     */
+    static const Stats &getStats() { return s_stats; }
+
+private:
+    static inline bool s_byteIndices = false;
+    static inline Stats s_stats{};
+};
+
+#endif // INDEXFORMAT_H
@@ -0,0 +1,33 @@
+#include "instancing.h"
+#include "glstate.h"
+#include <cstddef>
+
+InstanceLayout &InstanceLayout::add(GLuint location, GLint size, GLenum type, GLboolean normalized, GLuint offset)
+{
+    m_attributes.push_back({location, size, type, normalized, offset});
+    return *this;
+}
+
+void InstanceLayout::bindAttributes(GLuint buffer, std::uintptr_t baseOffset) const
+{
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (const InstanceAttribute &attribute : m_attributes)
+    {
+        glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized, kStride,
+                              reinterpret_cast<const void *>(baseOffset + attribute.offset));
+    }
+}
+
+InstanceLayout InstanceLayout::standard(GLuint firstLocation)
+{
+    InstanceLayout layout;
+    // mat4 属性按列占用 4 个连续位置
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        layout.add(firstLocation + column, 4, GL_FLOAT, GL_FALSE,
+                   static_cast<GLuint>(offsetof(InstanceData, model) + column * 4 * sizeof(float)));
+    }
+    layout.add(firstLocation + 4, 4, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offsetof(InstanceData, color)));
+    layout.add(firstLocation + 5, 4, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offsetof(InstanceData, params)));
+    return layout;
+}
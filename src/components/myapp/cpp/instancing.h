@@ -0,0 +1,85 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include "glapi.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 每个实例的数据，RenderPass 按此格式打包到实例缓冲区
+ */
+struct InstanceData
+{
+    float model[16]; // 模型矩阵（列主序）
+    float color[4];  // 实例颜色
+    float params[4]; // 自定义参数
+};
+
+/**
+ * @brief 实例属性：InstanceData 中的一个字段对应的顶点属性
+ */
+struct InstanceAttribute
+{
+    GLuint location;      // 属性位置
+    GLint size;           // 分量数 (1, 2, 3, 4)
+    GLenum type;          // 数据类型
+    GLboolean normalized; // 是否归一化
+    GLuint offset;        // 在 InstanceData 中的字节偏移
+};
+
+/**
+ * @brief 实例属性布局
+ *
+ * 声明着色器从实例缓冲区读取哪些 InstanceData 字段。属性的除数和启用状态保存在 VAO 中，
+ * 属性指针在每次实例化绘制前指向该组实例在缓冲区中的位置（WebGL2 没有 baseInstance）
+ */
+class InstanceLayout
+{
+public:
+    // 实例缓冲区中相邻实例的字节间隔
+    static constexpr GLsizei kStride = sizeof(InstanceData);
+
+    // 标准布局的第一个属性位置，网格顶点属性使用更低的位置
+    static constexpr GLuint kDefaultFirstLocation = 4;
+
+    /**
+     * @brief 添加一个实例属性
+     * @param location 属性位置
+     * @param size 分量数
+     * @param type 数据类型
+     * @param normalized 是否归一化
+     * @param offset 在 InstanceData 中的字节偏移
+     * @return 布局本身，便于链式调用
+     */
+    InstanceLayout &add(GLuint location, GLint size, GLenum type, GLboolean normalized, GLuint offset);
+
+    /**
+     * @brief 获取所有实例属性
+     * @return 属性列表
+     */
+    const std::vector<InstanceAttribute> &getAttributes() const { return m_attributes; }
+
+    /**
+     * @brief 把属性指针指向实例缓冲区中的一组实例（调用前必须绑定目标 VAO）
+     * @param buffer 实例缓冲区
+     * @param baseOffset 第一个实例的字节偏移
+     */
+    void bindAttributes(GLuint buffer, std::uintptr_t baseOffset) const;
+
+    /**
+     * @brief 标准布局：模型矩阵占用 firstLocation 开始的 4 个 vec4，随后是颜色和自定义参数
+     *
+     * 对应着色器声明：
+     *   layout(location = 4) in mat4 aModel;
+     *   layout(location = 8) in vec4 aColor;
+     *   layout(location = 9) in vec4 aParams;
+     * @param firstLocation 第一个属性位置
+     * @return 布局
+     */
+    static InstanceLayout standard(GLuint firstLocation = kDefaultFirstLocation);
+
+private:
+    std::vector<InstanceAttribute> m_attributes;
+};
+
+#endif // INSTANCING_H
@@ -14,12 +14,16 @@
 #include "vertexarrayobject.h"
 #include "bufferobject.h"
 #include "material.h"
+#include "shadercache.h"
 #include "mesh.h"
 #include "gameobject.h"
 #include "scene.h"
 #include "scenemanager.h"
 #include "renderpass.h"
 #include "renderpipeline.h"
+#include "taskscheduler.h"
+#include "profiler.h"
+#include "glstats.h"
 
 // 新的 ozz 动画接口
 #include "ozz_animation.h"
@@ -195,6 +199,9 @@ int main()
     glfwMakeContextCurrent(window);
     setupEvents();
 
+    // 启动工作线程池；单线程构建中任务直接在主线程上执行
+    TaskScheduler::instance().initialize(TaskScheduler::defaultWorkerCount());
+
     // 使用新的渲染架构
     // ------------------------------------------------------------------
     float vertices[] = {
@@ -209,8 +216,9 @@ int main()
         1, 2, 3  // second Triangle
     };
 
-    // 创建着色器对象 - 从内存源码创建
-    auto shader = std::make_shared<Shader>(vertexShaderSource, fragmentShaderSource, true);
+    // 从程序缓存获取着色器：编译和链接在后台完成。没有设置后备材质，
+    // 完成前 Material::apply() 返回 false，命令队列跳过使用这个材质的绘制
+    auto shader = ShaderCache::instance().getProgram(vertexShaderSource, fragmentShaderSource);
 
     // 创建材质
     auto material = std::make_shared<Material>(shader);
@@ -250,6 +258,10 @@ int main()
         {
             renderPass->addGameObject(obj);
         }
+        for (auto &batch : currentScene->getStaticBatches())
+        {
+            renderPass->addStaticBatch(batch);
+        }
     }
 
     // 创建渲染管线并添加渲染过程
@@ -259,6 +271,8 @@ int main()
     // uncomment this call to draw in wireframe polygons.
     // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    double lastFrameTime = glfwGetTime();
+
     // 跟踪窗口大小变化
     static int lastWidth = SCR_WIDTH;
     static int lastHeight = SCR_HEIGHT;
@@ -269,6 +283,8 @@ int main()
     {
         if (!glfwWindowShouldClose(window))
         {
+            PROFILE_ZONE("Frame");
+
             // 处理GLFW事件
             // glfwPollEvents();
 
@@ -302,14 +318,30 @@ int main()
                 bResize = false;
             }
 
+            double currentTime = glfwGetTime();
+            float deltaTime = static_cast<float>(currentTime - lastFrameTime);
+            lastFrameTime = currentTime;
+
+            // 帧作业图：场景更新 -> 渲染准备，由工作线程并行执行
+            // ------
+            TaskScheduler &scheduler = TaskScheduler::instance();
+            Job *frameJob = scheduler.createJob(nullptr);
+            Job *updateJob = scene->createUpdateJob(deltaTime, frameJob);
+            Job *prepareJob = renderPipeline->createPrepareJob(frameJob);
+            scheduler.addContinuation(updateJob, prepareJob);
+            scheduler.run(updateJob);
+            scheduler.run(frameJob);
+            scheduler.wait(frameJob);
+
             // render
             // ------
-            // 使用渲染管线执行所有渲染过程
+            // 使用渲染管线执行所有渲染过程（GL 调用只在主线程）
             renderPipeline->render();
 
             // glfw: swap buffers
             // ------------------
             glfwSwapBuffers(window);
+            GLStats::endFrame();
         }
     };
     // 使用requestAnimationFrame而不是固定帧率
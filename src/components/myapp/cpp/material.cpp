@@ -1,12 +1,45 @@
 #include "material.h"
+#include "profiler.h"
+#include "glstate.h"
+#include "renderrevision.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+namespace
+{
+    std::uint32_t nextSortId()
+    {
+        static std::atomic<std::uint32_t> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<Material> &fallbackMaterial()
+    {
+        static std::shared_ptr<Material> fallback;
+        return fallback;
+    }
+
+    void hashCombine(std::size_t &seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9u + (seed << 6) + (seed >> 2);
+    }
+}
 
 Material::Material()
-    : m_shader(nullptr)
+    : m_shader(nullptr), m_sortId(nextSortId()), m_translucent(false), m_version(0), m_revision(0),
+      m_compiledShader(nullptr), m_appliedShader(nullptr), m_appliedWrites(0), m_appliedParentVersion(0),
+      m_inheritedValid(false)
 {
 }
 
 Material::Material(std::shared_ptr<Shader> shader)
-    : m_shader(shader)
+    : m_shader(shader), m_sortId(nextSortId()), m_translucent(false), m_version(0), m_revision(0),
+      m_compiledShader(m_shader && !m_shader->isPending() ? m_shader.get() : nullptr),
+      m_appliedShader(nullptr), m_appliedWrites(0), m_appliedParentVersion(0),
+      m_inheritedValid(false)
 {
 }
 
@@ -16,11 +49,21 @@ Material::~Material()
 
 Material::Material(Material &&other) noexcept
     : m_shader(std::move(other.m_shader)),
-      m_floatProperties(std::move(other.m_floatProperties)),
-      m_intProperties(std::move(other.m_intProperties)),
-      m_boolProperties(std::move(other.m_boolProperties)),
-      m_colorProperties(std::move(other.m_colorProperties)),
-      m_textureProperties(std::move(other.m_textureProperties))
+      m_parent(std::move(other.m_parent)),
+      m_sortId(nextSortId()),
+      m_translucent(other.m_translucent),
+      m_parameters(std::move(other.m_parameters)),
+      m_parameterIndex(std::move(other.m_parameterIndex)),
+      m_parameterData(std::move(other.m_parameterData)),
+      m_dirtyMask(std::move(other.m_dirtyMask)),
+      m_textures(std::move(other.m_textures)),
+      m_version(other.m_version),
+      m_revision(other.m_revision),
+      m_compiledShader(other.m_compiledShader),
+      m_appliedShader(nullptr),
+      m_appliedWrites(0),
+      m_appliedParentVersion(0),
+      m_inheritedValid(false)
 {
 }
 
@@ -29,106 +72,454 @@ Material &Material::operator=(Material &&other) noexcept
     if (this != &other)
     {
         m_shader = std::move(other.m_shader);
-        m_floatProperties = std::move(other.m_floatProperties);
-        m_intProperties = std::move(other.m_intProperties);
-        m_boolProperties = std::move(other.m_boolProperties);
-        m_colorProperties = std::move(other.m_colorProperties);
-        m_textureProperties = std::move(other.m_textureProperties);
+        m_parent = std::move(other.m_parent);
+        m_translucent = other.m_translucent;
+        m_parameters = std::move(other.m_parameters);
+        m_parameterIndex = std::move(other.m_parameterIndex);
+        m_parameterData = std::move(other.m_parameterData);
+        m_dirtyMask = std::move(other.m_dirtyMask);
+        m_textures = std::move(other.m_textures);
+        ++m_version;
+        m_revision = RenderRevision::bump();
+        m_compiledShader = other.m_compiledShader;
+        m_appliedShader = nullptr;
+        m_appliedWrites = 0;
+        m_appliedParentVersion = 0;
+        m_inheritedValid = false;
     }
     return *this;
 }
 
+std::uint64_t Material::getRevision() const
+{
+    std::uint64_t revision = m_revision;
+    if (m_parent)
+    {
+        revision = std::max(revision, m_parent->m_revision);
+    }
+    const std::shared_ptr<Shader> &shader = this->shader();
+    if (shader)
+    {
+        revision = std::max(revision, shader->getRevision());
+    }
+    return revision;
+}
+
+void Material::setFallback(std::shared_ptr<Material> fallback)
+{
+    fallbackMaterial() = std::move(fallback);
+}
+
+const std::shared_ptr<Material> &Material::getFallback()
+{
+    return fallbackMaterial();
+}
+
+std::shared_ptr<Material> Material::createInstance(std::shared_ptr<Material> parent)
+{
+    std::shared_ptr<Material> instance(new Material());
+    if (!parent)
+        return instance;
+
+    // 实例链只有一层：挂到根材质上，中间实例的覆盖作为新实例的覆盖
+    instance->m_parent = parent->m_parent ? parent->m_parent : parent;
+    const std::shared_ptr<Shader> &shader = instance->shader();
+    instance->m_compiledShader = shader && !shader->isPending() ? shader.get() : nullptr;
+    if (parent->m_parent)
+    {
+        for (const Parameter &parameter : parent->m_parameters)
+        {
+            std::uint32_t words[4] = {};
+            const std::uint32_t wordCount = parameter.type == ParameterType::Color ? 4 : 1;
+            std::memcpy(words, parent->m_parameterData.data() + parameter.offset, wordCount * sizeof(std::uint32_t));
+            instance->setParameter(parameter.name, parameter.type, words);
+        }
+        instance->m_textures = parent->m_textures;
+    }
+    return instance;
+}
+
 void Material::setShader(std::shared_ptr<Shader> shader)
 {
+    if (m_parent)
+    {
+        std::cout << "WARNING::MATERIAL::INSTANCE_USES_PARENT_SHADER" << std::endl;
+        return;
+    }
+
     m_shader = shader;
+    compileParameters();
+    ++m_version;
+    m_revision = RenderRevision::bump();
+}
+
+void Material::compileParameters()
+{
+    const std::shared_ptr<Shader> &shader = this->shader();
+    for (size_t i = 0; i < m_parameters.size(); ++i)
+    {
+        Parameter &parameter = m_parameters[i];
+        parameter.handle = shader ? shader->findUniform(parameter.name) : Shader::kInvalidUniform;
+        parameter.vec3 = parameter.handle != Shader::kInvalidUniform &&
+                         shader->getUniforms()[parameter.handle].type == GL_FLOAT_VEC3;
+        markDirty(i);
+    }
+    // 编译中的程序还没有反射结果，完成后第一次应用时重新编译
+    m_compiledShader = shader && !shader->isPending() ? shader.get() : nullptr;
+    m_appliedShader = nullptr;
+}
+
+void Material::updateInherited()
+{
+    m_inheritedParameters.clear();
+    m_inheritedTextures.clear();
+    m_inheritedValid = true;
+    if (!m_parent)
+        return;
+
+    for (size_t i = 0; i < m_parent->m_parameters.size(); ++i)
+    {
+        if (m_parameterIndex.find(m_parent->m_parameters[i].name) == m_parameterIndex.end())
+        {
+            m_inheritedParameters.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    for (size_t i = 0; i < m_parent->m_textures.size(); ++i)
+    {
+        const std::string &name = m_parent->m_textures[i].name;
+        auto overridden = std::find_if(m_textures.begin(), m_textures.end(),
+                                       [&name](const TextureBinding &binding)
+                                       { return binding.name == name; });
+        if (overridden == m_textures.end())
+        {
+            m_inheritedTextures.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+void Material::setTranslucent(bool translucent)
+{
+    if (m_parent)
+    {
+        std::cout << "WARNING::MATERIAL::INSTANCE_USES_PARENT_TRANSLUCENCY" << std::endl;
+        return;
+    }
+
+    if (m_translucent != translucent)
+    {
+        m_translucent = translucent;
+        m_revision = RenderRevision::bump();
+    }
+}
+
+void Material::setParameter(const std::string &name, ParameterType type, const std::uint32_t (&words)[4])
+{
+    const std::uint32_t wordCount = type == ParameterType::Color ? 4 : 1;
+    const std::shared_ptr<Shader> &shader = this->shader();
+
+    auto it = m_parameterIndex.find(name);
+    if (it == m_parameterIndex.end())
+    {
+        const size_t index = m_parameters.size();
+        Parameter parameter;
+        parameter.name = name;
+        parameter.type = type;
+        parameter.offset = static_cast<std::uint32_t>(m_parameterData.size());
+        parameter.handle = shader ? shader->findUniform(name) : Shader::kInvalidUniform;
+        parameter.vec3 = parameter.handle != Shader::kInvalidUniform &&
+                         shader->getUniforms()[parameter.handle].type == GL_FLOAT_VEC3;
+        m_parameters.push_back(std::move(parameter));
+        m_parameterIndex.emplace(name, index);
+        m_parameterData.insert(m_parameterData.end(), words, words + wordCount);
+        m_dirtyMask.resize((m_parameters.size() + 63) / 64, 0);
+        markDirty(index);
+        m_inheritedValid = false;
+        ++m_version;
+        return;
+    }
+
+    const size_t index = it->second;
+    Parameter &parameter = m_parameters[index];
+    if (parameter.type != type)
+    {
+        // 类型改变后值的大小可能不同，重新分配空间（旧空间不再使用）
+        if (type == ParameterType::Color && parameter.type != ParameterType::Color)
+        {
+            parameter.offset = static_cast<std::uint32_t>(m_parameterData.size());
+            m_parameterData.resize(m_parameterData.size() + wordCount);
+        }
+        parameter.type = type;
+        markDirty(index);
+        ++m_version;
+    }
+
+    std::uint32_t *data = m_parameterData.data() + parameter.offset;
+    if (std::memcmp(data, words, wordCount * sizeof(std::uint32_t)) != 0)
+    {
+        std::memcpy(data, words, wordCount * sizeof(std::uint32_t));
+        markDirty(index);
+        ++m_version;
+    }
 }
 
 void Material::setColor(const std::string &name, float r, float g, float b, float a)
 {
-    m_colorProperties[name] = {r, g, b, a};
+    const float color[4] = {r, g, b, a};
+    std::uint32_t words[4];
+    std::memcpy(words, color, sizeof(color));
+    setParameter(name, ParameterType::Color, words);
 }
 
 void Material::setFloat(const std::string &name, float value)
 {
-    m_floatProperties[name] = value;
+    std::uint32_t words[4] = {};
+    std::memcpy(words, &value, sizeof(value));
+    setParameter(name, ParameterType::Float, words);
 }
 
 void Material::setInt(const std::string &name, int value)
 {
-    m_intProperties[name] = value;
+    const std::uint32_t words[4] = {static_cast<std::uint32_t>(value), 0, 0, 0};
+    setParameter(name, ParameterType::Int, words);
 }
 
 void Material::setBool(const std::string &name, bool value)
 {
-    m_boolProperties[name] = value;
+    const std::uint32_t words[4] = {value ? 1u : 0u, 0, 0, 0};
+    setParameter(name, ParameterType::Bool, words);
 }
 
 void Material::setTexture(const std::string &name, std::shared_ptr<Texture> texture, GLuint unit)
 {
-    m_textureProperties[name] = std::make_pair(texture, unit);
+    auto it = std::find_if(m_textures.begin(), m_textures.end(),
+                           [&name](const TextureBinding &binding)
+                           { return binding.name == name; });
+    if (it != m_textures.end())
+    {
+        it->texture = texture;
+        it->unit = unit;
+    }
+    else
+    {
+        m_textures.push_back({name, texture, unit});
+        m_inheritedValid = false;
+    }
+    ++m_version;
+
+    setInt(name, static_cast<int>(unit));
 }
 
 std::shared_ptr<Texture> Material::getTexture(const std::string &name) const
 {
-    auto it = m_textureProperties.find(name);
-    if (it != m_textureProperties.end())
+    for (const TextureBinding &binding : m_textures)
     {
-        return it->second.first;
+        if (binding.name == name)
+        {
+            return binding.texture;
+        }
     }
-    return nullptr;
+    return m_parent ? m_parent->getTexture(name) : nullptr;
 }
 
-void Material::apply()
+std::size_t Material::getContentHash() const
 {
-    if (!m_shader || !m_shader->isValid())
-        return;
+    std::size_t hash = std::hash<const void *>()(shader().get());
+    hashCombine(hash, std::hash<const void *>()(m_parent.get()));
+    hashCombine(hash, isTranslucent() ? 1 : 0);
+
+    // 参数和纹理的哈希相加，与设置顺序无关
+    std::size_t parameters = 0;
+    for (const Parameter &parameter : m_parameters)
+    {
+        std::size_t value = std::hash<std::string>()(parameter.name);
+        hashCombine(value, static_cast<std::size_t>(parameter.type));
+        const std::uint32_t wordCount = parameter.type == ParameterType::Color ? 4 : 1;
+        for (std::uint32_t i = 0; i < wordCount; ++i)
+        {
+            hashCombine(value, m_parameterData[parameter.offset + i]);
+        }
+        parameters += value;
+    }
+    for (const TextureBinding &binding : m_textures)
+    {
+        std::size_t value = std::hash<std::string>()(binding.name);
+        hashCombine(value, std::hash<const void *>()(binding.texture.get()));
+        hashCombine(value, binding.unit);
+        parameters += value;
+    }
+    hashCombine(hash, parameters);
+    return hash;
+}
+
+bool Material::hasSameContent(const Material &other) const
+{
+    if (shader() != other.shader() || m_parent != other.m_parent || isTranslucent() != other.isTranslucent() ||
+        m_parameters.size() != other.m_parameters.size() || m_textures.size() != other.m_textures.size())
+        return false;
+
+    for (const Parameter &parameter : m_parameters)
+    {
+        auto it = other.m_parameterIndex.find(parameter.name);
+        if (it == other.m_parameterIndex.end())
+            return false;
+
+        const Parameter &otherParameter = other.m_parameters[it->second];
+        const std::uint32_t wordCount = parameter.type == ParameterType::Color ? 4 : 1;
+        if (otherParameter.type != parameter.type ||
+            std::memcmp(m_parameterData.data() + parameter.offset, other.m_parameterData.data() + otherParameter.offset,
+                        wordCount * sizeof(std::uint32_t)) != 0)
+            return false;
+    }
+    for (const TextureBinding &binding : m_textures)
+    {
+        auto it = std::find_if(other.m_textures.begin(), other.m_textures.end(),
+                               [&binding](const TextureBinding &otherBinding)
+                               { return otherBinding.name == binding.name; });
+        if (it == other.m_textures.end() || it->texture != binding.texture || it->unit != binding.unit)
+            return false;
+    }
+    return true;
+}
+
+void Material::uploadParameter(const Parameter &parameter) const
+{
+    const Shader &shader = *this->shader();
+    const std::uint32_t *data = m_parameterData.data() + parameter.offset;
+    switch (parameter.type)
+    {
+    case ParameterType::Float:
+    {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        shader.setFloat(parameter.handle, value);
+        break;
+    }
+    case ParameterType::Int:
+    case ParameterType::Bool:
+        shader.setInt(parameter.handle, static_cast<int>(data[0]));
+        break;
+    case ParameterType::Color:
+    {
+        float color[4];
+        std::memcpy(color, data, sizeof(color));
+        if (parameter.vec3)
+        {
+            shader.setVec3(parameter.handle, color[0], color[1], color[2]);
+        }
+        else
+        {
+            shader.setVec4(parameter.handle, color[0], color[1], color[2], color[3]);
+        }
+        break;
+    }
+    }
+}
 
-    m_shader->use();
+bool Material::apply()
+{
+    PROFILE_ZONE("Material::apply");
 
-    // 应用浮点数属性
-    for (const auto &[name, value] : m_floatProperties)
+    const std::shared_ptr<Shader> &shader = this->shader();
+    if (shader && shader->isPending())
     {
-        m_shader->setFloat(name, value);
+        const std::shared_ptr<Material> &fallback = fallbackMaterial();
+        if (fallback && fallback.get() != this && fallback->isValid() && !fallback->shader()->isPending())
+        {
+            return fallback->apply();
+        }
+        return false;
     }
+    if (!shader || !shader->isValid())
+        return false;
 
-    // 应用整数属性
-    for (const auto &[name, value] : m_intProperties)
+    // 句柄在程序完成编译或父材质更换着色器后重新解析
+    if (m_compiledShader != shader.get())
     {
-        m_shader->setInt(name, value);
+        compileParameters();
+    }
+    if (m_parent && m_parent->m_compiledShader != shader.get())
+    {
+        m_parent->compileParameters();
     }
 
-    // 应用布尔属性
-    for (const auto &[name, value] : m_boolProperties)
+    shader->use();
+
+    // 半透明材质开启 alpha 混合并关闭深度写入，不透明材质恢复默认状态
+    const bool translucent = isTranslucent();
+    GLState::setCapability(GL_BLEND, translucent);
+    if (translucent)
     {
-        m_shader->setBool(name, value);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
+    GLState::depthMask(!translucent);
+
+    // 程序上的值在上次应用后被改写过（其他共享着色器的材质或按名称设置），所有参数都要重新提交
+    bool overwritten = m_appliedShader != shader.get() || m_appliedWrites != shader->getUniformWriteCount();
 
-    // 应用颜色属性
-    for (const auto &[name, color] : m_colorProperties)
+    // 实例先提交没有覆盖的父材质参数，父材质改变过时同样全部重新提交
+    if (m_parent)
     {
-        if (color.size() >= 3)
+        if (m_appliedParentVersion != m_parent->m_version)
         {
-            if (color.size() >= 4)
+            overwritten = true;
+            m_inheritedValid = false;
+        }
+        if (!m_inheritedValid)
+        {
+            updateInherited();
+        }
+        if (overwritten)
+        {
+            for (std::uint32_t index : m_inheritedParameters)
             {
-                m_shader->setVec4(name, color[0], color[1], color[2], color[3]);
+                const Parameter &parameter = m_parent->m_parameters[index];
+                if (parameter.handle != Shader::kInvalidUniform)
+                {
+                    m_parent->uploadParameter(parameter);
+                }
             }
-            else
+        }
+        m_appliedParentVersion = m_parent->m_version;
+    }
+
+    for (size_t word = 0; word < m_dirtyMask.size(); ++word)
+    {
+        std::uint64_t bits = overwritten ? ~std::uint64_t(0) : m_dirtyMask[word];
+        m_dirtyMask[word] = 0;
+        while (bits != 0)
+        {
+            const size_t index = word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+            if (index >= m_parameters.size())
+                break;
+
+            if (m_parameters[index].handle != Shader::kInvalidUniform)
             {
-                m_shader->setVec3(name, color[0], color[1], color[2]);
+                uploadParameter(m_parameters[index]);
             }
         }
     }
+    m_appliedShader = shader.get();
+    m_appliedWrites = shader->getUniformWriteCount();
 
-    // 应用纹理属性
-    for (const auto &[name, textureInfo] : m_textureProperties)
+    // 纹理绑定由 GLState 过滤重复调用，采样器单元作为整数参数已经提交
+    for (const TextureBinding &binding : m_textures)
     {
-        auto texture = textureInfo.first;
-        GLuint unit = textureInfo.second;
-
-        if (texture && texture->isValid())
+        if (binding.texture && binding.texture->isValid())
+        {
+            binding.texture->bind(binding.unit);
+        }
+    }
+    if (m_parent)
+    {
+        for (std::uint32_t index : m_inheritedTextures)
         {
-            texture->bind(unit);
-            m_shader->setInt(name, unit);
+            const TextureBinding &binding = m_parent->m_textures[index];
+            if (binding.texture && binding.texture->isValid())
+            {
+                binding.texture->bind(binding.unit);
+            }
         }
     }
+    return true;
 }
@@ -1,7 +1,8 @@
 #ifndef MATERIAL_H
 #define MATERIAL_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,7 +13,8 @@
 /**
  * @brief 材质类
  *
- * 封装渲染材质属性，包括着色器、纹理、颜色等
+ * 封装渲染材质属性，包括着色器、纹理、颜色等。
+ * 材质实例（见 createInstance）共享父材质的着色器、半透明设置和参数，只保存自己覆盖的参数
  */
 class Material
 {
@@ -30,7 +32,40 @@ public:
     Material &operator=(Material &&other) noexcept;
 
     /**
-     * @brief 设置着色器
+     * @brief 创建材质实例
+     *
+     * 父材质本身是实例时，新实例直接挂在它的父材质上并复制它的覆盖参数，实例链只有一层
+     * @param parent 父材质
+     * @return 材质实例
+     */
+    static std::shared_ptr<Material> createInstance(std::shared_ptr<Material> parent);
+
+    /**
+     * @brief 设置后备材质：着色器仍在编译（Shader::isPending）的材质改为应用后备材质
+     * @param fallback 后备材质，为空时编译期间不应用任何材质
+     */
+    static void setFallback(std::shared_ptr<Material> fallback);
+
+    /**
+     * @brief 获取后备材质
+     * @return 后备材质
+     */
+    static const std::shared_ptr<Material> &getFallback();
+
+    /**
+     * @brief 获取父材质
+     * @return 父材质，不是实例时为空
+     */
+    const std::shared_ptr<Material> &getParent() const { return m_parent; }
+
+    /**
+     * @brief 检查是否为材质实例
+     * @return 是否为实例
+     */
+    bool isInstance() const { return m_parent != nullptr; }
+
+    /**
+     * @brief 设置着色器（实例使用父材质的着色器，调用会被忽略）
      * @param shader 着色器对象
      */
     void setShader(std::shared_ptr<Shader> shader);
@@ -39,7 +74,7 @@ public:
      * @brief 获取着色器
      * @return 着色器对象
      */
-    std::shared_ptr<Shader> getShader() const { return m_shader; }
+    std::shared_ptr<Shader> getShader() const { return shader(); }
 
     /**
      * @brief 设置颜色属性
@@ -89,22 +124,158 @@ public:
 
     /**
      * @brief 应用材质属性到着色器
+     *
+     * 只上传上次应用后改变的参数；着色器上的值被其他材质改写过时全部重新提交（值相同的由着色器跳过）。
+     * 着色器仍在编译时应用后备材质
+     * @return 是否绑定了可用的程序；为 false 时（着色器无效，或仍在编译且没有可用的后备材质）调用方不应绘制
      */
-    void apply();
+    bool apply();
 
     /**
      * @brief 检查材质是否有效
      * @return 是否有效
      */
-    bool isValid() const { return m_shader != nullptr; }
+    bool isValid() const { return shader() != nullptr; }
+
+    /**
+     * @brief 获取着色器程序 ID
+     * @return 程序 ID，没有着色器时为 0
+     */
+    GLuint getProgramId() const { return shader() ? shader()->ID : 0; }
+
+    /**
+     * @brief 检查着色器是否声明了指定的 uniform 块
+     * @param block 块
+     * @return 是否声明
+     */
+    bool usesUniformBlock(UniformBlock block) const { return shader() && shader()->hasUniformBlock(block); }
+
+    /**
+     * @brief 获取材质的排序 ID（创建时顺序分配，用于生成绘制排序键）
+     * @return 排序 ID
+     */
+    std::uint32_t getSortId() const { return m_sortId; }
+
+    /**
+     * @brief 设置是否半透明（半透明材质由远到近绘制；实例跟随父材质，调用会被忽略）
+     * @param translucent 是否半透明
+     */
+    void setTranslucent(bool translucent);
+
+    /**
+     * @brief 检查是否半透明
+     * @return 是否半透明
+     */
+    bool isTranslucent() const { return m_parent ? m_parent->m_translucent : m_translucent; }
+
+    /**
+     * @brief 获取材质自己保存的参数数量（实例为覆盖的参数数量）
+     * @return 参数数量
+     */
+    size_t getParameterCount() const { return m_parameters.size(); }
+
+    /**
+     * @brief 按着色器、父材质、半透明设置、参数和纹理计算内容哈希（与参数设置顺序无关）
+     * @return 哈希值
+     */
+    std::size_t getContentHash() const;
+
+    /**
+     * @brief 检查两个材质的内容是否相同（相同的材质可以互相替换）
+     * @param other 另一个材质
+     * @return 是否相同
+     */
+    bool hasSameContent(const Material &other) const;
+
+    /**
+     * @brief 获取影响录制命令的最近一次修改的修订号（包括父材质和着色器）
+     * @return 修订号（见 RenderRevision）
+     */
+    std::uint64_t getRevision() const;
+
+private:
+    /**
+     * @brief 参数类型
+     */
+    enum class ParameterType : std::uint8_t
+    {
+        Float,
+        Int,
+        Bool,
+        Color
+    };
+
+    /**
+     * @brief 参数在数据块中的位置和它在当前着色器中的 uniform 句柄
+     */
+    struct Parameter
+    {
+        std::string name;
+        ParameterType type;
+        std::uint32_t offset;         // 在 m_parameterData 中的字偏移
+        Shader::UniformHandle handle; // 着色器没有该 uniform 时为 kInvalidUniform
+        bool vec3;                    // 颜色在着色器中声明为 vec3
+    };
+
+    /**
+     * @brief 纹理绑定，采样器的纹理单元作为整数参数保存
+     */
+    struct TextureBinding
+    {
+        std::string name;
+        std::shared_ptr<Texture> texture;
+        GLuint unit;
+    };
+
+    /**
+     * @brief 写入参数值，值变化时标记为脏
+     * @param name 参数名称
+     * @param type 参数类型
+     * @param words 值（按 32 位字，标量只用第一个字）
+     */
+    void setParameter(const std::string &name, ParameterType type, const std::uint32_t (&words)[4]);
+
+    /**
+     * @brief 按当前着色器的反射表编译参数布局：解析句柄并把所有参数标记为脏
+     */
+    void compileParameters();
+
+    /**
+     * @brief 上传一个参数
+     */
+    void uploadParameter(const Parameter &parameter) const;
+
+    /**
+     * @brief 重新收集实例没有覆盖的父材质参数和纹理
+     */
+    void updateInherited();
+
+    /**
+     * @brief 实际使用的着色器（实例为父材质的着色器）
+     */
+    const std::shared_ptr<Shader> &shader() const { return m_parent ? m_parent->m_shader : m_shader; }
+
+    void markDirty(size_t index) { m_dirtyMask[index / 64] |= std::uint64_t(1) << (index % 64); }
 
 private:
     std::shared_ptr<Shader> m_shader;
-    std::unordered_map<std::string, float> m_floatProperties;
-    std::unordered_map<std::string, int> m_intProperties;
-    std::unordered_map<std::string, bool> m_boolProperties;
-    std::unordered_map<std::string, std::vector<float>> m_colorProperties;
-    std::unordered_map<std::string, std::pair<std::shared_ptr<Texture>, GLuint>> m_textureProperties;
+    std::shared_ptr<Material> m_parent;
+    std::uint32_t m_sortId;
+    bool m_translucent;
+    std::vector<Parameter> m_parameters;
+    std::unordered_map<std::string, size_t> m_parameterIndex; // 只在设置参数时查找
+    std::vector<std::uint32_t> m_parameterData;               // 所有参数值连续存放，标量 1 个字，颜色 4 个字
+    std::vector<std::uint64_t> m_dirtyMask;                   // 按参数序号取位，上次应用后改变的参数
+    std::vector<TextureBinding> m_textures;
+    std::uint64_t m_version;              // 参数、纹理或着色器改变时递增
+    std::uint64_t m_revision;             // 着色器或半透明设置最近一次改变的渲染修订号
+    const Shader *m_compiledShader;       // 参数句柄对应的着色器，着色器仍在编译时为空
+    const Shader *m_appliedShader;        // 上次应用时的着色器
+    std::uint64_t m_appliedWrites;        // 上次应用后着色器的 uniform 写入次数
+    std::uint64_t m_appliedParentVersion; // 上次应用时父材质的版本
+    bool m_inheritedValid;
+    std::vector<std::uint32_t> m_inheritedParameters; // 实例没有覆盖的父材质参数序号
+    std::vector<std::uint32_t> m_inheritedTextures;   // 实例没有覆盖的父材质纹理序号
 };
 
 #endif // MATERIAL_H
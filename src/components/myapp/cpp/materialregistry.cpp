@@ -0,0 +1,68 @@
+#include "materialregistry.h"
+#include "profiler.h"
+#include <algorithm>
+
+MaterialRegistry::MaterialRegistry()
+    : m_materialCount(0), m_mergeCount(0)
+{
+}
+
+MaterialRegistry::~MaterialRegistry()
+{
+}
+
+std::shared_ptr<Material> MaterialRegistry::intern(const std::shared_ptr<Material> &material)
+{
+    if (!material)
+        return material;
+
+    std::vector<std::weak_ptr<Material>> &bucket = m_materials[material->getContentHash()];
+    for (const std::weak_ptr<Material> &entry : bucket)
+    {
+        std::shared_ptr<Material> existing = entry.lock();
+        if (existing == material)
+            return material;
+
+        // 哈希相同时还要逐项比较，登记后被修改过的材质在这里被排除
+        if (existing && existing->hasSameContent(*material))
+        {
+            ++m_mergeCount;
+            return existing;
+        }
+    }
+
+    bucket.push_back(material);
+    ++m_materialCount;
+    return material;
+}
+
+void MaterialRegistry::purge()
+{
+    PROFILE_ZONE("MaterialRegistry::purge");
+
+    m_materialCount = 0;
+    for (auto it = m_materials.begin(); it != m_materials.end();)
+    {
+        std::vector<std::weak_ptr<Material>> &bucket = it->second;
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                    [](const std::weak_ptr<Material> &entry)
+                                    { return entry.expired(); }),
+                     bucket.end());
+        if (bucket.empty())
+        {
+            it = m_materials.erase(it);
+        }
+        else
+        {
+            m_materialCount += bucket.size();
+            ++it;
+        }
+    }
+}
+
+void MaterialRegistry::clear()
+{
+    m_materials.clear();
+    m_materialCount = 0;
+    m_mergeCount = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef MATERIALREGISTRY_H
+#define MATERIALREGISTRY_H
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "material.h"
+
+/**
+ * @brief 材质注册表
+ *
+ * 按内容哈希（着色器、父材质、参数和纹理，见 Material::getContentHash）登记材质，
+ * 内容相同的材质合并为同一个对象，使用它们的绘制可以共享材质状态并一起合批。
+ * 注册表只持有弱引用；登记后修改过的材质不会再被匹配，但已经合并的引用不受影响。只在主线程使用
+ */
+class MaterialRegistry
+{
+public:
+    MaterialRegistry();
+    ~MaterialRegistry();
+
+    // 禁用拷贝构造和赋值
+    MaterialRegistry(const MaterialRegistry &) = delete;
+    MaterialRegistry &operator=(const MaterialRegistry &) = delete;
+
+    /**
+     * @brief 登记材质
+     * @param material 材质
+     * @return 已登记的内容相同的材质；没有时登记并返回 material 本身
+     */
+    std::shared_ptr<Material> intern(const std::shared_ptr<Material> &material);
+
+    /**
+     * @brief 移除已经销毁的材质
+     */
+    void purge();
+
+    /**
+     * @brief 清空注册表
+     */
+    void clear();
+
+    /**
+     * @brief 获取登记的材质数量（含已经销毁、尚未移除的）
+     * @return 材质数量
+     */
+    size_t getMaterialCount() const { return m_materialCount; }
+
+    /**
+     * @brief 获取 intern() 返回已有材质的次数
+     * @return 合并次数
+     */
+    size_t getMergeCount() const { return m_mergeCount; }
+
+private:
+    std::unordered_map<std::size_t, std::vector<std::weak_ptr<Material>>> m_materials; // 按内容哈希分组
+    size_t m_materialCount;
+    size_t m_mergeCount;
+};
+
+#endif // MATERIALREGISTRY_H
@@ -1,63 +1,225 @@
 #include "mesh.h"
+#include <algorithm>
+#include "indexformat.h"
+#include "profiler.h"
+#include "rendercommand.h"
+#include "renderrevision.h"
 
 Mesh::Mesh()
     : m_vbo(BufferObject::Type::VertexBuffer),
       m_ebo(BufferObject::Type::ElementBuffer),
-      m_vertexCount(0), m_indexCount(0)
+      m_vertexCount(0), m_vertexSize(0), m_indexCount(0), m_indexType(0), m_keepGeometry(false),
+      m_quantized(false), m_dequantizeScale{1.0f, 1.0f, 1.0f}, m_dequantizeOffset{0.0f, 0.0f, 0.0f}, m_revision(0)
 {
 }
 
 Mesh::~Mesh()
 {
+    releaseIndices();
 }
 
 Mesh::Mesh(Mesh &&other) noexcept
     : m_vao(std::move(other.m_vao)),
       m_vbo(std::move(other.m_vbo)),
       m_ebo(std::move(other.m_ebo)),
+      m_extraStreams(std::move(other.m_extraStreams)),
+      m_layout(std::move(other.m_layout)),
       m_material(std::move(other.m_material)),
+      m_instanceLayout(std::move(other.m_instanceLayout)),
+      m_vertexData(std::move(other.m_vertexData)),
+      m_indexData(std::move(other.m_indexData)),
       m_vertexCount(other.m_vertexCount),
-      m_indexCount(other.m_indexCount)
+      m_vertexSize(other.m_vertexSize),
+      m_indexCount(other.m_indexCount),
+      m_indexType(other.m_indexType),
+      m_keepGeometry(other.m_keepGeometry),
+      m_quantized(other.m_quantized),
+      m_revision(other.m_revision)
 {
+    std::copy(other.m_dequantizeScale, other.m_dequantizeScale + 3, m_dequantizeScale);
+    std::copy(other.m_dequantizeOffset, other.m_dequantizeOffset + 3, m_dequantizeOffset);
     other.m_vertexCount = 0;
+    other.m_vertexSize = 0;
     other.m_indexCount = 0;
+    other.m_indexType = 0;
 }
 
 Mesh &Mesh::operator=(Mesh &&other) noexcept
 {
     if (this != &other)
     {
+        releaseIndices();
         m_vao = std::move(other.m_vao);
         m_vbo = std::move(other.m_vbo);
         m_ebo = std::move(other.m_ebo);
+        m_extraStreams = std::move(other.m_extraStreams);
+        m_layout = std::move(other.m_layout);
         m_material = std::move(other.m_material);
+        m_instanceLayout = std::move(other.m_instanceLayout);
+        m_vertexData = std::move(other.m_vertexData);
+        m_indexData = std::move(other.m_indexData);
         m_vertexCount = other.m_vertexCount;
+        m_vertexSize = other.m_vertexSize;
         m_indexCount = other.m_indexCount;
+        m_indexType = other.m_indexType;
+        m_keepGeometry = other.m_keepGeometry;
+        m_quantized = other.m_quantized;
+        std::copy(other.m_dequantizeScale, other.m_dequantizeScale + 3, m_dequantizeScale);
+        std::copy(other.m_dequantizeOffset, other.m_dequantizeOffset + 3, m_dequantizeOffset);
+        m_revision = RenderRevision::bump();
 
         other.m_vertexCount = 0;
+        other.m_vertexSize = 0;
         other.m_indexCount = 0;
+        other.m_indexType = 0;
     }
     return *this;
 }
 
+void Mesh::releaseGeometry()
+{
+    std::vector<float>().swap(m_vertexData);
+    std::vector<unsigned int>().swap(m_indexData);
+}
+
 void Mesh::setVertices(const float *vertices, GLsizei vertexCount, GLsizei vertexSize)
 {
+    if (vertexSize == static_cast<GLsizei>(3 * sizeof(float)))
+    {
+        setVertices(VertexLayout::position(), vertices, vertexCount);
+        return;
+    }
+    // 顶点带有其他数据时只使用开头的位置
+    setVertices(VertexLayout::share(VertexLayout().add(VertexSemantic::Position, 3, GL_FLOAT).setStride(0, vertexSize)),
+                vertices, vertexCount);
+}
+
+void Mesh::setVertices(std::shared_ptr<const VertexLayout> layout, const void *const *streams, GLsizei vertexCount)
+{
+    if (!layout || layout->getStreamCount() == 0)
+        return;
+
+    m_layout = std::move(layout);
+    m_quantized = false;
     m_vertexCount = vertexCount;
+    m_vertexSize = m_layout->getStride(0);
+    if (m_keepGeometry && m_layout == VertexLayout::position())
+    {
+        const float *positions = static_cast<const float *>(streams[0]);
+        m_vertexData.assign(positions, positions + static_cast<size_t>(vertexCount) * 3);
+    }
+    else
+    {
+        m_vertexData.clear();
+    }
 
     // 配置VAO
     m_vao.bind();
 
-    // 绑定VBO到VAO
-    m_vao.bindVertexBuffer(m_vbo);
-
-    // 设置顶点缓冲数据
-    m_vbo.setData(vertices, vertexCount * vertexSize, BufferObject::Usage::StaticDraw);
+    // 每个流一个缓冲，第一个流使用 m_vbo
+    const GLuint streamCount = m_layout->getStreamCount();
+    m_extraStreams.clear();
+    for (GLuint stream = 1; stream < streamCount; ++stream)
+    {
+        m_extraStreams.emplace_back(BufferObject::Type::VertexBuffer);
+    }
+    std::vector<GLuint> buffers(streamCount);
+    for (GLuint stream = 0; stream < streamCount; ++stream)
+    {
+        BufferObject &buffer = stream == 0 ? m_vbo : m_extraStreams[stream - 1];
+        m_vao.bindVertexBuffer(buffer);
+        buffer.setData(streams[stream], static_cast<GLsizeiptr>(vertexCount) * m_layout->getStride(stream),
+                       BufferObject::Usage::StaticDraw);
+        buffers[stream] = buffer.getId();
+    }
 
-    // 配置顶点属性指针
-    m_vao.setVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-    m_vao.enableVertexAttribArray(0);
+    // 按布局配置顶点属性指针
+    m_vao.setVertexLayout(*m_layout, buffers.data());
 
     m_vao.unbind();
+    m_revision = RenderRevision::bump();
+}
+
+void Mesh::setVertices(const QuantizedVertices &vertices)
+{
+    setVertices(vertices.layout, vertices.data.data(), vertices.vertexCount);
+    m_quantized = true;
+    std::copy(vertices.scale, vertices.scale + 3, m_dequantizeScale);
+    std::copy(vertices.offset, vertices.offset + 3, m_dequantizeOffset);
+}
+
+void Mesh::applyDequantization(float model[16]) const
+{
+    if (!m_quantized)
+        return;
+
+    // D = T(offset) * S(scale)：平移列先按原矩阵变换，再缩放前三列
+    for (int row = 0; row < 3; ++row)
+    {
+        model[12 + row] += model[row] * m_dequantizeOffset[0] + model[4 + row] * m_dequantizeOffset[1] +
+                           model[8 + row] * m_dequantizeOffset[2];
+    }
+    for (int column = 0; column < 3; ++column)
+    {
+        for (int row = 0; row < 4; ++row)
+        {
+            model[column * 4 + row] *= m_dequantizeScale[column];
+        }
+    }
+}
+
+DrawCommand &Mesh::recordDraw(RenderCommandQueue &commandQueue, float depth) const
+{
+    Material *material = m_material.get();
+    GLuint vertexArray = m_vao.getId();
+    std::uint64_t sortKey = material->isTranslucent()
+                                ? DrawKey::translucent(material->getProgramId(), material->getSortId(), vertexArray, depth)
+                                : DrawKey::opaque(material->getProgramId(), material->getSortId(), vertexArray, depth);
+
+    DrawCommand &command = commandQueue.addDraw(sortKey);
+    command.material = material;
+    command.vertexArray = vertexArray;
+    command.mode = GL_TRIANGLES;
+    command.first = 0;
+    if (m_indexCount > 0)
+    {
+        command.count = m_indexCount;
+        command.indexType = m_indexType;
+    }
+    else
+    {
+        command.count = m_vertexCount;
+        command.indexType = 0;
+    }
+    command.indexOffset = 0;
+    command.instanceLayout = nullptr;
+    command.uniformSlot = DrawCommand::kNoUniformSlot;
+    return command;
+}
+
+void Mesh::recordCommands(RenderCommandQueue &commandQueue, float depth, std::uint32_t uniformSlot) const
+{
+    if (!isValid() || !m_material || isInstanced())
+        return;
+
+    DrawCommand &command = recordDraw(commandQueue, depth);
+    if (m_material->usesUniformBlock(UniformBlock::Object))
+    {
+        command.uniformSlot = uniformSlot;
+    }
+}
+
+void Mesh::recordInstancedCommands(RenderCommandQueue &commandQueue, float depth, GLuint instanceBuffer,
+                                   std::uintptr_t instanceOffset, GLsizei instanceCount) const
+{
+    if (!isValid() || !m_material || !isInstanced() || instanceCount <= 0)
+        return;
+
+    DrawCommand &command = recordDraw(commandQueue, depth);
+    command.instanceLayout = m_instanceLayout.get();
+    command.instanceBuffer = instanceBuffer;
+    command.instanceCount = instanceCount;
+    command.instanceOffset = instanceOffset;
 }
 
 void Mesh::initialize()
@@ -69,29 +231,89 @@ void Mesh::initialize()
 
 void Mesh::setIndices(const unsigned int *indices, GLsizei indexCount)
 {
-    m_indexCount = indexCount;
+    uploadIndices(indices, static_cast<size_t>(indexCount));
+}
 
-    // 设置元素缓冲数据
-    m_ebo.setData(indices, indexCount * sizeof(unsigned int), BufferObject::Usage::StaticDraw);
+void Mesh::setIndices(const unsigned short *indices, GLsizei indexCount)
+{
+    uploadIndices(indices, static_cast<size_t>(indexCount));
+}
 
-    // 绑定EBO到VAO
+void Mesh::setIndices(const unsigned char *indices, GLsizei indexCount)
+{
+    uploadIndices(indices, static_cast<size_t>(indexCount));
+}
+
+template <typename Index>
+void Mesh::uploadIndices(const Index *indices, size_t indexCount)
+{
+    // 静态合批按 32 位索引重新编号，只有它需要 CPU 副本
+    if (m_keepGeometry)
+    {
+        m_indexData.assign(indices, indices + indexCount);
+    }
+    else
+    {
+        m_indexData.clear();
+    }
+
+    releaseIndices();
+    m_indexCount = static_cast<GLsizei>(indexCount);
+
+    std::vector<std::uint8_t> data;
+    m_indexType = IndexFormat::pack(indices, indexCount, data);
+    IndexFormat::addBuffer(m_indexType, indexCount);
+
+    // 索引缓冲绑定属于 VAO 状态，先绑定自己的 VAO，避免改动当前绑定的其他 VAO
     m_vao.bind();
+
+    // 设置元素缓冲数据并绑定EBO到VAO；不需要转换宽度时 data 为空，直接上传输入
+    const GLsizeiptr bytes = static_cast<GLsizeiptr>(indexCount * IndexFormat::size(m_indexType));
+    m_ebo.setData(data.empty() ? static_cast<const void *>(indices) : data.data(), bytes,
+                  BufferObject::Usage::StaticDraw);
     m_vao.bindElementBuffer(m_ebo);
     m_vao.unbind();
+    m_revision = RenderRevision::bump();
+}
+
+void Mesh::releaseIndices()
+{
+    if (m_indexType != 0)
+    {
+        IndexFormat::removeBuffer(m_indexType, static_cast<size_t>(m_indexCount));
+        m_indexType = 0;
+    }
+}
+
+std::uint64_t Mesh::getRevision() const
+{
+    return m_material ? std::max(m_revision, m_material->getRevision()) : m_revision;
 }
 
 void Mesh::setMaterial(std::shared_ptr<Material> material)
 {
     m_material = material;
+    m_revision = RenderRevision::bump();
+}
+
+void Mesh::setInstanceLayout(const InstanceLayout &layout)
+{
+    m_instanceLayout = std::make_unique<InstanceLayout>(layout);
+    m_vao.setInstanceLayout(layout);
+    m_vao.unbind();
+    m_revision = RenderRevision::bump();
 }
 
 void Mesh::render()
 {
-    if (!isValid() || !m_material)
+    PROFILE_ZONE("Mesh::render");
+
+    if (!isValid() || !m_material || isInstanced())
         return;
 
-    // 应用材质
-    m_material->apply();
+    // 应用材质，没有可用的程序时不绘制
+    if (!m_material->apply())
+        return;
 
     // 绑定VAO并渲染
     m_vao.bind();
@@ -101,7 +323,7 @@ void Mesh::render()
     {
         // 使用索引绘制
         // std::cout << "Using indexed drawing." << std::endl;
-        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, m_indexCount, m_indexType, 0);
     }
     else
     {
@@ -110,5 +332,5 @@ void Mesh::render()
         glDrawArrays(GL_TRIANGLES, 0, m_vertexCount);
     }
 
-    m_vao.unbind();
+    // 不再解绑 VAO：下一个网格直接绑定自己的 VAO，相同的 VAO 由 GLState 省略
 }
@@ -1,12 +1,16 @@
 #ifndef MESH_H
 #define MESH_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
 #include <vector>
 #include <memory>
 #include "vertexarrayobject.h"
 #include "bufferobject.h"
 #include "material.h"
+#include "instancing.h"
+#include "vertexlayout.h"
+#include "vertexquantizer.h"
+#include "rendercommand.h"
 
 /**
  * @brief 网格类
@@ -28,19 +32,81 @@ public:
     Mesh &operator=(Mesh &&other) noexcept;
 
     /**
-     * @brief 设置顶点数据
+     * @brief 设置是否保留顶点和索引的 CPU 副本，供静态合批预变换顶点时读取
+     *
+     * 默认不保留，数据上传后即释放。静态对象的网格需要在 setVertices()/setIndices() 之前开启，
+     * Scene::buildStaticBatches() 合批后会调用 releaseGeometry() 释放副本
+     * @param keep 是否保留
+     */
+    void setKeepGeometry(bool keep) { m_keepGeometry = keep; }
+
+    /**
+     * @brief 检查是否保留 CPU 副本
+     * @return 是否保留
+     */
+    bool getKeepGeometry() const { return m_keepGeometry; }
+
+    /**
+     * @brief 释放顶点和索引的 CPU 副本，之后网格不能再参与静态合批
+     */
+    void releaseGeometry();
+
+    /**
+     * @brief 设置只有位置的顶点数据（每个顶点开头 3 个 float 的位置）
      * @param vertices 顶点数据
      * @param vertexCount 顶点数量
      * @param vertexSize 每个顶点的大小（字节）
      */
     void setVertices(const float *vertices, GLsizei vertexCount, GLsizei vertexSize);
 
+    /**
+     * @brief 按顶点布局设置顶点数据，每个流上传到一个缓冲
+     * @param layout 共享的顶点布局（见 VertexLayout::share()）
+     * @param streams 每个流的数据，数量为 layout->getStreamCount()
+     * @param vertexCount 顶点数量
+     */
+    void setVertices(std::shared_ptr<const VertexLayout> layout, const void *const *streams, GLsizei vertexCount);
+
+    /**
+     * @brief 按单流顶点布局设置交错的顶点数据
+     * @param layout 共享的顶点布局
+     * @param vertices 顶点数据
+     * @param vertexCount 顶点数量
+     */
+    void setVertices(std::shared_ptr<const VertexLayout> layout, const void *vertices, GLsizei vertexCount)
+    {
+        setVertices(std::move(layout), &vertices, vertexCount);
+    }
+
+    /**
+     * @brief 设置量化后的顶点数据（见 VertexQuantizer），记录位置的反量化变换
+     * @param vertices 量化结果
+     */
+    void setVertices(const QuantizedVertices &vertices);
+
+    /**
+     * @brief 检查顶点位置是否经过量化
+     * @return 是否量化
+     */
+    bool isQuantized() const { return m_quantized; }
+
+    /**
+     * @brief 把位置的反量化变换右乘到模型矩阵上（model = model * D），非量化网格不做修改
+     * @param model 模型矩阵（列主序）
+     */
+    void applyDequantization(float model[16]) const;
+
     /**
      * @brief 设置索引数据
+     *
+     * 输入可以是任意宽度，上传时按最大索引值选择最窄的索引类型（见 IndexFormat），
+     * 绘制和录制的命令使用选择的类型
      * @param indices 索引数据
      * @param indexCount 索引数量
      */
     void setIndices(const unsigned int *indices, GLsizei indexCount);
+    void setIndices(const unsigned short *indices, GLsizei indexCount);
+    void setIndices(const unsigned char *indices, GLsizei indexCount);
 
     /**
      * @brief 设置材质
@@ -55,10 +121,53 @@ public:
     std::shared_ptr<Material> getMaterial() const { return m_material; }
 
     /**
-     * @brief 渲染网格
+     * @brief 声明实例属性布局，之后该网格只通过实例化绘制
+     *
+     * RenderPass 把引用同一网格（因而同一材质）的游戏对象合并为一次实例化绘制，
+     * 每个对象的模型矩阵、颜色和自定义参数打包为一个 InstanceData
+     * @param layout 实例属性布局
+     */
+    void setInstanceLayout(const InstanceLayout &layout);
+
+    /**
+     * @brief 检查网格是否使用实例化绘制
+     * @return 是否声明了实例属性布局
+     */
+    bool isInstanced() const { return m_instanceLayout != nullptr; }
+
+    /**
+     * @brief 获取实例属性布局
+     * @return 布局，非实例化网格为 nullptr
+     */
+    const InstanceLayout *getInstanceLayout() const { return m_instanceLayout.get(); }
+
+    /**
+     * @brief 渲染网格（实例化网格没有逐对象的实例数据，不在这里绘制）
      */
     void render();
 
+    /**
+     * @brief 录制可排序的绘制命令（与 render() 等价，但不立即调用 GL，也不解绑 VAO）
+     *
+     * 实例化网格由 RenderPass 合批后通过 recordInstancedCommands() 录制，这里忽略
+     * @param commandQueue 命令队列
+     * @param depth 归一化视图深度，0 为最近，用于排序
+     * @param uniformSlot 所属对象的 ObjectBlock 槽位，材质的着色器没有声明 ObjectBlock 时忽略
+     */
+    void recordCommands(RenderCommandQueue &commandQueue, float depth,
+                        std::uint32_t uniformSlot = DrawCommand::kNoUniformSlot) const;
+
+    /**
+     * @brief 录制实例化绘制命令
+     * @param commandQueue 命令队列
+     * @param depth 用于排序的归一化视图深度
+     * @param instanceBuffer 实例缓冲区
+     * @param instanceOffset 第一个实例的字节偏移
+     * @param instanceCount 实例数量
+     */
+    void recordInstancedCommands(RenderCommandQueue &commandQueue, float depth, GLuint instanceBuffer,
+                                 std::uintptr_t instanceOffset, GLsizei instanceCount) const;
+
     /**
      * @brief 检查网格是否有效
      * @return 是否有效
@@ -77,18 +186,87 @@ public:
      */
     GLsizei getIndexCount() const { return m_indexCount; }
 
+    /**
+     * @brief 获取索引缓冲使用的索引类型
+     * @return GL_UNSIGNED_BYTE、GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT，非索引网格为 0
+     */
+    GLenum getIndexType() const { return m_indexType; }
+
+    /**
+     * @brief 获取顶点布局
+     * @return 共享的布局，没有顶点数据时为 nullptr
+     */
+    const std::shared_ptr<const VertexLayout> &getVertexLayout() const { return m_layout; }
+
+    /**
+     * @brief 获取顶点数据的 CPU 副本（静态合批时预变换顶点使用）
+     * @return 顶点数据，只有开启 setKeepGeometry() 且使用 VertexLayout::position() 布局的网格保留
+     */
+    const std::vector<float> &getVertexData() const { return m_vertexData; }
+
+    /**
+     * @brief 获取每个顶点的大小
+     * @return 第一个流的步长（字节）
+     */
+    GLsizei getVertexSize() const { return m_vertexSize; }
+
+    /**
+     * @brief 获取索引数据的 CPU 副本
+     * @return 索引数据，非索引网格或没有开启 setKeepGeometry() 时为空
+     */
+    const std::vector<unsigned int> &getIndexData() const { return m_indexData; }
+
+    /**
+     * @brief 获取影响录制命令的最近一次修改的修订号（包括材质和着色器）
+     * @return 修订号（见 RenderRevision）
+     */
+    std::uint64_t getRevision() const;
+
     /**
      * @brief 初始化网格
      */
     void initialize();
 
+private:
+    /**
+     * @brief 分配绘制命令并填写几何和状态字段
+     */
+    DrawCommand &recordDraw(RenderCommandQueue &commandQueue, float depth) const;
+
+    /**
+     * @brief 保存索引副本（只在 m_keepGeometry 时），选择最窄的索引类型并上传索引缓冲
+     *
+     * 输入已经是选择的宽度时直接上传，不经过中间缓冲
+     * @param indices 索引数据
+     * @param indexCount 索引数量
+     */
+    template <typename Index>
+    void uploadIndices(const Index *indices, size_t indexCount);
+
+    /**
+     * @brief 从索引统计中移除当前的索引缓冲
+     */
+    void releaseIndices();
+
 private:
     VertexArrayObject m_vao;
     BufferObject m_vbo;
     BufferObject m_ebo;
+    std::vector<BufferObject> m_extraStreams; // 第二个及之后的顶点流
+    std::shared_ptr<const VertexLayout> m_layout;
     std::shared_ptr<Material> m_material;
+    std::unique_ptr<InstanceLayout> m_instanceLayout; // 地址稳定，绘制命令直接引用
+    std::vector<float> m_vertexData;       // 只在 m_keepGeometry 时保留
+    std::vector<unsigned int> m_indexData; // 只在 m_keepGeometry 时保留
     GLsizei m_vertexCount;
+    GLsizei m_vertexSize;
     GLsizei m_indexCount;
+    GLenum m_indexType; // 0 表示没有索引缓冲
+    bool m_keepGeometry;
+    bool m_quantized;
+    float m_dequantizeScale[3];  // 反量化缩放
+    float m_dequantizeOffset[3]; // 反量化偏移
+    std::uint64_t m_revision;    // 网格自身最近一次修改的修订号
 };
 
 #endif // MESH_H
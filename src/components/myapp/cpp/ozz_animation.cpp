@@ -1,10 +1,13 @@
 #include "ozz_animation.h"
+#include "profiler.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
 
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #include <emscripten/html5.h>
+#endif
 
 // 使用相对路径包含 ozz-animation 头文件
 #include "../thirdParty/ozz-animation/include/ozz/animation/runtime/animation.h"
@@ -77,7 +80,42 @@ bool OzzAnimation::LoadSkeleton(const std::string &filePath)
     }
 
     archive >> skeleton_;
+    AllocateRuntimeBuffers();
+
+    std::cout << "Skeleton loaded successfully: " << skeleton_.num_joints() << " joints" << std::endl;
+    return true;
+}
 
+bool OzzAnimation::LoadSkeletonFromMemory(const char *data, size_t size)
+{
+    if (!data || size == 0)
+    {
+        std::cerr << "Invalid skeleton data: null pointer or zero size" << std::endl;
+        return false;
+    }
+
+    // 创建内存流
+    ozz::io::MemoryStream stream;
+    stream.Write(data, size);
+    stream.Seek(0, ozz::io::Stream::kSet);
+
+    // 加载骨架
+    ozz::io::IArchive archive(&stream);
+    if (!archive.TestTag<ozz::animation::Skeleton>())
+    {
+        std::cerr << "Failed to load skeleton from memory" << std::endl;
+        return false;
+    }
+
+    archive >> skeleton_;
+    AllocateRuntimeBuffers();
+
+    std::cout << "Skeleton loaded from memory successfully: " << skeleton_.num_joints() << " joints" << std::endl;
+    return true;
+}
+
+void OzzAnimation::AllocateRuntimeBuffers()
+{
     // 初始化本地变换和模型矩阵
     const int num_joints = skeleton_.num_joints();
     const int num_soa_joints = skeleton_.num_soa_joints();
@@ -89,9 +127,6 @@ bool OzzAnimation::LoadSkeleton(const std::string &filePath)
     }
     blended_locals_.resize(num_soa_joints);
     models_.resize(num_joints);
-
-    std::cout << "Skeleton loaded successfully: " << num_joints << " joints" << std::endl;
-    return true;
 }
 
 bool OzzAnimation::LoadAnimation(const std::string &filePath, int index)
@@ -166,6 +201,8 @@ void OzzAnimation::Update(float deltaTime)
         return;
     }
 
+    PROFILE_ZONE("OzzAnimation::Update");
+
     // 更新播放控制器
     for (int i = 0; i < 3; ++i)
     {
@@ -183,6 +220,7 @@ void OzzAnimation::Update(float deltaTime)
     {
         if (animations_[i].duration() > 0.f)
         {
+            PROFILE_ZONE("ozz::SamplingJob");
             SamplingJob sampling_job;
             sampling_job.animation = &animations_[i];
             sampling_job.context = &contexts_[i];
@@ -196,36 +234,67 @@ void OzzAnimation::Update(float deltaTime)
     }
 
     // 混合动画
-    BlendingJob blend_job;
-    blend_job.threshold = threshold_;
-
-    // 设置混合层
-    BlendingJob::Layer layers[3];
-    for (int i = 0; i < 3; ++i)
     {
-        layers[i].transform = make_span(locals_[i]);
-        layers[i].weight = weights_[i];
-    }
-    blend_job.layers = layers;
-    blend_job.rest_pose = skeleton_.joint_rest_poses();
-    blend_job.output = make_span(blended_locals_);
+        PROFILE_ZONE("ozz::BlendingJob");
+        BlendingJob blend_job;
+        blend_job.threshold = threshold_;
 
-    if (!blend_job.Run())
-    {
-        std::cerr << "Failed to blend animations" << std::endl;
+        // 设置混合层
+        BlendingJob::Layer layers[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            layers[i].transform = make_span(locals_[i]);
+            layers[i].weight = weights_[i];
+        }
+        blend_job.layers = layers;
+        blend_job.rest_pose = skeleton_.joint_rest_poses();
+        blend_job.output = make_span(blended_locals_);
+
+        if (!blend_job.Run())
+        {
+            std::cerr << "Failed to blend animations" << std::endl;
+        }
     }
 
     // 转换为模型空间矩阵
-    LocalToModelJob ltm_job;
-    ltm_job.skeleton = &skeleton_;
-    ltm_job.input = make_span(blended_locals_);
-    ltm_job.output = make_span(models_);
-    if (!ltm_job.Run())
     {
-        std::cerr << "Failed to convert local to model space" << std::endl;
+        PROFILE_ZONE("ozz::LocalToModelJob");
+        LocalToModelJob ltm_job;
+        ltm_job.skeleton = &skeleton_;
+        ltm_job.input = make_span(blended_locals_);
+        ltm_job.output = make_span(models_);
+        if (!ltm_job.Run())
+        {
+            std::cerr << "Failed to convert local to model space" << std::endl;
+        }
     }
 }
 
+void OzzAnimation::UpdateInstances(OzzAnimation *const *instances, size_t count, float deltaTime)
+{
+    TaskScheduler::instance().parallelFor(count, 1,
+                                          [instances, deltaTime](size_t begin, size_t end)
+                                          {
+                                              for (size_t i = begin; i < end; ++i)
+                                              {
+                                                  instances[i]->Update(deltaTime);
+                                              }
+                                          });
+}
+
+Job *OzzAnimation::CreateUpdateJob(OzzAnimation *const *instances, size_t count, float deltaTime, Job *parent)
+{
+    return TaskScheduler::instance().createParallelForJob(count, 1,
+                                                          [instances, deltaTime](size_t begin, size_t end)
+                                                          {
+                                                              for (size_t i = begin; i < end; ++i)
+                                                              {
+                                                                  instances[i]->Update(deltaTime);
+                                                              }
+                                                          },
+                                                          parent);
+}
+
 void OzzAnimation::UpdateRuntimeParameters(float blend_ratio, float weights[3])
 {
     // 从 sample_blend.cc 复制的逻辑
@@ -317,6 +386,15 @@ extern "C"
         static_cast<OzzAnimation *>(animation)->Update(deltaTime);
     }
 
+    void ozz_animation_update_many(void **animations, int count, float deltaTime)
+    {
+        if (!animations || count <= 0)
+        {
+            return;
+        }
+        OzzAnimation::UpdateInstances(reinterpret_cast<OzzAnimation *const *>(animations), static_cast<size_t>(count), deltaTime);
+    }
+
     void ozz_animation_set_blend_ratio(void *animation, float ratio)
     {
         static_cast<OzzAnimation *>(animation)->SetBlendRatio(ratio);
@@ -395,6 +473,13 @@ extern "C"
         ozz_animation_update(animation, deltaTime);
     }
 
+    // 并行更新多个动画实例（animations 为实例指针数组）
+    EMSCRIPTEN_KEEPALIVE
+    void update_ozz_animations(void **animations, int count, float deltaTime)
+    {
+        ozz_animation_update_many(animations, count, deltaTime);
+    }
+
     // 设置混合比例
     EMSCRIPTEN_KEEPALIVE
     void set_blend_ratio(void *animation, float ratio)
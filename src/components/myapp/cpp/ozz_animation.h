@@ -18,6 +18,8 @@
 #include "ozz/base/io/archive.h"
 #include "ozz/base/containers/vector.h"
 
+#include "taskscheduler.h"
+
 // PlaybackController 类的实现
 class PlaybackController
 {
@@ -86,12 +88,19 @@ public:
 
     // 加载骨架和动画
     bool LoadSkeleton(const std::string &filePath);
+    bool LoadSkeletonFromMemory(const char *data, size_t size);
     bool LoadAnimation(const std::string &filePath, int index);
     bool LoadAnimationFromMemory(const char *data, size_t size, int index);
 
     // 更新动画
     void Update(float deltaTime);
 
+    // 并行更新多个动画实例，每个实例一个作业
+    static void UpdateInstances(OzzAnimation *const *instances, size_t count, float deltaTime);
+
+    // 创建多实例更新作业（尚未提交），可与其他帧作业组成依赖图；instances 在作业完成前必须有效
+    static Job *CreateUpdateJob(OzzAnimation *const *instances, size_t count, float deltaTime, Job *parent = nullptr);
+
     // 获取变换矩阵
     const std::vector<ozz::math::Float4x4> &GetModelMatrices() const { return models_; }
 
@@ -107,6 +116,9 @@ private:
     // 从 sample_blend.cc 复制的函数，用于更新运行时参数
     void UpdateRuntimeParameters(float blend_ratio, float weights[3]);
 
+    // 根据骨架分配采样/混合/模型矩阵缓冲
+    void AllocateRuntimeBuffers();
+
 private:
     ozz::animation::Skeleton skeleton_;
     ozz::animation::Animation animations_[3];
@@ -143,6 +155,7 @@ extern "C"
 
     // 更新
     void ozz_animation_update(void *animation, float deltaTime);
+    void ozz_animation_update_many(void **animations, int count, float deltaTime);
 
     // 设置参数
     void ozz_animation_set_blend_ratio(void *animation, float ratio);
@@ -0,0 +1,265 @@
+#include "ozz_benchmark.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/io/archive.h"
+
+using namespace ozz;
+using namespace ozz::animation;
+using namespace ozz::math;
+
+namespace
+{
+    template <typename T>
+    std::vector<char> Serialize(const T &object)
+    {
+        io::MemoryStream stream;
+        io::OArchive archive(&stream);
+        archive << object;
+
+        std::vector<char> bytes(static_cast<size_t>(stream.Size()));
+        stream.Seek(0, io::Stream::kSet);
+        stream.Read(bytes.data(), bytes.size());
+        return bytes;
+    }
+
+    template <typename T>
+    bool Deserialize(const std::vector<char> &bytes, T &object)
+    {
+        io::MemoryStream stream;
+        stream.Write(bytes.data(), bytes.size());
+        stream.Seek(0, io::Stream::kSet);
+
+        io::IArchive archive(&stream);
+        if (!archive.TestTag<T>())
+        {
+            return false;
+        }
+        archive >> object;
+        return true;
+    }
+}
+
+OzzBenchmark::OzzBenchmark(int numJoints, int numKeys)
+    : time_ratio_(0.f), valid_(false)
+{
+    if (numJoints <= 0 || numJoints > Skeleton::kMaxJoints || numKeys < 2)
+    {
+        std::cerr << "Invalid benchmark parameters: joints=" << numJoints << " keys=" << numKeys << std::endl;
+        return;
+    }
+
+    if (!Deserialize(BuildSkeletonData(numJoints), skeleton_) ||
+        !Deserialize(BuildAnimationData(numJoints, numKeys), animation_))
+    {
+        std::cerr << "Failed to build benchmark skeleton/animation" << std::endl;
+        return;
+    }
+
+    const int num_soa_joints = skeleton_.num_soa_joints();
+    context_.Resize(skeleton_.num_joints());
+    for (int i = 0; i < 3; ++i)
+    {
+        locals_[i].resize(num_soa_joints);
+    }
+    blended_locals_.resize(num_soa_joints);
+    models_.resize(skeleton_.num_joints());
+
+    // 预先采样一次，使混合和模型空间转换有有效输入，其余两层复用同一姿势
+    if (!RunSampling())
+    {
+        return;
+    }
+    locals_[1] = locals_[0];
+    locals_[2] = locals_[0];
+    valid_ = RunBlending();
+}
+
+OzzBenchmark::~OzzBenchmark()
+{
+}
+
+double OzzBenchmark::Run(Stage stage, int iterations)
+{
+    if (!valid_ || iterations <= 0)
+    {
+        return -1.0;
+    }
+
+    bool success = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations && success; ++i)
+    {
+        switch (stage)
+        {
+        case kSampling:
+            success = RunSampling();
+            break;
+        case kBlending:
+            success = RunBlending();
+            break;
+        case kLocalToModel:
+            success = RunLocalToModel();
+            break;
+        default:
+            success = false;
+            break;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (!success)
+    {
+        return -1.0;
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+bool OzzBenchmark::RunSampling()
+{
+    // 每次推进时间，避免命中采样上下文的缓存快速路径
+    time_ratio_ += 0.013f;
+    if (time_ratio_ > 1.f)
+    {
+        time_ratio_ -= 1.f;
+    }
+
+    SamplingJob sampling_job;
+    sampling_job.animation = &animation_;
+    sampling_job.context = &context_;
+    sampling_job.ratio = time_ratio_;
+    sampling_job.output = make_span(locals_[0]);
+    return sampling_job.Run();
+}
+
+bool OzzBenchmark::RunBlending()
+{
+    BlendingJob::Layer layers[3];
+    const float weights[3] = {0.5f, 0.3f, 0.2f};
+    for (int i = 0; i < 3; ++i)
+    {
+        layers[i].transform = make_span(locals_[i]);
+        layers[i].weight = weights[i];
+    }
+
+    BlendingJob blend_job;
+    blend_job.threshold = .1f;
+    blend_job.layers = layers;
+    blend_job.rest_pose = skeleton_.joint_rest_poses();
+    blend_job.output = make_span(blended_locals_);
+    return blend_job.Run();
+}
+
+bool OzzBenchmark::RunLocalToModel()
+{
+    LocalToModelJob ltm_job;
+    ltm_job.skeleton = &skeleton_;
+    ltm_job.input = make_span(blended_locals_);
+    ltm_job.output = make_span(models_);
+    return ltm_job.Run();
+}
+
+bool OzzBenchmark::SimdEnabled()
+{
+#ifdef OZZ_SIMD_REF
+    return false;
+#else
+    return true;
+#endif
+}
+
+std::vector<char> OzzBenchmark::BuildSkeletonData(int numJoints)
+{
+    using offline::RawSkeleton;
+
+    // 构建一条由 numJoints 个关节组成的骨骼链
+    RawSkeleton raw;
+    raw.roots.resize(1);
+    RawSkeleton::Joint *joint = &raw.roots[0];
+    for (int i = 0; i < numJoints; ++i)
+    {
+        joint->name = ("joint" + std::to_string(i)).c_str();
+        joint->transform = Transform::identity();
+        joint->transform.translation = Float3(0.f, 1.f, 0.f);
+        if (i + 1 < numJoints)
+        {
+            joint->children.resize(1);
+            joint = &joint->children[0];
+        }
+    }
+
+    offline::SkeletonBuilder builder;
+    auto skeleton = builder(raw);
+    if (!skeleton)
+    {
+        return std::vector<char>();
+    }
+    return Serialize(*skeleton);
+}
+
+std::vector<char> OzzBenchmark::BuildAnimationData(int numJoints, int numKeys)
+{
+    using offline::RawAnimation;
+
+    // 每个关节带 numKeys 个均匀分布的平移/旋转/缩放关键帧
+    RawAnimation raw;
+    raw.duration = 1.f;
+    raw.tracks.resize(numJoints);
+    for (auto &track : raw.tracks)
+    {
+        for (int k = 0; k < numKeys; ++k)
+        {
+            const float time = raw.duration * k / (numKeys - 1);
+            const float angle = 0.2f * k;
+            track.translations.push_back({time, Float3(0.f, 1.f + 0.1f * k, 0.f)});
+            track.rotations.push_back({time, Quaternion::FromAxisAngle(Float3::x_axis(), angle)});
+            track.scales.push_back({time, Float3::one()});
+        }
+    }
+
+    offline::AnimationBuilder builder;
+    auto animation = builder(raw);
+    if (!animation)
+    {
+        return std::vector<char>();
+    }
+    return Serialize(*animation);
+}
+
+// C 接口实现
+extern "C"
+{
+#ifdef __EMSCRIPTEN__
+    EMSCRIPTEN_KEEPALIVE
+#endif
+    double ozz_benchmark_run(int stage, int numJoints, int iterations)
+    {
+        if (stage < OzzBenchmark::kSampling || stage > OzzBenchmark::kLocalToModel)
+        {
+            return -1.0;
+        }
+        OzzBenchmark benchmark(numJoints);
+        return benchmark.Run(static_cast<OzzBenchmark::Stage>(stage), iterations);
+    }
+
+#ifdef __EMSCRIPTEN__
+    EMSCRIPTEN_KEEPALIVE
+#endif
+    int ozz_benchmark_simd_enabled()
+    {
+        return OzzBenchmark::SimdEnabled() ? 1 : 0;
+    }
+
+} // extern "C"
@@ -0,0 +1,74 @@
+#ifndef OZZ_BENCHMARK_H
+#define OZZ_BENCHMARK_H
+
+#include <vector>
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/containers/vector.h"
+
+// OzzBenchmark 类 - 对 ozz 各运行时作业单独计时
+// 使用合成骨架（关节链）和动画，用于比较标量与 SIMD 构建的吞吐量
+class OzzBenchmark
+{
+public:
+    enum Stage
+    {
+        kSampling = 0,
+        kBlending = 1,
+        kLocalToModel = 2
+    };
+
+    explicit OzzBenchmark(int numJoints, int numKeys = 16);
+    ~OzzBenchmark();
+
+    bool IsValid() const { return valid_; }
+
+    // 运行指定阶段 iterations 次，返回每次作业的纳秒数
+    double Run(Stage stage, int iterations);
+
+    // 是否使用 ozz 的 SIMD 数学实现
+    static bool SimdEnabled();
+
+    // 生成序列化后的合成骨架/动画，可交给 OzzAnimation::Load*FromMemory
+    static std::vector<char> BuildSkeletonData(int numJoints);
+    static std::vector<char> BuildAnimationData(int numJoints, int numKeys);
+
+private:
+    bool RunSampling();
+    bool RunBlending();
+    bool RunLocalToModel();
+
+private:
+    ozz::animation::Skeleton skeleton_;
+    ozz::animation::Animation animation_;
+    ozz::animation::SamplingJob::Context context_;
+
+    ozz::vector<ozz::math::SoaTransform> locals_[3];
+    ozz::vector<ozz::math::SoaTransform> blended_locals_;
+    ozz::vector<ozz::math::Float4x4> models_;
+
+    float time_ratio_;
+    bool valid_;
+};
+
+// C 接口函数 - 用于 A/B 基准页面
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // 返回每次作业的纳秒数，失败返回负数
+    double ozz_benchmark_run(int stage, int numJoints, int iterations);
+
+    // 当前构建是否启用 SIMD
+    int ozz_benchmark_simd_enabled();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OZZ_BENCHMARK_H
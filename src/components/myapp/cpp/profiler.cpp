@@ -0,0 +1,188 @@
+#include "profiler.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+namespace
+{
+    /**
+     * @brief 单个线程的事件环形缓冲区
+     *
+     * 只有所属线程写入，写入完成后以 release 语义发布写入计数；导出线程只读取
+     */
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(uint32_t id)
+            : threadId(id), depth(0), written(0), events(new Profiler::Event[Profiler::kEventsPerThread])
+        {
+        }
+
+        uint32_t threadId;
+        uint32_t depth;
+        std::atomic<uint64_t> written;
+        std::unique_ptr<Profiler::Event[]> events;
+    };
+
+    // 线程缓冲区注册表，只在每个线程第一次记录时加锁
+    std::mutex &registryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::vector<std::unique_ptr<ThreadBuffer>> &registry()
+    {
+        static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    ThreadBuffer &threadBuffer()
+    {
+        // 缓冲区在线程退出后仍保留，以便导出工作线程的事件
+        thread_local ThreadBuffer *buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            auto &buffers = registry();
+            buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(buffers.size())));
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    void appendJsonString(std::ostringstream &out, const char *text)
+    {
+        out << '"';
+        for (const char *c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+uint64_t Profiler::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+uint32_t Profiler::beginZone()
+{
+    return threadBuffer().depth++;
+}
+
+void Profiler::endZone(const char *name, uint64_t startNs, uint32_t depth)
+{
+    uint64_t endNs = now();
+    ThreadBuffer &buffer = threadBuffer();
+    buffer.depth = depth;
+
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Event &event = buffer.events[index & (kEventsPerThread - 1)];
+    event.name = name;
+    event.startNs = startNs;
+    event.endNs = endNs;
+    event.depth = depth;
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto &buffer : registry())
+    {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+std::string Profiler::exportChromeTrace()
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto &buffer : registry())
+    {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = written > kEventsPerThread ? written - kEventsPerThread : 0;
+
+        // 线程名称元数据
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"" << (buffer->threadId == 0 ? "main" : "worker") << " " << buffer->threadId << "\"}}";
+        first = false;
+
+        for (uint64_t i = begin; i < written; ++i)
+        {
+            const Event &event = buffer->events[i & (kEventsPerThread - 1)];
+            out << ",\n{\"name\":";
+            appendJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNs / 1000.0
+                << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0
+                << ",\"args\":{\"depth\":" << event.depth << "}}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+    file << exportChromeTrace();
+    return true;
+}
+
+// Electron 绑定接口 - 在生产构建中采集帧分析数据
+#ifdef __EMSCRIPTEN__
+extern "C"
+{
+    // 启用/禁用记录
+    EMSCRIPTEN_KEEPALIVE
+    void engine_profiler_set_enabled(int enabled)
+    {
+        Profiler::setEnabled(enabled != 0);
+    }
+
+    // 清空已记录的事件
+    EMSCRIPTEN_KEEPALIVE
+    void engine_profiler_reset()
+    {
+        Profiler::reset();
+    }
+
+    // 导出 Chrome trace JSON，返回的字符串在下一次调用前有效
+    EMSCRIPTEN_KEEPALIVE
+    const char *engine_profiler_dump_trace()
+    {
+        static std::string trace;
+        trace = Profiler::exportChromeTrace();
+        return trace.c_str();
+    }
+}
+#endif
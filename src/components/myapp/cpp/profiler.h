@@ -0,0 +1,133 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief CPU 帧分析器
+ *
+ * 通过 PROFILE_ZONE 宏记录带层级的作用域耗时，每个线程写入自己的无锁环形缓冲区，
+ * 可导出为 Chrome trace-event JSON（chrome://tracing 或 Perfetto 打开）。
+ * 运行时关闭时每个区域只有一次原子读取；编译时定义 ENGINE_PROFILER=0 则完全移除。
+ */
+class Profiler
+{
+public:
+    // 每个线程保留的最近事件数量
+    static constexpr uint32_t kEventsPerThread = 1u << 16;
+
+    /**
+     * @brief 一个已完成的区域
+     */
+    struct Event
+    {
+        const char *name; // 必须是静态字符串
+        uint64_t startNs;
+        uint64_t endNs;
+        uint32_t depth;
+    };
+
+    /**
+     * @brief 启用/禁用记录
+     * @param enabled 是否启用
+     */
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief 检查是否正在记录
+     * @return 是否启用
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取当前时间
+     * @return 单调时钟纳秒数
+     */
+    static uint64_t now();
+
+    /**
+     * @brief 开始区域（由 ProfileZone 调用）
+     * @return 区域层级
+     */
+    static uint32_t beginZone();
+
+    /**
+     * @brief 结束区域并写入当前线程的环形缓冲区（由 ProfileZone 调用）
+     */
+    static void endZone(const char *name, uint64_t startNs, uint32_t depth);
+
+    /**
+     * @brief 清空所有线程已记录的事件，应在没有区域正在记录时调用
+     */
+    static void reset();
+
+    /**
+     * @brief 导出所有线程的事件为 Chrome trace-event JSON
+     *
+     * 记录过程中导出时，最旧的事件可能正被覆盖，建议先 setEnabled(false)
+     * @return JSON 字符串
+     */
+    static std::string exportChromeTrace();
+
+    /**
+     * @brief 导出 Chrome trace 到文件
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    static bool writeChromeTrace(const std::string &path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief RAII 分析区域
+ */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name)
+        : m_name(nullptr), m_startNs(0), m_depth(0)
+    {
+        if (Profiler::isEnabled())
+        {
+            m_name = name;
+            m_depth = Profiler::beginZone();
+            m_startNs = Profiler::now();
+        }
+    }
+
+    ~ProfileZone()
+    {
+        if (m_name)
+        {
+            Profiler::endZone(m_name, m_startNs, m_depth);
+        }
+    }
+
+    // 禁用拷贝构造和赋值
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *m_name;
+    uint64_t m_startNs;
+    uint32_t m_depth;
+};
+
+#ifndef ENGINE_PROFILER
+#define ENGINE_PROFILER 1
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENGINE_PROFILER
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -1,90 +1,567 @@
 #include "rendercommand.h"
-#include <GLFW/glfw3.h>
+#include "profiler.h"
+#include "material.h"
+#include "glstate.h"
+#include "instancing.h"
+#include <algorithm>
+#include <cstring>
 
-FunctionalRenderCommand::FunctionalRenderCommand(CommandFunction func)
-    : m_function(std::move(func))
+namespace
 {
-}
+    // 第一次分配的缓冲区大小
+    constexpr size_t kInitialCapacity = 4096;
 
-void FunctionalRenderCommand::execute()
-{
-    if (m_function)
+    // 状态字段在排序键中的位数
+    constexpr int kStateBits = 12;
+    constexpr std::uint64_t kStateMask = (std::uint64_t(1) << kStateBits) - 1;
+    constexpr std::uint64_t kTranslucentBit = std::uint64_t(1) << 55;
+
+    // 命令数量不超过该值时用插入排序，避免基数排序直方图的固定开销
+    constexpr size_t kInsertionSortThreshold = 32;
+
+    // 绘制命令参与排序，其他命令是排序的分界
+    bool isSortable(const std::uint8_t *packet)
     {
-        m_function();
+        const RenderCommandType type = reinterpret_cast<const RenderCommandHeader *>(packet)->type;
+        return type == RenderCommandType::Draw || type == RenderCommandType::MultiDraw;
+    }
+
+    void invokeFunction(void *userData)
+    {
+        const auto &function = *static_cast<const std::function<void()> *>(userData);
+        if (function)
+        {
+            function();
+        }
     }
 }
 
-bool FunctionalRenderCommand::isValid() const
+std::uint32_t DrawKey::quantizeDepth(float depth)
 {
-    return static_cast<bool>(m_function);
+    constexpr std::uint32_t maxDepth = (1u << kDepthBits) - 1;
+    if (!(depth > 0.0f))
+    {
+        return 0;
+    }
+    if (depth >= 1.0f)
+    {
+        return maxDepth;
+    }
+    return static_cast<std::uint32_t>(depth * static_cast<float>(maxDepth));
 }
 
-ClearCommand::ClearCommand(float r, float g, float b, float a, unsigned int mask)
-    : m_clearMask(mask)
+std::uint64_t DrawKey::opaque(std::uint32_t program, std::uint32_t material, std::uint32_t vertexArray, float depth)
 {
-    m_clearColor[0] = r;
-    m_clearColor[1] = g;
-    m_clearColor[2] = b;
-    m_clearColor[3] = a;
+    return ((program & kStateMask) << 43) |
+           ((material & kStateMask) << 31) |
+           ((vertexArray & kStateMask) << 19) |
+           quantizeDepth(depth);
 }
 
-void ClearCommand::execute()
+std::uint64_t DrawKey::translucent(std::uint32_t program, std::uint32_t material, std::uint32_t vertexArray, float depth)
 {
-    glClearColor(m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3]);
-    glClear(m_clearMask);
+    // 深度取反，升序排序即由远到近
+    std::uint64_t farToNear = ((1u << kDepthBits) - 1) - quantizeDepth(depth);
+    return kTranslucentBit |
+           (farToNear << 36) |
+           ((program & kStateMask) << 24) |
+           ((material & kStateMask) << 12) |
+           (vertexArray & kStateMask);
 }
 
 RenderCommandQueue::RenderCommandQueue()
+    : m_capacity(0), m_used(0), m_sortEnabled(true), m_sorted(false), m_stats{}
 {
 }
 
 RenderCommandQueue::~RenderCommandQueue()
 {
-    clear();
 }
 
 RenderCommandQueue::RenderCommandQueue(RenderCommandQueue &&other) noexcept
-    : m_commands(std::move(other.m_commands))
+    : m_data(std::move(other.m_data)),
+      m_capacity(other.m_capacity),
+      m_used(other.m_used),
+      m_items(std::move(other.m_items)),
+      m_sortScratch(std::move(other.m_sortScratch)),
+      m_sortEnabled(other.m_sortEnabled),
+      m_sorted(other.m_sorted),
+      m_stats(other.m_stats)
 {
+    other.m_capacity = 0;
+    other.m_used = 0;
+    other.m_items.clear();
 }
 
 RenderCommandQueue &RenderCommandQueue::operator=(RenderCommandQueue &&other) noexcept
 {
     if (this != &other)
     {
-        m_commands = std::move(other.m_commands);
+        m_data = std::move(other.m_data);
+        m_capacity = other.m_capacity;
+        m_used = other.m_used;
+        m_items = std::move(other.m_items);
+        m_sortScratch = std::move(other.m_sortScratch);
+        m_sortEnabled = other.m_sortEnabled;
+        m_sorted = other.m_sorted;
+        m_stats = other.m_stats;
+
+        other.m_capacity = 0;
+        other.m_used = 0;
+        other.m_items.clear();
     }
     return *this;
 }
 
-void RenderCommandQueue::addCommand(std::unique_ptr<RenderCommand> command)
+void RenderCommandQueue::reserve(size_t size)
 {
-    if (command && command->isValid())
+    if (size <= m_capacity)
+        return;
+
+    // 命令都是 POD，扩容时直接拷贝字节
+    size_t newCapacity = std::max(kInitialCapacity, m_capacity * 2);
+    while (newCapacity < size)
+    {
+        newCapacity *= 2;
+    }
+
+    std::unique_ptr<std::uint8_t[]> newData(new std::uint8_t[newCapacity]);
+    if (m_used > 0)
     {
-        m_commands.push_back(std::move(command));
+        std::memcpy(newData.get(), m_data.get(), m_used);
     }
+    m_data = std::move(newData);
+    m_capacity = newCapacity;
 }
 
-void RenderCommandQueue::addCommand(std::function<void()> func)
+std::uint8_t *RenderCommandQueue::allocate(size_t size, std::uint64_t sortKey)
 {
-    if (func)
+    reserve(m_used + size);
+
+    std::uint8_t *memory = m_data.get() + m_used;
+    // 填充字节清零，相同的录制总是得到相同的字节
+    std::memset(memory, 0, size);
+    m_items.push_back({sortKey, static_cast<std::uint32_t>(m_used)});
+    m_used += size;
+    m_sorted = false;
+    return memory;
+}
+
+void RenderCommandQueue::addClear(float r, float g, float b, float a, GLbitfield mask)
+{
+    ClearCommand &command = addCommand<ClearCommand>();
+    command.color[0] = r;
+    command.color[1] = g;
+    command.color[2] = b;
+    command.color[3] = a;
+    command.mask = mask;
+}
+
+void RenderCommandQueue::addSetMaterial(Material *material)
+{
+    if (material)
     {
-        m_commands.push_back(std::make_unique<FunctionalRenderCommand>(std::move(func)));
+        addCommand<SetMaterialCommand>().material = material;
     }
 }
 
-void RenderCommandQueue::executeAll()
+void RenderCommandQueue::addBindVertexArray(GLuint vertexArray)
+{
+    addCommand<BindVertexArrayCommand>().vertexArray = vertexArray;
+}
+
+void RenderCommandQueue::addDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
-    for (auto &command : m_commands)
+    DrawArraysCommand &command = addCommand<DrawArraysCommand>();
+    command.mode = mode;
+    command.first = first;
+    command.count = count;
+}
+
+void RenderCommandQueue::addDrawElements(GLenum mode, GLsizei count, GLenum indexType, std::uintptr_t indexOffset)
+{
+    DrawElementsCommand &command = addCommand<DrawElementsCommand>();
+    command.mode = mode;
+    command.count = count;
+    command.indexType = indexType;
+    command.indexOffset = indexOffset;
+}
+
+DrawCommand &RenderCommandQueue::addDraw(std::uint64_t sortKey)
+{
+    return allocateCommand<DrawCommand>(sortKey);
+}
+
+MultiDrawCommand &RenderCommandQueue::addMultiDraw(std::uint64_t sortKey)
+{
+    return allocateCommand<MultiDrawCommand>(sortKey);
+}
+
+void RenderCommandQueue::addCallback(CallbackCommand::Function function, void *userData)
+{
+    if (function)
+    {
+        CallbackCommand &command = addCommand<CallbackCommand>();
+        command.function = function;
+        command.userData = userData;
+    }
+}
+
+void RenderCommandQueue::addCallback(const std::function<void()> *callback)
+{
+    if (callback && *callback)
     {
-        if (command && command->isValid())
+        addCallback(&invokeFunction, const_cast<std::function<void()> *>(callback));
+    }
+}
+
+void RenderCommandQueue::append(const RenderCommandQueue &other)
+{
+    if (other.m_items.empty())
+        return;
+
+    reserve(m_used + other.m_used);
+    std::memcpy(m_data.get() + m_used, other.m_data.get(), other.m_used);
+
+    const std::uint32_t base = static_cast<std::uint32_t>(m_used);
+    m_items.reserve(m_items.size() + other.m_items.size());
+    for (const SortItem &item : other.m_items)
+    {
+        m_items.push_back({item.key, base + item.offset});
+    }
+
+    m_used += other.m_used;
+    m_sorted = false;
+}
+
+void RenderCommandQueue::countStateChanges(std::uint32_t &programChanges, std::uint32_t &materialChanges,
+                                           std::uint32_t &vertexArrayChanges) const
+{
+    // 与 executeAll() 的状态跟踪一致：回调之后状态未知
+    const Material *currentMaterial = nullptr;
+    GLuint currentProgram = 0;
+    bool programKnown = false;
+    GLuint currentVertexArray = 0;
+    bool vertexArrayKnown = false;
+
+    for (const SortItem &item : m_items)
+    {
+        const std::uint8_t *packet = m_data.get() + item.offset;
+        const auto &header = *reinterpret_cast<const RenderCommandHeader *>(packet);
+        if (header.type == RenderCommandType::Callback)
+        {
+            currentMaterial = nullptr;
+            programKnown = false;
+            vertexArrayKnown = false;
+            continue;
+        }
+        if (header.type == RenderCommandType::SetMaterial)
+        {
+            currentMaterial = reinterpret_cast<const SetMaterialCommand *>(packet)->material;
+            currentProgram = currentMaterial->getProgramId();
+            programKnown = true;
+            continue;
+        }
+        if (header.type == RenderCommandType::BindVertexArray)
         {
-            command->execute();
+            currentVertexArray = reinterpret_cast<const BindVertexArrayCommand *>(packet)->vertexArray;
+            vertexArrayKnown = true;
+            continue;
+        }
+
+        const Material *material;
+        GLuint vertexArray;
+        if (header.type == RenderCommandType::Draw)
+        {
+            const auto &command = *reinterpret_cast<const DrawCommand *>(packet);
+            material = command.material;
+            vertexArray = command.vertexArray;
+        }
+        else if (header.type == RenderCommandType::MultiDraw)
+        {
+            const auto &command = *reinterpret_cast<const MultiDrawCommand *>(packet);
+            material = command.material;
+            vertexArray = command.vertexArray;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (material != currentMaterial)
+        {
+            ++materialChanges;
+            currentMaterial = material;
+
+            GLuint program = material->getProgramId();
+            if (!programKnown || program != currentProgram)
+            {
+                ++programChanges;
+                currentProgram = program;
+                programKnown = true;
+            }
+        }
+        if (!vertexArrayKnown || vertexArray != currentVertexArray)
+        {
+            ++vertexArrayChanges;
+            currentVertexArray = vertexArray;
+            vertexArrayKnown = true;
+        }
+    }
+}
+
+void RenderCommandQueue::sort()
+{
+    PROFILE_ZONE("RenderCommandQueue::sort");
+
+    m_stats = {};
+    m_stats.commandCount = static_cast<std::uint32_t>(m_items.size());
+    for (const SortItem &item : m_items)
+    {
+        if (isSortable(m_data.get() + item.offset))
+        {
+            ++m_stats.drawCount;
+        }
+    }
+    countStateChanges(m_stats.unsortedProgramChanges, m_stats.unsortedMaterialChanges,
+                      m_stats.unsortedVertexArrayChanges);
+
+    // 非绘制命令保持原位，只在两个非绘制命令之间的一段绘制命令内排序
+    if (m_sortEnabled)
+    {
+        size_t segmentBegin = 0;
+        for (size_t i = 0; i <= m_items.size(); ++i)
+        {
+            if (i < m_items.size() && isSortable(m_data.get() + m_items[i].offset))
+                continue;
+
+            if (i - segmentBegin > 1)
+            {
+                sortRange(m_items.data() + segmentBegin, i - segmentBegin);
+            }
+            segmentBegin = i + 1;
+        }
+    }
+
+    countStateChanges(m_stats.programChanges, m_stats.materialChanges, m_stats.vertexArrayChanges);
+    m_sorted = true;
+}
+
+void RenderCommandQueue::sortRange(SortItem *items, size_t count)
+{
+    if (count <= kInsertionSortThreshold)
+    {
+        // 稳定的插入排序
+        for (size_t i = 1; i < count; ++i)
+        {
+            SortItem item = items[i];
+            size_t j = i;
+            while (j > 0 && items[j - 1].key > item.key)
+            {
+                items[j] = items[j - 1];
+                --j;
+            }
+            items[j] = item;
+        }
+    }
+    else
+    {
+        // 稳定的 LSD 基数排序：每次处理 8 位，一次遍历统计所有字节的直方图
+        std::uint32_t histograms[8][256] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            const SortItem &item = items[i];
+            for (int pass = 0; pass < 8; ++pass)
+            {
+                ++histograms[pass][(item.key >> (pass * 8)) & 0xff];
+            }
+        }
+
+        if (m_sortScratch.size() < count)
+        {
+            m_sortScratch.resize(count);
+        }
+        SortItem *source = items;
+        SortItem *destination = m_sortScratch.data();
+        for (int pass = 0; pass < 8; ++pass)
+        {
+            std::uint32_t *histogram = histograms[pass];
+            const int shift = pass * 8;
+
+            // 所有键在该字节上相同时跳过
+            if (histogram[(source[0].key >> shift) & 0xff] == count)
+            {
+                continue;
+            }
+
+            std::uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                std::uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                destination[histogram[(source[i].key >> shift) & 0xff]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+
+        if (source != items)
+        {
+            std::copy(source, source + count, items);
+        }
+    }
+}
+
+void RenderCommandQueue::executeAll(const ObjectUniformRange *objectUniforms)
+{
+    if (!m_sorted)
+    {
+        sort();
+    }
+
+    PROFILE_ZONE("RenderCommandQueue::executeAll");
+
+    // 绘制命令之间跟踪的材质（GL 绑定由 GLState 去重），回调可能修改任意 GL 状态，执行后重置。
+    // 材质没有绑定可用的程序（着色器仍在编译且没有后备材质）时跳过使用它的绘制，不能沿用上一个程序
+    Material *currentMaterial = nullptr;
+    bool materialReady = true;
+    const bool multiDraw = GLState::isMultiDrawSupported();
+
+    for (const SortItem &item : m_items)
+    {
+        const std::uint8_t *packet = m_data.get() + item.offset;
+        const auto &header = *reinterpret_cast<const RenderCommandHeader *>(packet);
+        switch (header.type)
+        {
+        case RenderCommandType::Clear:
+        {
+            const auto &command = *reinterpret_cast<const ClearCommand *>(packet);
+            glClearColor(command.color[0], command.color[1], command.color[2], command.color[3]);
+            glClear(command.mask);
+            break;
+        }
+        case RenderCommandType::SetMaterial:
+        {
+            const auto &command = *reinterpret_cast<const SetMaterialCommand *>(packet);
+            materialReady = command.material->apply();
+            currentMaterial = command.material;
+            break;
+        }
+        case RenderCommandType::BindVertexArray:
+        {
+            const auto &command = *reinterpret_cast<const BindVertexArrayCommand *>(packet);
+            GLState::bindVertexArray(command.vertexArray);
+            break;
+        }
+        case RenderCommandType::DrawArrays:
+        {
+            const auto &command = *reinterpret_cast<const DrawArraysCommand *>(packet);
+            if (!materialReady)
+                break;
+            glDrawArrays(command.mode, command.first, command.count);
+            break;
+        }
+        case RenderCommandType::DrawElements:
+        {
+            const auto &command = *reinterpret_cast<const DrawElementsCommand *>(packet);
+            if (!materialReady)
+                break;
+            glDrawElements(command.mode, command.count, command.indexType,
+                           reinterpret_cast<const void *>(command.indexOffset));
+            break;
+        }
+        case RenderCommandType::Draw:
+        {
+            const auto &command = *reinterpret_cast<const DrawCommand *>(packet);
+            if (command.material != currentMaterial)
+            {
+                materialReady = command.material->apply();
+                currentMaterial = command.material;
+            }
+            if (!materialReady)
+                break;
+            GLState::bindVertexArray(command.vertexArray);
+            if (objectUniforms && command.uniformSlot != DrawCommand::kNoUniformSlot)
+            {
+                GLState::bindUniformBufferRange(static_cast<GLuint>(UniformBlock::Object), objectUniforms->buffer,
+                                                objectUniforms->baseOffset + command.uniformSlot * objectUniforms->stride,
+                                                objectUniforms->blockSize);
+            }
+            if (command.instanceLayout)
+            {
+                command.instanceLayout->bindAttributes(command.instanceBuffer, command.instanceOffset);
+                if (command.indexType != 0)
+                {
+                    glDrawElementsInstanced(command.mode, command.count, command.indexType,
+                                            reinterpret_cast<const void *>(command.indexOffset), command.instanceCount);
+                }
+                else
+                {
+                    glDrawArraysInstanced(command.mode, command.first, command.count, command.instanceCount);
+                }
+            }
+            else if (command.indexType != 0)
+            {
+                glDrawElements(command.mode, command.count, command.indexType,
+                               reinterpret_cast<const void *>(command.indexOffset));
+            }
+            else
+            {
+                glDrawArrays(command.mode, command.first, command.count);
+            }
+            break;
+        }
+        case RenderCommandType::MultiDraw:
+        {
+            const auto &command = *reinterpret_cast<const MultiDrawCommand *>(packet);
+            if (command.material != currentMaterial)
+            {
+                materialReady = command.material->apply();
+                currentMaterial = command.material;
+            }
+            if (!materialReady)
+                break;
+            GLState::bindVertexArray(command.vertexArray);
+            if (objectUniforms && command.uniformSlot != DrawCommand::kNoUniformSlot)
+            {
+                GLState::bindUniformBufferRange(static_cast<GLuint>(UniformBlock::Object), objectUniforms->buffer,
+                                                objectUniforms->baseOffset + command.uniformSlot * objectUniforms->stride,
+                                                objectUniforms->blockSize);
+            }
+            if (multiDraw)
+            {
+                glMultiDrawElementsWEBGL(command.mode, command.counts, command.indexType, command.offsets,
+                                         command.drawCount);
+            }
+            else
+            {
+                for (GLsizei i = 0; i < command.drawCount; ++i)
+                {
+                    glDrawElements(command.mode, command.counts[i], command.indexType, command.offsets[i]);
+                }
+            }
+            break;
+        }
+        case RenderCommandType::Callback:
+        {
+            const auto &command = *reinterpret_cast<const CallbackCommand *>(packet);
+            command.function(command.userData);
+            currentMaterial = nullptr;
+            materialReady = true;
+            GLState::invalidate();
+            break;
+        }
         }
     }
 }
 
 void RenderCommandQueue::clear()
 {
-    m_commands.clear();
+    m_used = 0;
+    m_items.clear();
+    m_sorted = false;
 }
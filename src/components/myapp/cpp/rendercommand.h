@@ -1,77 +1,254 @@
 #ifndef RENDERCOMMAND_H
 #define RENDERCOMMAND_H
 
+#include "glapi.h"
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
+class Material;
+class InstanceLayout;
+
 /**
- * @brief 渲染命令基类
+ * @brief 渲染命令类型
+ */
+enum class RenderCommandType : std::uint8_t
+{
+    Clear,
+    SetMaterial,
+    BindVertexArray,
+    DrawArrays,
+    DrawElements,
+    Draw,
+    MultiDraw,
+    Callback,
+};
+
+/**
+ * @brief 渲染命令包头
  *
- * 使用命令模式解耦逻辑和渲染，所有渲染操作都通过命令执行
+ * 每个命令包以包头开始，size 为整个命令包的字节数（已按 kCommandAlignment 对齐），
+ * 用于在命令缓冲区中跳到下一个命令
  */
-class RenderCommand
+struct RenderCommandHeader
 {
-public:
-    virtual ~RenderCommand() = default;
+    RenderCommandType type;
+    std::uint16_t size;
+};
 
-    /**
-     * @brief 执行渲染命令
-     */
-    virtual void execute() = 0;
+/**
+ * @brief 清除缓冲区命令
+ */
+struct ClearCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::Clear;
 
-    /**
-     * @brief 检查命令是否有效
-     * @return 是否有效
-     */
-    virtual bool isValid() const = 0;
+    RenderCommandHeader header;
+    float color[4];
+    GLbitfield mask;
+};
+
+/**
+ * @brief 设置渲染状态命令：应用材质（着色器程序和 uniform）
+ */
+struct SetMaterialCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::SetMaterial;
+
+    RenderCommandHeader header;
+    Material *material; // 由录制方保证在执行前有效
+};
+
+/**
+ * @brief 绑定顶点数组对象命令
+ */
+struct BindVertexArrayCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::BindVertexArray;
+
+    RenderCommandHeader header;
+    GLuint vertexArray;
+};
+
+/**
+ * @brief 非索引绘制命令
+ */
+struct DrawArraysCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::DrawArrays;
+
+    RenderCommandHeader header;
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+};
+
+/**
+ * @brief 索引绘制命令
+ */
+struct DrawElementsCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::DrawElements;
+
+    RenderCommandHeader header;
+    GLenum mode;
+    GLsizei count;
+    GLenum indexType;
+    std::uintptr_t indexOffset; // 索引缓冲中的字节偏移
 };
 
 /**
- * @brief 函数式渲染命令
+ * @brief 带排序键的网格绘制命令
  *
- * 使用函数对象包装渲染操作
+ * 自带材质和 VAO，执行时只有与上一个绘制不同才切换，排序后相邻的绘制共享状态。
+ * instanceLayout 非空时为实例化绘制：先把实例属性指向 instanceBuffer 的 instanceOffset 处，
+ * 再绘制 instanceCount 个实例。uniformSlot 不是 kNoUniformSlot 时，
+ * 绘制前把该槽位的 ObjectBlock 绑定到 UniformBlock::Object（见 ObjectUniformRange）
  */
-class FunctionalRenderCommand : public RenderCommand
+struct DrawCommand
 {
-public:
-    using CommandFunction = std::function<void()>;
+    static constexpr RenderCommandType kType = RenderCommandType::Draw;
+    static constexpr std::uint32_t kNoUniformSlot = ~0u;
 
-    explicit FunctionalRenderCommand(CommandFunction func);
-    ~FunctionalRenderCommand() override = default;
+    RenderCommandHeader header;
+    Material *material; // 由录制方保证在执行前有效
+    GLuint vertexArray;
+    GLenum mode;
+    GLint first;       // 非索引绘制的起始顶点
+    GLsizei count;     // 索引数量或顶点数量
+    GLenum indexType;  // 0 表示非索引绘制
+    std::uintptr_t indexOffset;
+    const InstanceLayout *instanceLayout; // nullptr 表示非实例化绘制，由录制方保证在执行前有效
+    GLuint instanceBuffer;
+    GLsizei instanceCount;
+    std::uintptr_t instanceOffset; // 第一个实例在实例缓冲区中的字节偏移
+    std::uint32_t uniformSlot;     // 逐对象 uniform 块的槽位
+};
 
-    void execute() override;
-    bool isValid() const override;
+/**
+ * @brief 多重绘制命令：用同一材质和 VAO 绘制共享缓冲区中的多段索引范围
+ *
+ * WEBGL_multi_draw 可用时一次提交所有范围（只跨越一次 wasm→JS 边界），
+ * 否则逐段调用 glDrawElements。与 DrawCommand 一样参与排序，uniformSlot 的含义也相同
+ */
+struct MultiDrawCommand
+{
+    static constexpr RenderCommandType kType = RenderCommandType::MultiDraw;
 
-private:
-    CommandFunction m_function;
+    RenderCommandHeader header;
+    Material *material; // 由录制方保证在执行前有效
+    GLuint vertexArray;
+    GLenum mode;
+    GLenum indexType;
+    GLsizei drawCount;
+    const GLsizei *counts;       // 每段的索引数量，由录制方持有
+    const void *const *offsets;  // 每段在索引缓冲中的字节偏移，由录制方持有
+    std::uint32_t uniformSlot;   // 逐对象 uniform 块的槽位，kNoUniformSlot 表示不绑定
 };
 
 /**
- * @brief 清除缓冲区命令
+ * @brief 回调命令，执行任意的用户渲染代码
  */
-class ClearCommand : public RenderCommand
+struct CallbackCommand
 {
-public:
-    ClearCommand(float r, float g, float b, float a, unsigned int mask);
-    ~ClearCommand() override = default;
+    static constexpr RenderCommandType kType = RenderCommandType::Callback;
 
-    void execute() override;
-    bool isValid() const override { return true; }
+    using Function = void (*)(void *userData);
 
-private:
-    float m_clearColor[4];
-    unsigned int m_clearMask;
+    RenderCommandHeader header;
+    Function function;
+    void *userData;
+};
+
+/**
+ * @brief 逐对象 uniform 块在 uniform 缓冲中的位置：槽位 slot 的块位于 baseOffset + slot * stride
+ *
+ * 命令只记录槽位，缓冲和偏移每帧由录制方提供，因此缓存的命令可以配合轮换的 uniform 缓冲重放
+ */
+struct ObjectUniformRange
+{
+    GLuint buffer;
+    GLintptr baseOffset;
+    GLsizeiptr stride;    // 相邻槽位的字节间隔，满足偏移对齐要求
+    GLsizeiptr blockSize; // 每个块绑定的字节数
+};
+
+/**
+ * @brief 64 位绘制排序键
+ *
+ * 从高位到低位：
+ *   [63..56] 保留为 0
+ *   [55]     层：0 不透明，1 半透明
+ *   不透明：[54..43] 着色器程序 [42..31] 材质 [30..19] VAO [18..0] 深度（由近到远）
+ *   半透明：[54..36] 深度（由远到近） [35..24] 着色器程序 [23..12] 材质 [11..0] VAO
+ * 程序、材质和 VAO 只取低位，冲突只影响分组效果，不影响正确性
+ */
+struct DrawKey
+{
+    static constexpr int kDepthBits = 19;
+
+    /**
+     * @brief 把 [0, 1] 范围的深度量化为 kDepthBits 位，超出范围的值被截断
+     * @param depth 归一化深度，0 为最近
+     * @return 量化深度
+     */
+    static std::uint32_t quantizeDepth(float depth);
+
+    /**
+     * @brief 生成不透明绘制的排序键：按状态分组，组内由近到远
+     */
+    static std::uint64_t opaque(std::uint32_t program, std::uint32_t material, std::uint32_t vertexArray, float depth);
+
+    /**
+     * @brief 生成半透明绘制的排序键：由远到近，深度相同时按状态分组
+     */
+    static std::uint64_t translucent(std::uint32_t program, std::uint32_t material, std::uint32_t vertexArray, float depth);
+};
+
+/**
+ * @brief 渲染命令队列统计
+ *
+ * 状态切换次数按执行顺序统计，unsorted* 为同一批命令按录制顺序执行时的次数
+ */
+struct RenderQueueStats
+{
+    std::uint32_t commandCount;
+    std::uint32_t drawCount;
+    std::uint32_t programChanges;
+    std::uint32_t materialChanges;
+    std::uint32_t vertexArrayChanges;
+    std::uint32_t unsortedProgramChanges;
+    std::uint32_t unsortedMaterialChanges;
+    std::uint32_t unsortedVertexArrayChanges;
+
+    /**
+     * @brief 排序节省的状态切换次数
+     */
+    std::uint32_t savedStateChanges() const
+    {
+        return (unsortedProgramChanges + unsortedMaterialChanges + unsortedVertexArrayChanges) -
+               (programChanges + materialChanges + vertexArrayChanges);
+    }
 };
 
 /**
  * @brief 渲染命令队列
  *
- * 管理渲染命令的执行顺序
+ * 命令是带类型标签的 POD 包，紧密写入线性分配的缓冲区；clear() 只重置写入位置，
+ * 缓冲区容量跨帧复用，因此稳定状态下录制命令不会分配堆内存。
+ * 绘制命令带一个 64 位排序键（见 DrawKey），executeAll() 先排序再通过 switch 分发执行，
+ * 没有虚函数调用。非绘制命令把队列分成若干段，它们保持录制位置不变，
+ * 每段内的绘制命令各自按键做稳定的 LSD 基数排序，因此绘制不会越过清除和回调
  */
 class RenderCommandQueue
 {
 public:
+    // 命令包对齐字节数
+    static constexpr size_t kCommandAlignment = 8;
+
     RenderCommandQueue();
     ~RenderCommandQueue();
 
@@ -84,41 +261,195 @@ public:
     RenderCommandQueue &operator=(RenderCommandQueue &&other) noexcept;
 
     /**
-     * @brief 添加渲染命令
-     * @param command 渲染命令
+     * @brief 分配一个非绘制命令包并写入包头，其余字段由调用方填写
+     *
+     * 该命令与之前、之后的命令保持录制顺序
+     * @return 命令包（在下一次添加命令前有效）
+     */
+    template <typename T>
+    T &addCommand()
+    {
+        return allocateCommand<T>(0);
+    }
+
+    /**
+     * @brief 添加清除命令
+     */
+    void addClear(float r, float g, float b, float a, GLbitfield mask);
+
+    /**
+     * @brief 添加应用材质命令
+     * @param material 材质
+     */
+    void addSetMaterial(Material *material);
+
+    /**
+     * @brief 添加绑定顶点数组对象命令
+     * @param vertexArray VAO 名称，0 表示解绑
+     */
+    void addBindVertexArray(GLuint vertexArray);
+
+    /**
+     * @brief 添加非索引绘制命令
+     */
+    void addDrawArrays(GLenum mode, GLint first, GLsizei count);
+
+    /**
+     * @brief 添加索引绘制命令
+     */
+    void addDrawElements(GLenum mode, GLsizei count, GLenum indexType, std::uintptr_t indexOffset);
+
+    /**
+     * @brief 添加可排序的绘制命令，其余字段由调用方填写
+     * @param sortKey 排序键（DrawKey::opaque/translucent）
+     * @return 命令包（在下一次添加命令前有效）
+     */
+    DrawCommand &addDraw(std::uint64_t sortKey);
+
+    /**
+     * @brief 添加可排序的多重绘制命令，其余字段由调用方填写
+     * @param sortKey 排序键（DrawKey::opaque/translucent）
+     * @return 命令包（在下一次添加命令前有效）
+     */
+    MultiDrawCommand &addMultiDraw(std::uint64_t sortKey);
+
+    /**
+     * @brief 添加回调命令
+     * @param function 回调函数
+     * @param userData 传给回调函数的数据
+     */
+    void addCallback(CallbackCommand::Function function, void *userData);
+
+    /**
+     * @brief 添加函数对象回调命令（只保存指针，不拷贝函数对象）
+     * @param callback 函数对象，执行前必须保持有效
      */
-    void addCommand(std::unique_ptr<RenderCommand> command);
+    void addCallback(const std::function<void()> *callback);
 
     /**
-     * @brief 添加函数式渲染命令
-     * @param func 渲染函数
+     * @brief 按录制顺序追加另一个队列的所有命令
+     *
+     * 命令字节直接拷贝，结果与把这些命令直接录制到本队列逐字节相同
+     * @param other 源队列
      */
-    void addCommand(std::function<void()> func);
+    void append(const RenderCommandQueue &other);
 
     /**
-     * @brief 执行所有渲染命令
+     * @brief 启用/禁用排序（禁用时按录制顺序执行，便于对比）
+     * @param enabled 是否排序
      */
-    void executeAll();
+    void setSortEnabled(bool enabled) { m_sortEnabled = enabled; }
 
     /**
-     * @brief 清空命令队列
+     * @brief 检查是否启用排序
+     * @return 是否排序
+     */
+    bool isSortEnabled() const { return m_sortEnabled; }
+
+    /**
+     * @brief 按排序键排序命令并更新统计，executeAll() 之前未排序时自动调用
+     */
+    void sort();
+
+    /**
+     * @brief 按排序键顺序执行所有渲染命令
+     * @param objectUniforms 本帧逐对象 uniform 块的位置，nullptr 时忽略绘制命令的 uniformSlot
+     */
+    void executeAll(const ObjectUniformRange *objectUniforms = nullptr);
+
+    /**
+     * @brief 清空命令队列，保留已分配的缓冲区
      */
     void clear();
 
+    /**
+     * @brief 获取最近一次排序的统计
+     * @return 统计数据
+     */
+    const RenderQueueStats &getStats() const { return m_stats; }
+
     /**
      * @brief 获取命令数量
      * @return 命令数量
      */
-    size_t size() const { return m_commands.size(); }
+    size_t size() const { return m_items.size(); }
 
     /**
      * @brief 检查队列是否为空
      * @return 是否为空
      */
-    bool empty() const { return m_commands.empty(); }
+    bool empty() const { return m_items.empty(); }
+
+    /**
+     * @brief 获取已使用的字节数
+     * @return 字节数
+     */
+    size_t bytesUsed() const { return m_used; }
+
+    /**
+     * @brief 获取缓冲区容量
+     * @return 字节数
+     */
+    size_t capacity() const { return m_capacity; }
+
+private:
+    /**
+     * @brief 排序项：命令的排序键和它在缓冲区中的偏移
+     */
+    struct SortItem
+    {
+        std::uint64_t key;
+        std::uint32_t offset;
+    };
+
+    template <typename T>
+    T &allocateCommand(std::uint64_t sortKey)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "render commands must be POD");
+        static_assert(alignof(T) <= kCommandAlignment, "render command alignment too large");
+        static_assert(offsetof(T, header) == 0, "render command must start with its header");
+
+        constexpr size_t size = (sizeof(T) + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+        T *command = reinterpret_cast<T *>(allocate(size, sortKey));
+        command->header.type = T::kType;
+        command->header.size = static_cast<std::uint16_t>(size);
+        return *command;
+    }
+
+    /**
+     * @brief 从线性缓冲区分配空间，容量不足时按两倍增长
+     * @param size 字节数（已对齐）
+     * @param sortKey 命令的排序键
+     * @return 分配的空间
+     */
+    std::uint8_t *allocate(size_t size, std::uint64_t sortKey);
+
+    /**
+     * @brief 确保缓冲区能容纳 size 字节，不足时按两倍增长
+     * @param size 总字节数
+     */
+    void reserve(size_t size);
+
+    /**
+     * @brief 对一段排序项做稳定排序：数量少时插入排序，否则 LSD 基数排序
+     */
+    void sortRange(SortItem *items, size_t count);
+
+    /**
+     * @brief 统计按当前排序项顺序执行时的状态切换次数
+     */
+    void countStateChanges(std::uint32_t &programChanges, std::uint32_t &materialChanges,
+                           std::uint32_t &vertexArrayChanges) const;
 
 private:
-    std::vector<std::unique_ptr<RenderCommand>> m_commands;
+    std::unique_ptr<std::uint8_t[]> m_data;
+    size_t m_capacity;
+    size_t m_used;
+    std::vector<SortItem> m_items;
+    std::vector<SortItem> m_sortScratch; // 基数排序的临时缓冲，跨帧复用
+    bool m_sortEnabled;
+    bool m_sorted;
+    RenderQueueStats m_stats;
 };
 
 #endif // RENDERCOMMAND_H
@@ -1,7 +1,15 @@
 #include "renderpass.h"
+#include "profiler.h"
+#include "renderrevision.h"
+#include <algorithm>
+#include <cstring>
 
 RenderPass::RenderPass()
-    : m_clearMask(GL_COLOR_BUFFER_BIT), m_enabled(true)
+    : m_prepared(false), m_preparedRevision(0), m_parallelRecording(true), m_instanceGroupCount(0),
+      m_instancingStats{}, m_staticBatchSlot(DrawCommand::kNoUniformSlot), m_uniformBlocks(0), m_uniformStats{},
+      m_frameTime(0.0f), m_frameDeltaTime(0.0f),
+      m_frameCount(0), m_commandsValid(false), m_commandCacheEnabled(true),
+      m_recordedRevision(0), m_cacheStats{}, m_nearDepth(0.0f), m_farDepth(100.0f), m_clearMask(GL_COLOR_BUFFER_BIT), m_enabled(true)
 {
     m_clearColor[0] = 0.2f;
     m_clearColor[1] = 0.3f;
@@ -15,6 +23,34 @@ RenderPass::~RenderPass()
 
 RenderPass::RenderPass(RenderPass &&other) noexcept
     : m_gameObjects(std::move(other.m_gameObjects)),
+      m_staticBatches(std::move(other.m_staticBatches)),
+      m_drawList(std::move(other.m_drawList)),
+      m_prepared(other.m_prepared),
+      m_preparedRevision(other.m_preparedRevision),
+      m_commandQueue(std::move(other.m_commandQueue)),
+      m_chunkQueues(std::move(other.m_chunkQueues)),
+      m_parallelRecording(other.m_parallelRecording),
+      m_instanceGroups(std::move(other.m_instanceGroups)),
+      m_instanceGroupCount(other.m_instanceGroupCount),
+      m_instanceGroupIndex(std::move(other.m_instanceGroupIndex)),
+      m_instanceData(std::move(other.m_instanceData)),
+      m_instanceBuffer(std::move(other.m_instanceBuffer)),
+      m_instancingStats(other.m_instancingStats),
+      m_objectSlots(std::move(other.m_objectSlots)),
+      m_objectUniforms(std::move(other.m_objectUniforms)),
+      m_staticBatchSlot(other.m_staticBatchSlot),
+      m_uniformBlocks(other.m_uniformBlocks),
+      m_uniformRing(std::move(other.m_uniformRing)),
+      m_uniformStats(other.m_uniformStats),
+      m_frameTime(other.m_frameTime),
+      m_frameDeltaTime(other.m_frameDeltaTime),
+      m_frameCount(other.m_frameCount),
+      m_commandsValid(false), // 录制的回调命令指向原对象的回调
+      m_commandCacheEnabled(other.m_commandCacheEnabled),
+      m_recordedRevision(other.m_recordedRevision),
+      m_cacheStats(other.m_cacheStats),
+      m_nearDepth(other.m_nearDepth),
+      m_farDepth(other.m_farDepth),
       m_preRenderCallback(std::move(other.m_preRenderCallback)),
       m_postRenderCallback(std::move(other.m_postRenderCallback)),
       m_clearMask(other.m_clearMask),
@@ -31,6 +67,34 @@ RenderPass &RenderPass::operator=(RenderPass &&other) noexcept
     if (this != &other)
     {
         m_gameObjects = std::move(other.m_gameObjects);
+        m_staticBatches = std::move(other.m_staticBatches);
+        m_drawList = std::move(other.m_drawList);
+        m_prepared = other.m_prepared;
+        m_preparedRevision = other.m_preparedRevision;
+        m_commandQueue = std::move(other.m_commandQueue);
+        m_chunkQueues = std::move(other.m_chunkQueues);
+        m_parallelRecording = other.m_parallelRecording;
+        m_instanceGroups = std::move(other.m_instanceGroups);
+        m_instanceGroupCount = other.m_instanceGroupCount;
+        m_instanceGroupIndex = std::move(other.m_instanceGroupIndex);
+        m_instanceData = std::move(other.m_instanceData);
+        m_instanceBuffer = std::move(other.m_instanceBuffer);
+        m_instancingStats = other.m_instancingStats;
+        m_objectSlots = std::move(other.m_objectSlots);
+        m_objectUniforms = std::move(other.m_objectUniforms);
+        m_staticBatchSlot = other.m_staticBatchSlot;
+        m_uniformBlocks = other.m_uniformBlocks;
+        m_uniformRing = std::move(other.m_uniformRing);
+        m_uniformStats = other.m_uniformStats;
+        m_frameTime = other.m_frameTime;
+        m_frameDeltaTime = other.m_frameDeltaTime;
+        m_frameCount = other.m_frameCount;
+        m_commandsValid = false; // 录制的回调命令指向原对象的回调
+        m_commandCacheEnabled = other.m_commandCacheEnabled;
+        m_recordedRevision = other.m_recordedRevision;
+        m_cacheStats = other.m_cacheStats;
+        m_nearDepth = other.m_nearDepth;
+        m_farDepth = other.m_farDepth;
         m_preRenderCallback = std::move(other.m_preRenderCallback);
         m_postRenderCallback = std::move(other.m_postRenderCallback);
         m_clearMask = other.m_clearMask;
@@ -50,16 +114,27 @@ void RenderPass::setClearColor(float r, float g, float b, float a)
     m_clearColor[1] = g;
     m_clearColor[2] = b;
     m_clearColor[3] = a;
+    m_commandsValid = false;
 }
 
 void RenderPass::setClearMask(GLbitfield mask)
 {
     m_clearMask = mask;
+    m_commandsValid = false;
+}
+
+void RenderPass::setSortDepthRange(float nearDepth, float farDepth)
+{
+    m_nearDepth = nearDepth;
+    m_farDepth = farDepth;
+    m_commandsValid = false;
 }
 
 void RenderPass::addGameObject(std::shared_ptr<GameObject> gameObject)
 {
     m_gameObjects.push_back(gameObject);
+    m_prepared = false;
+    m_commandsValid = false;
 }
 
 void RenderPass::removeGameObject(std::shared_ptr<GameObject> gameObject)
@@ -68,17 +143,40 @@ void RenderPass::removeGameObject(std::shared_ptr<GameObject> gameObject)
     if (it != m_gameObjects.end())
     {
         m_gameObjects.erase(it);
+        m_prepared = false;
+        m_commandsValid = false;
+    }
+}
+
+void RenderPass::addStaticBatch(std::shared_ptr<StaticBatch> batch)
+{
+    if (batch)
+    {
+        m_staticBatches.push_back(batch);
+        m_commandsValid = false;
+    }
+}
+
+void RenderPass::removeStaticBatch(std::shared_ptr<StaticBatch> batch)
+{
+    auto it = std::find(m_staticBatches.begin(), m_staticBatches.end(), batch);
+    if (it != m_staticBatches.end())
+    {
+        m_staticBatches.erase(it);
+        m_commandsValid = false;
     }
 }
 
 void RenderPass::setPreRenderCallback(RenderCallback callback)
 {
     m_preRenderCallback = callback;
+    m_commandsValid = false;
 }
 
 void RenderPass::setPostRenderCallback(RenderCallback callback)
 {
     m_postRenderCallback = callback;
+    m_commandsValid = false;
 }
 
 std::vector<std::shared_ptr<Mesh>> RenderPass::getAllMeshes() const
@@ -119,40 +217,407 @@ std::vector<std::shared_ptr<Material>> RenderPass::getAllMaterials() const
     return materials;
 }
 
-void RenderPass::render()
+void RenderPass::prepare()
 {
-    if (!m_enabled)
-        return;
+    // 修订号在读取游戏对象之前记录，准备期间发生的修改会让下一帧重新录制
+    m_preparedRevision = RenderRevision::current();
+    m_drawList.resize(m_gameObjects.size());
+    TaskScheduler::instance().parallelFor(m_gameObjects.size(), kPrepareGrainSize,
+                                          [this](size_t begin, size_t end)
+                                          { prepareRange(begin, end); });
+    m_prepared = true;
+}
+
+Job *RenderPass::createPrepareJob(Job *parent)
+{
+    return TaskScheduler::instance().createJob(
+        [this]()
+        {
+            // 在作业执行时判断缓存，以便看到本帧场景更新做出的修改
+            if (isCommandCacheValid())
+                return;
+
+            m_preparedRevision = RenderRevision::current();
+            m_drawList.resize(m_gameObjects.size());
+            m_prepared = true;
 
-    // 创建渲染命令队列
-    RenderCommandQueue commandQueue;
+            TaskScheduler &scheduler = TaskScheduler::instance();
+            scheduler.run(scheduler.createParallelForJob(m_gameObjects.size(), kPrepareGrainSize,
+                                                         [this](size_t begin, size_t end)
+                                                         { prepareRange(begin, end); },
+                                                         TaskScheduler::currentJob()));
+        },
+        parent);
+}
+
+void RenderPass::prepareRange(size_t begin, size_t end)
+{
+    PROFILE_ZONE("RenderPass::prepare");
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        GameObject *gameObject = m_gameObjects[i].get();
+        bool draw = gameObject && gameObject->isVisible() && !gameObject->getMeshes().empty();
+        m_drawList[i] = draw ? gameObject : nullptr;
+    }
+}
+
+bool RenderPass::isCommandCacheValid()
+{
+    if (!m_commandCacheEnabled || !m_commandsValid)
+        return false;
+
+    // 先读取全局修订号：检查期间的修改得到更大的修订号，下一帧仍会被发现
+    const std::uint64_t current = RenderRevision::current();
+    if (m_recordedRevision == current)
+        return true;
+    if (hasChangesSince(m_recordedRevision))
+        return false;
+
+    m_recordedRevision = current;
+    return true;
+}
+
+bool RenderPass::hasChangesSince(std::uint64_t revision) const
+{
+    PROFILE_ZONE("RenderPass::hasChangesSince");
+
+    for (const auto &gameObject : m_gameObjects)
+    {
+        if (gameObject && gameObject->getRevision() > revision)
+            return true;
+    }
+    for (const auto &batch : m_staticBatches)
+    {
+        if (batch->getRevision() > revision)
+            return true;
+    }
+    return false;
+}
+
+void RenderPass::recordCommands()
+{
+    PROFILE_ZONE("RenderPass::recordCommands");
+
+    // 复用命令缓冲区重新录制
+    m_commandQueue.clear();
 
     // 添加清除命令
-    commandQueue.addCommand(std::make_unique<ClearCommand>(
-        m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3], m_clearMask));
+    m_commandQueue.addClear(m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3], m_clearMask);
 
     // 添加渲染前回调命令
-    if (m_preRenderCallback)
+    m_commandQueue.addCallback(&m_preRenderCallback);
+
+    // 逐对象 uniform 块的槽位按绘制列表顺序分配，串行和并行录制结果一致
+    assignObjectUniforms();
+
+    // 添加游戏对象渲染命令，执行前按材质/VAO/深度排序
+    const float depthScale = m_farDepth > m_nearDepth ? 1.0f / (m_farDepth - m_nearDepth) : 0.0f;
+    const size_t count = m_drawList.size();
+    TaskScheduler &scheduler = TaskScheduler::instance();
+    if (m_parallelRecording && scheduler.isThreaded() && count > kRecordChunkSize)
     {
-        commandQueue.addCommand(m_preRenderCallback);
+        // 分块只取决于对象数量，按块序号合并保证结果确定
+        const size_t chunkCount = (count + kRecordChunkSize - 1) / kRecordChunkSize;
+        if (m_chunkQueues.size() < chunkCount)
+        {
+            m_chunkQueues.resize(chunkCount);
+        }
+
+        scheduler.parallelFor(chunkCount, 1,
+                              [this, count, depthScale](size_t beginChunk, size_t endChunk)
+                              {
+                                  for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+                                  {
+                                      RenderCommandQueue &chunkQueue = m_chunkQueues[chunk];
+                                      chunkQueue.clear();
+                                      size_t begin = chunk * kRecordChunkSize;
+                                      recordRange(chunkQueue, begin, std::min(begin + kRecordChunkSize, count), depthScale);
+                                  }
+                              });
+
+        PROFILE_ZONE("RenderPass::mergeCommands");
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            m_commandQueue.append(m_chunkQueues[chunk]);
+        }
+    }
+    else
+    {
+        recordRange(m_commandQueue, 0, count, depthScale);
     }
 
-    // 添加游戏对象渲染命令
-    for (auto &gameObject : m_gameObjects)
+    // 实例化网格需要看到整个绘制列表才能分组，串行和并行录制都在这里统一处理
+    recordInstances(depthScale);
+
+    // 静态合批按范围剔除不可见对象
+    for (const auto &batch : m_staticBatches)
     {
+        batch->recordCommands(m_commandQueue, m_nearDepth, depthScale, m_staticBatchSlot);
+    }
+
+    // 网格之间不再逐个解绑 VAO，绘制结束后统一解绑
+    m_commandQueue.addBindVertexArray(0);
+
+    // 添加渲染后回调命令
+    m_commandQueue.addCallback(&m_postRenderCallback);
+
+    m_recordedRevision = m_preparedRevision;
+    m_commandsValid = true;
+}
+
+void RenderPass::recordRange(RenderCommandQueue &commandQueue, size_t begin, size_t end, float depthScale) const
+{
+    PROFILE_ZONE("RenderPass::recordRange");
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        GameObject *gameObject = m_drawList[i];
         if (gameObject)
         {
-            commandQueue.addCommand([gameObject]()
-                                    { gameObject->render(); });
+            gameObject->recordCommands(commandQueue, sortDepth(*gameObject, depthScale), m_objectSlots[i]);
         }
     }
+}
 
-    // 添加渲染后回调命令
-    if (m_postRenderCallback)
+void RenderPass::assignObjectUniforms()
+{
+    PROFILE_ZONE("RenderPass::assignObjectUniforms");
+
+    m_objectSlots.assign(m_drawList.size(), DrawCommand::kNoUniformSlot);
+    m_objectUniforms.clear();
+    m_staticBatchSlot = DrawCommand::kNoUniformSlot;
+    m_uniformBlocks = 0;
+
+    auto addBlocks = [this](const Material *material)
+    {
+        for (GLuint block = 0; block < static_cast<GLuint>(UniformBlock::Count); ++block)
+        {
+            if (material->usesUniformBlock(static_cast<UniformBlock>(block)))
+            {
+                m_uniformBlocks |= 1u << block;
+            }
+        }
+    };
+
+    for (size_t i = 0; i < m_drawList.size(); ++i)
+    {
+        const GameObject *gameObject = m_drawList[i];
+        if (!gameObject)
+            continue;
+
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            if (mesh && mesh->getMaterial())
+            {
+                addBlocks(mesh->getMaterial().get());
+            }
+        }
+
+        if (!gameObject->isStaticBatched() && gameObject->usesObjectUniforms())
+        {
+            const size_t first = m_objectUniforms.size();
+            m_objectSlots[i] = static_cast<std::uint32_t>(first);
+            m_objectUniforms.resize(first + gameObject->getObjectUniformCount());
+            gameObject->getObjectUniforms(&m_objectUniforms[first]);
+        }
+    }
+
+    for (const auto &batch : m_staticBatches)
+    {
+        const Material *material = batch->getMaterial().get();
+        if (!material)
+            continue;
+
+        addBlocks(material);
+
+        // 合批的顶点已经变换到世界空间，所有批次共用一个单位模型矩阵的块
+        if (m_staticBatchSlot == DrawCommand::kNoUniformSlot && material->usesUniformBlock(UniformBlock::Object))
+        {
+            m_staticBatchSlot = static_cast<std::uint32_t>(m_objectUniforms.size());
+            ObjectUniforms uniforms = {};
+            uniforms.model[0] = uniforms.model[5] = uniforms.model[10] = uniforms.model[15] = 1.0f;
+            uniforms.color[0] = uniforms.color[1] = uniforms.color[2] = uniforms.color[3] = 1.0f;
+            m_objectUniforms.push_back(uniforms);
+        }
+    }
+}
+
+bool RenderPass::uploadUniforms(ObjectUniformRange &objectUniforms)
+{
+    if (m_uniformBlocks == 0)
+    {
+        m_uniformStats = {};
+        return false;
+    }
+
+    PROFILE_ZONE("RenderPass::uploadUniforms");
+
+    if (!m_uniformRing)
+    {
+        m_uniformRing = std::make_unique<UniformBufferRing>();
+    }
+
+    // 命令缓存有效时块数据不变，但每帧轮换到新的缓冲，需要重新写入
+    UniformBufferRing &ring = *m_uniformRing;
+    ring.beginFrame();
+
+    UniformBufferRing::Allocation frame{};
+    if (m_uniformBlocks & (1u << static_cast<GLuint>(UniformBlock::Frame)))
+    {
+        FrameUniforms uniforms = {{m_frameTime, m_frameDeltaTime, static_cast<float>(m_frameCount), 0.0f}};
+        frame = ring.push(uniforms);
+    }
+
+    UniformBufferRing::Allocation view{};
+    if (m_uniformBlocks & (1u << static_cast<GLuint>(UniformBlock::View)))
+    {
+        // 引擎目前没有相机，视图投影为单位矩阵
+        ViewUniforms uniforms = {};
+        uniforms.viewProjection[0] = uniforms.viewProjection[5] = uniforms.viewProjection[10] =
+            uniforms.viewProjection[15] = 1.0f;
+        uniforms.depthRange[0] = m_nearDepth;
+        uniforms.depthRange[1] = m_farDepth;
+        uniforms.depthRange[2] = m_farDepth > m_nearDepth ? 1.0f / (m_farDepth - m_nearDepth) : 0.0f;
+        view = ring.push(uniforms);
+    }
+
+    const GLsizeiptr stride = ring.alignSize(sizeof(ObjectUniforms));
+    if (!m_objectUniforms.empty())
+    {
+        UniformBufferRing::Allocation objects;
+        std::uint8_t *data = static_cast<std::uint8_t *>(
+            ring.allocate(stride * static_cast<GLsizeiptr>(m_objectUniforms.size()), objects));
+        for (size_t i = 0; i < m_objectUniforms.size(); ++i)
+        {
+            std::memcpy(data + i * stride, &m_objectUniforms[i], sizeof(ObjectUniforms));
+        }
+        objectUniforms = {objects.buffer, objects.offset, stride, static_cast<GLsizeiptr>(sizeof(ObjectUniforms))};
+    }
+
+    ring.flush();
+    if (frame.buffer != 0)
+    {
+        UniformBufferRing::bind(UniformBlock::Frame, frame);
+    }
+    if (view.buffer != 0)
+    {
+        UniformBufferRing::bind(UniformBlock::View, view);
+    }
+
+    m_uniformStats.objectBlocks = static_cast<std::uint32_t>(m_objectUniforms.size());
+    m_uniformStats.bytesUploaded = static_cast<std::uint32_t>(ring.getBytesUsed());
+    return !m_objectUniforms.empty();
+}
+
+void RenderPass::recordInstances(float depthScale)
+{
+    PROFILE_ZONE("RenderPass::recordInstances");
+
+    m_instancingStats = {};
+    m_instanceData.clear();
+    m_instanceGroupIndex.clear();
+    for (size_t i = 0; i < m_instanceGroupCount; ++i)
     {
-        commandQueue.addCommand(m_postRenderCallback);
+        m_instanceGroups[i].objects.clear();
     }
+    m_instanceGroupCount = 0;
+
+    auto addGroup = [this](const Mesh *mesh, float depth) -> InstanceGroup &
+    {
+        if (m_instanceGroupCount == m_instanceGroups.size())
+        {
+            m_instanceGroups.emplace_back();
+        }
+        InstanceGroup &group = m_instanceGroups[m_instanceGroupCount++];
+        group.mesh = mesh;
+        group.nearestDepth = depth;
+        return group;
+    };
+
+    // 分组按第一次出现的顺序，组内按绘制列表顺序，结果与线程数无关
+    for (GameObject *gameObject : m_drawList)
+    {
+        if (!gameObject)
+            continue;
+
+        const float depth = sortDepth(*gameObject, depthScale);
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            if (!mesh || !mesh->isInstanced() || !mesh->isValid() || !mesh->getMaterial())
+                continue;
+
+            if (mesh->getMaterial()->isTranslucent())
+            {
+                addGroup(mesh.get(), depth).objects.push_back(gameObject);
+                continue;
+            }
+
+            auto result = m_instanceGroupIndex.emplace(mesh.get(), m_instanceGroupCount);
+            InstanceGroup &group = result.second ? addGroup(mesh.get(), depth) : m_instanceGroups[result.first->second];
+            group.objects.push_back(gameObject);
+            group.nearestDepth = std::min(group.nearestDepth, depth);
+        }
+    }
+
+    if (m_instanceGroupCount == 0)
+        return;
+
+    if (!m_instanceBuffer)
+    {
+        m_instanceBuffer = std::make_unique<BufferObject>(BufferObject::Type::VertexBuffer);
+    }
+
+    const GLuint instanceBuffer = m_instanceBuffer->getId();
+    for (size_t i = 0; i < m_instanceGroupCount; ++i)
+    {
+        const InstanceGroup &group = m_instanceGroups[i];
+        const size_t first = m_instanceData.size();
+        m_instanceData.resize(first + group.objects.size());
+        for (size_t j = 0; j < group.objects.size(); ++j)
+        {
+            group.objects[j]->getInstanceData(*group.mesh, m_instanceData[first + j]);
+        }
+
+        group.mesh->recordInstancedCommands(m_commandQueue, group.nearestDepth, instanceBuffer,
+                                            first * sizeof(InstanceData), static_cast<GLsizei>(group.objects.size()));
+        ++m_instancingStats.drawCount;
+    }
+    m_instancingStats.instanceCount = static_cast<std::uint32_t>(m_instanceData.size());
+
+    // 录制在 GL 线程上进行，直接上传；命令缓存有效时缓冲区内容保持不变
+    m_instanceBuffer->setData(m_instanceData.data(),
+                              static_cast<GLsizeiptr>(m_instanceData.size() * sizeof(InstanceData)),
+                              BufferObject::Usage::StreamDraw);
+}
+
+void RenderPass::render()
+{
+    if (!m_enabled)
+        return;
+
+    PROFILE_ZONE("RenderPass::render");
+
+    if (isCommandCacheValid())
+    {
+        ++m_cacheStats.hits;
+    }
+    else
+    {
+        ++m_cacheStats.misses;
+        if (!m_prepared || m_drawList.size() != m_gameObjects.size())
+        {
+            prepare();
+        }
+        recordCommands();
+    }
+
+    // 写入本帧的 uniform 块，再执行所有渲染命令（已排序的命令重放时不再排序）
+    ObjectUniformRange objectUniforms{};
+    const bool hasObjectUniforms = uploadUniforms(objectUniforms);
+    m_commandQueue.executeAll(hasObjectUniforms ? &objectUniforms : nullptr);
+    ++m_frameCount;
 
-    // 执行所有渲染命令
-    commandQueue.executeAll();
+    // 下一帧需要重新准备
+    m_prepared = false;
 }
@@ -1,12 +1,19 @@
 #ifndef RENDERPASS_H
 #define RENDERPASS_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <unordered_map>
 #include "gameobject.h"
 #include "rendercommand.h"
+#include "bufferobject.h"
+#include "instancing.h"
+#include "staticbatch.h"
+#include "uniformbufferring.h"
+#include "taskscheduler.h"
 
 /**
  * @brief 渲染过程类
@@ -21,6 +28,39 @@ public:
      */
     using RenderCallback = std::function<void()>;
 
+    /**
+     * @brief 命令缓存统计
+     */
+    struct CommandCacheStats
+    {
+        std::uint64_t hits;   // 直接重放缓存命令的帧数
+        std::uint64_t misses; // 重新录制命令的帧数
+
+        /**
+         * @brief 命中率
+         * @return [0, 1]，没有渲染过时为 0
+         */
+        double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    /**
+     * @brief 实例化统计（最近一次录制）
+     */
+    struct InstancingStats
+    {
+        std::uint32_t drawCount;     // 实例化绘制次数
+        std::uint32_t instanceCount; // 实例总数
+    };
+
+    /**
+     * @brief uniform 块统计（最近一帧）
+     */
+    struct UniformStats
+    {
+        std::uint32_t objectBlocks; // 逐对象 uniform 块数量
+        std::uint32_t bytesUploaded; // 上传到 uniform 缓冲环的字节数（含对齐填充）
+    };
+
     RenderPass();
     ~RenderPass();
 
@@ -59,6 +99,18 @@ public:
      */
     void removeGameObject(std::shared_ptr<GameObject> gameObject);
 
+    /**
+     * @brief 添加静态合批（见 Scene::getStaticBatches）
+     * @param batch 静态合批
+     */
+    void addStaticBatch(std::shared_ptr<StaticBatch> batch);
+
+    /**
+     * @brief 移除静态合批
+     * @param batch 静态合批
+     */
+    void removeStaticBatch(std::shared_ptr<StaticBatch> batch);
+
     /**
      * @brief 获取所有游戏对象
      * @return 游戏对象列表
@@ -90,10 +142,113 @@ public:
     void setPostRenderCallback(RenderCallback callback);
 
     /**
-     * @brief 执行渲染过程
+     * @brief 准备渲染：并行收集本帧需要绘制的游戏对象
+     *
+     * 不调用任何 GL 函数，可以在工作线程上执行；render() 之前未准备时会自动准备
+     */
+    void prepare();
+
+    /**
+     * @brief 创建渲染准备作业，可与场景更新等帧作业组成依赖图
+     * @param parent 父作业
+     * @return 作业（尚未提交）
+     */
+    Job *createPrepareJob(Job *parent = nullptr);
+
+    /**
+     * @brief 执行渲染过程（必须在持有 GL 上下文的线程上调用）
      */
     void render();
 
+    /**
+     * @brief 设置排序使用的视图深度范围
+     *
+     * 引擎目前没有相机，按 OpenGL 约定假设视点在原点、朝向 -Z，
+     * 游戏对象的深度为 -z，映射到 [nearDepth, farDepth] 后量化进绘制排序键
+     * @param nearDepth 最近深度
+     * @param farDepth 最远深度
+     */
+    void setSortDepthRange(float nearDepth, float farDepth);
+
+    /**
+     * @brief 启用/禁用绘制排序
+     * @param enabled 是否排序
+     */
+    void setSortEnabled(bool enabled)
+    {
+        m_commandQueue.setSortEnabled(enabled);
+        m_commandsValid = false;
+    }
+
+    /**
+     * @brief 获取上一次渲染的命令队列统计（状态切换次数等）
+     * @return 统计数据
+     */
+    const RenderQueueStats &getCommandStats() const { return m_commandQueue.getStats(); }
+
+    /**
+     * @brief 启用/禁用并行录制
+     *
+     * 启用且任务调度器有工作线程时，绘制列表按固定大小分块，每块由一个作业录制到自己的命令队列，
+     * 再按分块顺序合并到主队列后统一按绘制键排序。分块与线程数无关，
+     * 合并结果与串行录制逐字节相同
+     * @param enabled 是否启用
+     */
+    void setParallelRecordingEnabled(bool enabled) { m_parallelRecording = enabled; }
+
+    /**
+     * @brief 检查是否启用并行录制
+     * @return 是否启用
+     */
+    bool isParallelRecordingEnabled() const { return m_parallelRecording; }
+
+    /**
+     * @brief 获取最近一次录制的实例化统计
+     * @return 统计数据
+     */
+    const InstancingStats &getInstancingStats() const { return m_instancingStats; }
+
+    /**
+     * @brief 启用/禁用命令缓存
+     *
+     * 启用时录制的命令列表会被保留，直到本渲染过程的对象增删、可见性、变换、网格或材质着色器改变
+     * （见 RenderRevision，其他渲染过程中对象的修改不影响）或渲染过程自身的设置改变，期间每帧直接重放
+     * @param enabled 是否启用
+     */
+    void setCommandCacheEnabled(bool enabled)
+    {
+        m_commandCacheEnabled = enabled;
+        m_commandsValid = false;
+    }
+
+    /**
+     * @brief 获取命令缓存统计
+     * @return 统计数据
+     */
+    const CommandCacheStats &getCommandCacheStats() const { return m_cacheStats; }
+
+    /**
+     * @brief 清零命令缓存统计
+     */
+    void resetCommandCacheStats() { m_cacheStats = {}; }
+
+    /**
+     * @brief 设置写入 FrameBlock 的时间
+     * @param time 时间（秒）
+     * @param deltaTime 帧间隔（秒）
+     */
+    void setFrameTime(float time, float deltaTime)
+    {
+        m_frameTime = time;
+        m_frameDeltaTime = deltaTime;
+    }
+
+    /**
+     * @brief 获取最近一帧的 uniform 块统计
+     * @return 统计数据
+     */
+    const UniformStats &getUniformStats() const { return m_uniformStats; }
+
     /**
      * @brief 启用/禁用渲染过程
      * @param enabled 是否启用
@@ -107,7 +262,109 @@ public:
     bool isEnabled() const { return m_enabled; }
 
 private:
+    /**
+     * @brief 收集 [begin, end) 范围内可见且有网格的游戏对象
+     */
+    void prepareRange(size_t begin, size_t end);
+
+    /**
+     * @brief 检查缓存的命令列表是否仍然有效
+     *
+     * 全局修订号改变时检查本渲染过程的游戏对象和静态合批，都没有比录制时更新的修改时
+     * 把录制的修订号推进到当前值，缓存继续有效
+     */
+    bool isCommandCacheValid();
+
+    /**
+     * @brief 检查本渲染过程引用的内容是否有修订号大于 revision 的修改
+     */
+    bool hasChangesSince(std::uint64_t revision) const;
+
+    /**
+     * @brief 根据绘制列表重新录制命令
+     */
+    void recordCommands();
+
+    /**
+     * @brief 把绘制列表 [begin, end) 范围内的游戏对象录制到指定队列
+     */
+    void recordRange(RenderCommandQueue &commandQueue, size_t begin, size_t end, float depthScale) const;
+
+    /**
+     * @brief 按网格合并实例化网格的游戏对象，打包实例数据并为每组录制一次实例化绘制
+     *
+     * 不透明的组按最近的实例排序；半透明材质需要由远到近，每个对象单独成组
+     */
+    void recordInstances(float depthScale);
+
+    /**
+     * @brief 为绘制列表中使用 ObjectBlock 的游戏对象分配槽位并保存块数据，
+     *        同时收集录制的材质声明了哪些 uniform 块
+     */
+    void assignObjectUniforms();
+
+    /**
+     * @brief 把本帧的 FrameBlock、ViewBlock 和逐对象块写入 uniform 缓冲环并绑定前两者
+     * @param objectUniforms 输出逐对象块的位置
+     * @return 是否有逐对象块
+     */
+    bool uploadUniforms(ObjectUniformRange &objectUniforms);
+
+    /**
+     * @brief 游戏对象用于排序的归一化深度
+     */
+    float sortDepth(const GameObject &gameObject, float depthScale) const
+    {
+        return (-gameObject.getPosition()[2] - m_nearDepth) * depthScale;
+    }
+
+private:
+    // 每个准备作业最多处理的游戏对象数量
+    static constexpr size_t kPrepareGrainSize = 256;
+
+    // 并行录制时每块的游戏对象数量，绘制列表不超过一块时串行录制
+    static constexpr size_t kRecordChunkSize = 2048;
+
     std::vector<std::shared_ptr<GameObject>> m_gameObjects;
+    std::vector<std::shared_ptr<StaticBatch>> m_staticBatches;
+    std::vector<GameObject *> m_drawList; // 与 m_gameObjects 一一对应，不需要绘制的为 nullptr
+    bool m_prepared;
+    std::uint64_t m_preparedRevision;  // 准备绘制列表时的渲染修订号
+    RenderCommandQueue m_commandQueue; // 跨帧保留，缓存有效时直接重放
+    std::vector<RenderCommandQueue> m_chunkQueues; // 并行录制的分块队列，跨帧复用
+    bool m_parallelRecording;
+
+    /**
+     * @brief 一组共享网格的实例
+     */
+    struct InstanceGroup
+    {
+        const Mesh *mesh;
+        std::vector<const GameObject *> objects;
+        float nearestDepth;
+    };
+
+    std::vector<InstanceGroup> m_instanceGroups; // 前 m_instanceGroupCount 个有效，跨帧复用
+    size_t m_instanceGroupCount;
+    std::unordered_map<const Mesh *, size_t> m_instanceGroupIndex;
+    std::vector<InstanceData> m_instanceData;      // 按组连续打包
+    std::unique_ptr<BufferObject> m_instanceBuffer; // 第一次需要时创建
+    InstancingStats m_instancingStats;
+    std::vector<std::uint32_t> m_objectSlots;       // 与 m_drawList 一一对应的 ObjectBlock 槽位
+    std::vector<ObjectUniforms> m_objectUniforms;   // 按槽位排列，录制时填写，每帧拷贝到缓冲环
+    std::uint32_t m_staticBatchSlot;                // 静态合批共用的单位模型矩阵槽位（顶点已预变换）
+    unsigned int m_uniformBlocks;                   // 录制的材质声明的 uniform 块，按 UniformBlock 取位
+    std::unique_ptr<UniformBufferRing> m_uniformRing; // 第一次需要时创建
+    UniformStats m_uniformStats;
+    float m_frameTime;
+    float m_frameDeltaTime;
+    std::uint64_t m_frameCount;
+    bool m_commandsValid;
+    bool m_commandCacheEnabled;
+    std::uint64_t m_recordedRevision; // 录制的命令对应的渲染修订号
+    CommandCacheStats m_cacheStats;
+    float m_nearDepth;
+    float m_farDepth;
     RenderCallback m_preRenderCallback;
     RenderCallback m_postRenderCallback;
     float m_clearColor[4];
@@ -1,4 +1,7 @@
 #include "renderpipeline.h"
+#include "profiler.h"
+#include "shadercache.h"
+#include <algorithm>
 
 RenderPipeline::RenderPipeline()
 {
@@ -79,8 +82,37 @@ bool RenderPipeline::isRenderPassEnabled(const std::string &name) const
     return false;
 }
 
+Job *RenderPipeline::createPrepareJob(Job *parent)
+{
+    std::vector<RenderPass *> renderPasses;
+    for (const auto &name : m_renderOrder)
+    {
+        auto renderPass = getRenderPass(name);
+        if (renderPass && renderPass->isEnabled())
+        {
+            renderPasses.push_back(renderPass.get());
+        }
+    }
+
+    // 子作业在汇合作业执行时才创建，因此汇合作业可以作为其他作业的后续作业
+    return TaskScheduler::instance().createJob([renderPasses]()
+                                               {
+                                                   TaskScheduler &scheduler = TaskScheduler::instance();
+                                                   for (RenderPass *renderPass : renderPasses)
+                                                   {
+                                                       scheduler.run(renderPass->createPrepareJob(TaskScheduler::currentJob()));
+                                                   }
+                                               },
+                                               parent);
+}
+
 void RenderPipeline::render()
 {
+    PROFILE_ZONE("RenderPipeline::render");
+
+    // 完成编译的程序在本帧开始使用，反射结果变化会让渲染过程重新录制命令
+    ShaderCache::instance().update();
+
     // 按照渲染顺序执行所有启用的渲染过程
     for (const auto &name : m_renderOrder)
     {
@@ -60,6 +60,13 @@ public:
      */
     bool isRenderPassEnabled(const std::string &name) const;
 
+    /**
+     * @brief 创建所有启用渲染过程的准备作业，各渲染过程的准备作业并行执行
+     * @param parent 父作业
+     * @return 汇合作业（尚未提交），所有渲染过程准备完成后完成
+     */
+    Job *createPrepareJob(Job *parent = nullptr);
+
     /**
      * @brief 执行整个渲染管线
      */
@@ -0,0 +1,35 @@
+#ifndef RENDERREVISION_H
+#define RENDERREVISION_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 渲染数据的全局修订号
+ *
+ * 游戏对象、网格、材质、着色器和静态合批中会改变录制命令的修改（可见性、变换、网格、着色器、半透明等）
+ * 都会递增修订号，并把新的值记录为该对象自己的修订号（各类的 getRevision()）。
+ * RenderPass 先比较全局修订号：没有变化时缓存一定有效；有变化时只检查自己引用的对象，
+ * 其他渲染过程中的修改不会让它重新录制。
+ * 材质的 uniform 属性在执行时才读取，修改它们不需要重新录制。可以在工作线程上调用
+ */
+class RenderRevision
+{
+public:
+    /**
+     * @brief 获取当前修订号
+     * @return 修订号
+     */
+    static std::uint64_t current() { return s_revision.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 标记渲染数据已修改
+     * @return 新的修订号，由被修改的对象记录
+     */
+    static std::uint64_t bump() { return s_revision.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+private:
+    static inline std::atomic<std::uint64_t> s_revision{0};
+};
+
+#endif // RENDERREVISION_H
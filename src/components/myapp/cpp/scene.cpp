@@ -1,4 +1,7 @@
 #include "scene.h"
+#include "profiler.h"
+#include "material.h"
+#include <algorithm>
 
 Scene::Scene()
     : m_name("DefaultScene")
@@ -18,7 +21,8 @@ Scene::~Scene()
 Scene::Scene(Scene &&other) noexcept
     : m_name(std::move(other.m_name)),
       m_gameObjects(std::move(other.m_gameObjects)),
-      m_gameObjectMap(std::move(other.m_gameObjectMap))
+      m_gameObjectMap(std::move(other.m_gameObjectMap)),
+      m_staticBatches(std::move(other.m_staticBatches))
 {
 }
 
@@ -29,6 +33,7 @@ Scene &Scene::operator=(Scene &&other) noexcept
         m_name = std::move(other.m_name);
         m_gameObjects = std::move(other.m_gameObjects);
         m_gameObjectMap = std::move(other.m_gameObjectMap);
+        m_staticBatches = std::move(other.m_staticBatches);
     }
     return *this;
 }
@@ -62,6 +67,16 @@ void Scene::removeGameObject(std::shared_ptr<GameObject> gameObject)
         m_gameObjects.erase(it);
     }
 
+    // 合批中的范围引用该对象，移出场景后不再绘制
+    if (gameObject->isStaticBatched())
+    {
+        for (auto &batch : m_staticBatches)
+        {
+            batch->removeOwner(gameObject.get());
+        }
+        gameObject->setStaticBatched(false);
+    }
+
     // 从映射中移除
     auto mapIt = m_gameObjectMap.find(gameObject->getName());
     if (mapIt != m_gameObjectMap.end() && mapIt->second == gameObject)
@@ -92,6 +107,7 @@ std::vector<std::string> Scene::getGameObjectNames() const
 
 void Scene::clear()
 {
+    releaseStaticBatches();
     m_gameObjects.clear();
     m_gameObjectMap.clear();
 }
@@ -106,16 +122,134 @@ void Scene::initialize()
             gameObject->initialize();
         }
     }
+
+    buildStaticBatches();
 }
 
-void Scene::update(float deltaTime)
+void Scene::releaseStaticBatches()
 {
-    // 更新所有游戏对象
+    // 渲染过程可能仍持有旧的合批，清空范围表使其不再绘制
+    for (auto &batch : m_staticBatches)
+    {
+        batch->clearRanges();
+    }
+    m_staticBatches.clear();
+
     for (auto &gameObject : m_gameObjects)
     {
         if (gameObject)
         {
-            gameObject->update(deltaTime);
+            gameObject->setStaticBatched(false);
+        }
+    }
+}
+
+void Scene::buildStaticBatches()
+{
+    PROFILE_ZONE("Scene::buildStaticBatches");
+
+    releaseStaticBatches();
+
+    // 按材质分组，组的顺序为第一次出现的顺序
+    std::unordered_map<const Material *, size_t> batchIndex;
+    for (auto &gameObject : m_gameObjects)
+    {
+        if (!gameObject || !gameObject->isStatic() || gameObject->getMeshes().empty())
+            continue;
+
+        bool batchable = true;
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            if (!mesh || !StaticBatch::canBatch(*mesh) || mesh->getMaterial()->isTranslucent())
+            {
+                batchable = false;
+                break;
+            }
+        }
+        if (!batchable)
+            continue;
+
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            const std::shared_ptr<Material> &material = mesh->getMaterial();
+            auto result = batchIndex.emplace(material.get(), m_staticBatches.size());
+            if (result.second)
+            {
+                m_staticBatches.push_back(std::make_shared<StaticBatch>(material));
+            }
+            m_staticBatches[result.first->second]->add(*gameObject, *mesh);
+        }
+        gameObject->setStaticBatched(true);
+    }
+
+    for (auto &batch : m_staticBatches)
+    {
+        batch->build();
+    }
+
+    // 合批已经拥有预变换的顶点，网格的 CPU 副本不再需要
+    for (auto &gameObject : m_gameObjects)
+    {
+        if (!gameObject || !gameObject->isStaticBatched())
+            continue;
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            mesh->releaseGeometry();
+        }
+    }
+}
+
+size_t Scene::deduplicateMaterials(MaterialRegistry &registry)
+{
+    PROFILE_ZONE("Scene::deduplicateMaterials");
+
+    size_t replaced = 0;
+    for (auto &gameObject : m_gameObjects)
+    {
+        if (!gameObject)
+            continue;
+
+        for (const auto &mesh : gameObject->getMeshes())
+        {
+            if (!mesh || !mesh->getMaterial())
+                continue;
+
+            std::shared_ptr<Material> material = registry.intern(mesh->getMaterial());
+            if (material != mesh->getMaterial())
+            {
+                mesh->setMaterial(material);
+                ++replaced;
+            }
+        }
+    }
+    return replaced;
+}
+
+void Scene::update(float deltaTime)
+{
+    // 并行更新所有游戏对象
+    TaskScheduler::instance().parallelFor(m_gameObjects.size(), kUpdateGrainSize,
+                                          [this, deltaTime](size_t begin, size_t end)
+                                          { updateRange(begin, end, deltaTime); });
+}
+
+Job *Scene::createUpdateJob(float deltaTime, Job *parent)
+{
+    return TaskScheduler::instance().createParallelForJob(m_gameObjects.size(), kUpdateGrainSize,
+                                                          [this, deltaTime](size_t begin, size_t end)
+                                                          { updateRange(begin, end, deltaTime); },
+                                                          parent);
+}
+
+void Scene::updateRange(size_t begin, size_t end, float deltaTime)
+{
+    PROFILE_ZONE("Scene::update");
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (m_gameObjects[i])
+        {
+            m_gameObjects[i]->update(deltaTime);
         }
     }
 }
@@ -130,4 +264,9 @@ void Scene::render()
             gameObject->render();
         }
     }
+
+    for (auto &batch : m_staticBatches)
+    {
+        batch->render();
+    }
 }
@@ -6,6 +6,9 @@
 #include <memory>
 #include <unordered_map>
 #include "gameobject.h"
+#include "taskscheduler.h"
+#include "staticbatch.h"
+#include "materialregistry.h"
 
 /**
  * @brief 场景类
@@ -88,25 +91,72 @@ public:
     size_t getGameObjectCount() const { return m_gameObjects.size(); }
 
     /**
-     * @brief 场景初始化
+     * @brief 场景初始化：初始化所有游戏对象，并把静态对象按材质合批
      */
     virtual void initialize();
 
+    /**
+     * @brief 重新构建静态合批
+     *
+     * 静态对象（GameObject::setStatic）的所有网格都能合批时才会被合批，
+     * 网格需要通过 Mesh::setKeepGeometry() 保留 CPU 副本，合批后副本被释放，
+     * 因此再次构建时这些网格改为逐对象绘制。半透明材质需要逐对象排序，不参与合批
+     */
+    void buildStaticBatches();
+
+    /**
+     * @brief 合并内容相同的材质：把所有网格的材质替换为注册表中内容相同的材质
+     *
+     * 应在 initialize() 之前调用，使合并后的网格落入同一个静态合批
+     * @param registry 材质注册表
+     * @return 替换了材质的网格数量
+     */
+    size_t deduplicateMaterials(MaterialRegistry &registry);
+
+    /**
+     * @brief 获取静态合批，需要添加到渲染过程中绘制
+     * @return 合批列表
+     */
+    const std::vector<std::shared_ptr<StaticBatch>> &getStaticBatches() const { return m_staticBatches; }
+
     /**
      * @brief 场景更新
      * @param deltaTime 时间增量
      */
     virtual void update(float deltaTime);
 
+    /**
+     * @brief 创建场景更新作业，按对象并行更新，可与其他帧作业组成依赖图
+     * @param deltaTime 时间增量
+     * @param parent 父作业
+     * @return 作业（尚未提交）
+     */
+    Job *createUpdateJob(float deltaTime, Job *parent = nullptr);
+
     /**
      * @brief 场景渲染
      */
     virtual void render();
 
 private:
+    /**
+     * @brief 更新 [begin, end) 范围内的游戏对象
+     */
+    void updateRange(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief 释放静态合批，已合批的对象恢复单独绘制
+     */
+    void releaseStaticBatches();
+
+private:
+    // 每个更新作业最多处理的游戏对象数量
+    static constexpr size_t kUpdateGrainSize = 64;
+
     std::string m_name;
     std::vector<std::shared_ptr<GameObject>> m_gameObjects;
     std::unordered_map<std::string, std::shared_ptr<GameObject>> m_gameObjectMap;
+    std::vector<std::shared_ptr<StaticBatch>> m_staticBatches;
 };
 
 #endif // SCENE_H
@@ -1,4 +1,7 @@
 #include "shader.h"
+#include "glstate.h"
+#include "renderrevision.h"
+#include <cstring>
 
 Shader::Shader(const char *vertexPath, const char *fragmentPath)
 {
@@ -31,15 +34,8 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
     }
 
-    // 使用从内存编译的方法
-    unsigned int vertexShader = compileShader(vertexCode.c_str(), GL_VERTEX_SHADER);
-    unsigned int fragmentShader = compileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER);
-
-    m_IsValid = linkProgram(vertexShader, fragmentShader);
-
-    // 删除着色器，它们已经链接到我们的程序中了，已经不再需要了
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    submit(vertexCode.c_str(), fragmentCode.c_str());
+    finish();
 }
 
 Shader::Shader(const char *vertexSource, const char *fragmentSource, bool fromMemory)
@@ -51,20 +47,30 @@ Shader::Shader(const char *vertexSource, const char *fragmentSource, bool fromMe
     }
 
     // 直接从内存源码编译着色器
-    unsigned int vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
-    unsigned int fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
-
-    m_IsValid = linkProgram(vertexShader, fragmentShader);
+    submit(vertexSource, fragmentSource);
+    finish();
+}
 
-    // 删除着色器，它们已经链接到我们的程序中了，已经不再需要了
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+Shader::Shader(const char *vertexSource, const char *fragmentSource, CompileMode mode)
+{
+    submit(vertexSource, fragmentSource);
+    if (mode == CompileMode::Immediate)
+    {
+        finish();
+    }
 }
 
 Shader::~Shader()
 {
-    if (m_IsValid)
+    if (m_pending)
+    {
+        glDeleteShader(m_vertexShader);
+        glDeleteShader(m_fragmentShader);
+        glDeleteProgram(ID);
+    }
+    else if (m_IsValid)
     {
+        GLState::programDeleted(ID);
         glDeleteProgram(ID);
     }
 }
@@ -73,8 +79,28 @@ void Shader::use()
 {
     if (m_IsValid)
     {
-        glUseProgram(ID);
+        GLState::useProgram(ID);
+    }
+}
+
+bool Shader::poll(bool wait)
+{
+    if (!m_pending)
+        return true;
+
+    if (!wait && GLState::isParallelShaderCompileSupported())
+    {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &completed);
+        if (!completed)
+            return false;
     }
+
+    finish();
+
+    // 反射结果（uniform 块等）影响录制的命令
+    m_revision = RenderRevision::bump();
+    return true;
 }
 
 unsigned int Shader::compileShader(const char *source, GLenum shaderType)
@@ -82,7 +108,11 @@ unsigned int Shader::compileShader(const char *source, GLenum shaderType)
     unsigned int shader = glCreateShader(shaderType);
     glShaderSource(shader, 1, &source, NULL);
     glCompileShader(shader);
+    return shader;
+}
 
+bool Shader::checkCompileStatus(unsigned int shader, GLenum shaderType)
+{
     // 检查编译错误
     int success;
     char infoLog[512];
@@ -93,17 +123,28 @@ unsigned int Shader::compileShader(const char *source, GLenum shaderType)
         std::string shaderTypeStr = (shaderType == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
         std::cout << "ERROR::SHADER::" << shaderTypeStr << "::COMPILATION_FAILED\n"
                   << infoLog << std::endl;
+        return false;
     }
-
-    return shader;
+    return true;
 }
 
-bool Shader::linkProgram(unsigned int vertexShader, unsigned int fragmentShader)
+void Shader::submit(const char *vertexSource, const char *fragmentSource)
 {
+    // 编译和链接都只提交，驱动可以在后台完成，直到查询结果时才需要等待
+    m_vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
+    m_fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
+
     ID = glCreateProgram();
-    glAttachShader(ID, vertexShader);
-    glAttachShader(ID, fragmentShader);
+    glAttachShader(ID, m_vertexShader);
+    glAttachShader(ID, m_fragmentShader);
     glLinkProgram(ID);
+    m_pending = true;
+}
+
+void Shader::finish()
+{
+    checkCompileStatus(m_vertexShader, GL_VERTEX_SHADER);
+    checkCompileStatus(m_fragmentShader, GL_FRAGMENT_SHADER);
 
     // 检查链接错误
     int success;
@@ -114,48 +155,172 @@ bool Shader::linkProgram(unsigned int vertexShader, unsigned int fragmentShader)
         glGetProgramInfoLog(ID, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
                   << infoLog << std::endl;
-        return false;
+        m_IsValid = false;
+    }
+    else
+    {
+        reflect();
+        m_IsValid = true;
     }
 
-    return true;
+    // 删除着色器，它们已经链接到我们的程序中了，已经不再需要了
+    glDeleteShader(m_vertexShader);
+    glDeleteShader(m_fragmentShader);
+    m_vertexShader = 0;
+    m_fragmentShader = 0;
+    m_pending = false;
 }
 
-void Shader::setBool(const std::string &name, bool value) const
+void Shader::reflect()
 {
-    if (m_IsValid)
+    m_uniforms.clear();
+    m_uniformIndex.clear();
+    m_uniformBlockNames.clear();
+    m_uniformBlocks = 0;
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+    for (GLint i = 0; i < count; ++i)
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size, &type,
+                           name.data());
+
+        // uniform 块的成员没有位置
+        GLint location = glGetUniformLocation(ID, name.data());
+        if (location < 0)
+            continue;
+
+        UniformHandle handle = static_cast<UniformHandle>(m_uniforms.size());
+        m_uniforms.push_back({std::string(name.data(), static_cast<size_t>(length)), location, type, size});
+        const std::string &uniformName = m_uniforms.back().name;
+        m_uniformIndex.emplace(uniformName, handle);
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+        {
+            m_uniformIndex.emplace(uniformName.substr(0, uniformName.size() - 3), handle);
+        }
+    }
+    m_uniformValues.assign(m_uniforms.size(), UniformValue{});
+
+    GLint blockCount = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    name.assign(static_cast<size_t>(maxLength > 0 ? maxLength : 1), '\0');
+    for (GLint i = 0; i < blockCount; ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(ID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length,
+                                    name.data());
+        m_uniformBlockNames.emplace_back(name.data(), static_cast<size_t>(length));
+
+        for (GLuint block = 0; block < static_cast<GLuint>(UniformBlock::Count); ++block)
+        {
+            if (m_uniformBlockNames.back() == uniformBlockName(static_cast<UniformBlock>(block)))
+            {
+                glUniformBlockBinding(ID, static_cast<GLuint>(i), block);
+                m_uniformBlocks |= 1u << block;
+            }
+        }
     }
 }
 
-void Shader::setInt(const std::string &name, int value) const
+Shader::UniformHandle Shader::findUniform(const std::string &name) const
 {
-    if (m_IsValid)
+    auto it = m_uniformIndex.find(name);
+    return it != m_uniformIndex.end() ? it->second : kInvalidUniform;
+}
+
+bool Shader::updateCachedValue(UniformHandle handle, const std::uint32_t (&words)[4]) const
+{
+    UniformValue &cached = m_uniformValues[handle];
+    if (cached.known && std::memcmp(cached.words, words, sizeof(words)) == 0)
+        return false;
+
+    std::memcpy(cached.words, words, sizeof(words));
+    cached.known = true;
+    ++m_uniformWrites;
+    return true;
+}
+
+void Shader::setInt(UniformHandle handle, int value) const
+{
+    if (handle < 0 || handle >= static_cast<UniformHandle>(m_uniforms.size()))
+        return;
+
+    std::uint32_t words[4] = {static_cast<std::uint32_t>(value), 0, 0, 0};
+    if (updateCachedValue(handle, words))
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1i(m_uniforms[handle].location, value);
     }
 }
 
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::setFloat(UniformHandle handle, float value) const
 {
-    if (m_IsValid)
+    if (handle < 0 || handle >= static_cast<UniformHandle>(m_uniforms.size()))
+        return;
+
+    std::uint32_t words[4] = {};
+    std::memcpy(words, &value, sizeof(value));
+    if (updateCachedValue(handle, words))
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1f(m_uniforms[handle].location, value);
     }
 }
 
-void Shader::setVec3(const std::string &name, float x, float y, float z) const
+void Shader::setVec3(UniformHandle handle, float x, float y, float z) const
 {
-    if (m_IsValid)
+    if (handle < 0 || handle >= static_cast<UniformHandle>(m_uniforms.size()))
+        return;
+
+    const float values[3] = {x, y, z};
+    std::uint32_t words[4] = {};
+    std::memcpy(words, values, sizeof(values));
+    if (updateCachedValue(handle, words))
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        glUniform3f(m_uniforms[handle].location, x, y, z);
     }
 }
 
-void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
+void Shader::setVec4(UniformHandle handle, float x, float y, float z, float w) const
 {
-    if (m_IsValid)
+    if (handle < 0 || handle >= static_cast<UniformHandle>(m_uniforms.size()))
+        return;
+
+    const float values[4] = {x, y, z, w};
+    std::uint32_t words[4];
+    std::memcpy(words, values, sizeof(values));
+    if (updateCachedValue(handle, words))
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        glUniform4f(m_uniforms[handle].location, x, y, z, w);
     }
 }
+
+void Shader::setBool(const std::string &name, bool value) const
+{
+    setInt(findUniform(name), value ? 1 : 0);
+}
+
+void Shader::setInt(const std::string &name, int value) const
+{
+    setInt(findUniform(name), value);
+}
+
+void Shader::setFloat(const std::string &name, float value) const
+{
+    setFloat(findUniform(name), value);
+}
+
+void Shader::setVec3(const std::string &name, float x, float y, float z) const
+{
+    setVec3(findUniform(name), x, y, z);
+}
+
+void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
+{
+    setVec4(findUniform(name), x, y, z, w);
+}
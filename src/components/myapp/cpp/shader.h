@@ -1,9 +1,13 @@
 #ifndef SHADER_H
 #define SHADER_H
 
-#include <GLES3/gl3.h>
+#include "glapi.h"
+#include "uniformbufferring.h"
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -11,6 +15,26 @@
 class Shader
 {
 public:
+    // uniform 句柄：反射表中的序号，链接后不变
+    using UniformHandle = int;
+    static constexpr UniformHandle kInvalidUniform = -1;
+
+    // 链接时反射得到的活动 uniform（uniform 块的成员不在其中）
+    struct UniformInfo
+    {
+        std::string name; // 数组为 "name[0]"
+        GLint location;
+        GLenum type;
+        GLint size; // 数组长度，非数组为 1
+    };
+
+    // 编译方式
+    enum class CompileMode
+    {
+        Immediate, // 构造时完成编译和链接并检查结果
+        Deferred   // 构造时只提交编译和链接，之后由 poll() 在完成时检查结果
+    };
+
     // 程序ID
     unsigned int ID;
     bool m_IsValid = false;
@@ -21,15 +45,49 @@ public:
     // 从内存源码构造着色器
     Shader(const char *vertexSource, const char *fragmentSource, bool fromMemory);
 
+    // 从内存源码构造着色器，按 mode 决定是否等待链接完成
+    Shader(const char *vertexSource, const char *fragmentSource, CompileMode mode);
+
     ~Shader();
 
     // 使用/激活程序
     void use();
 
-    // 检查着色器是否有效
+    // 检查着色器是否有效（延迟编译的程序在完成前无效）
     bool isValid() const { return m_IsValid; }
 
-    // uniform工具函数
+    // 检查延迟编译的程序是否还没有完成
+    bool isPending() const { return m_pending; }
+
+    // 检查延迟编译的程序是否完成，完成时检查结果并反射。
+    // 有 KHR_parallel_shader_compile 时通过 GL_COMPLETION_STATUS_KHR 查询，不会阻塞；
+    // 没有扩展或 wait 为 true 时直接检查结果（可能等待驱动完成编译）。返回是否已经完成
+    bool poll(bool wait = false);
+
+    // 检查程序是否声明了引擎约定的 uniform 块（链接时已绑定到 UniformBlock 对应的绑定点）
+    bool hasUniformBlock(UniformBlock block) const { return (m_uniformBlocks & (1u << static_cast<GLuint>(block))) != 0; }
+
+    // 按名称查找 uniform 句柄（数组可以用 "name" 或 "name[0]"），不存在或被编译器优化掉时返回 kInvalidUniform
+    UniformHandle findUniform(const std::string &name) const;
+
+    // 反射表
+    const std::vector<UniformInfo> &getUniforms() const { return m_uniforms; }
+    const std::vector<std::string> &getUniformBlockNames() const { return m_uniformBlockNames; }
+
+    // 按句柄设置 uniform：直接使用缓存的位置，值与上次设置的相同时不调用 GL。
+    // 调用前程序必须正在使用；无效句柄直接忽略
+    void setInt(UniformHandle handle, int value) const;
+    void setFloat(UniformHandle handle, float value) const;
+    void setVec3(UniformHandle handle, float x, float y, float z) const;
+    void setVec4(UniformHandle handle, float x, float y, float z, float w) const;
+
+    // 通过句柄实际写入 uniform 的次数，没有变化说明程序上的值仍是上一次设置的
+    std::uint64_t getUniformWriteCount() const { return m_uniformWrites; }
+
+    // 延迟编译完成（反射结果改变）时的渲染修订号，见 RenderRevision
+    std::uint64_t getRevision() const { return m_revision; }
+
+    // uniform工具函数（每次按名称查表，频繁设置的 uniform 应先取得句柄）
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
@@ -37,11 +95,43 @@ public:
     void setVec4(const std::string &name, float x, float y, float z, float w) const;
 
 private:
-    // 编译着色器
+    // 提交编译着色器，不检查结果
     unsigned int compileShader(const char *source, GLenum shaderType);
 
-    // 链接程序
-    bool linkProgram(unsigned int vertexShader, unsigned int fragmentShader);
+    // 检查着色器编译结果，失败时输出日志
+    bool checkCompileStatus(unsigned int shader, GLenum shaderType);
+
+    // 提交编译和链接，不检查结果
+    void submit(const char *vertexSource, const char *fragmentSource);
+
+    // 检查编译和链接结果，成功时反射，然后删除着色器对象
+    void finish();
+
+    // 反射活动 uniform 和 uniform 块，并把引擎约定的块绑定到固定绑定点
+    void reflect();
+
+    // 检查句柄对应的 uniform 是否已经是给定的值，不是则记录新值
+    bool updateCachedValue(UniformHandle handle, const std::uint32_t (&words)[4]) const;
+
+    // 上一次通过句柄设置的值，按 32 位字比较
+    struct UniformValue
+    {
+        std::uint32_t words[4];
+        bool known;
+    };
+
+    std::vector<UniformInfo> m_uniforms;
+    std::unordered_map<std::string, UniformHandle> m_uniformIndex;
+    mutable std::vector<UniformValue> m_uniformValues; // 与 m_uniforms 一一对应
+    std::vector<std::string> m_uniformBlockNames;
+    unsigned int m_vertexShader = 0;   // 链接完成前保留，用于检查编译结果
+    unsigned int m_fragmentShader = 0;
+    bool m_pending = false;
+    mutable std::uint64_t m_uniformWrites = 0;
+    std::uint64_t m_revision = 0;
+
+    // 声明的 uniform 块，按 UniformBlock 取位
+    unsigned int m_uniformBlocks = 0;
 };
 
 #endif
@@ -0,0 +1,152 @@
+#include "shadercache.h"
+#include "profiler.h"
+#include <algorithm>
+#include <functional>
+
+ShaderCache &ShaderCache::instance()
+{
+    static ShaderCache cache;
+    return cache;
+}
+
+ShaderCache::ShaderCache()
+    : m_programCount(0), m_stats{}
+{
+}
+
+ShaderCache::~ShaderCache()
+{
+}
+
+std::string ShaderCache::applyDefines(const std::string &source, const std::vector<std::string> &defines)
+{
+    if (defines.empty())
+        return source;
+
+    // 排序后相同的宏集合得到相同的源码
+    std::vector<std::string> sorted(defines);
+    std::sort(sorted.begin(), sorted.end());
+    std::string block;
+    for (const std::string &define : sorted)
+    {
+        block += "#define " + define + "\n";
+    }
+
+    // #version 必须是第一行
+    size_t insertAt = 0;
+    if (source.compare(0, 8, "#version") == 0)
+    {
+        size_t lineEnd = source.find('\n');
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+    std::string result = source.substr(0, insertAt);
+    if (insertAt > 0 && result.back() != '\n')
+    {
+        result += '\n';
+    }
+    result += block;
+    result.append(source, insertAt, std::string::npos);
+    return result;
+}
+
+std::shared_ptr<Shader> ShaderCache::getProgram(const std::string &vertexSource, const std::string &fragmentSource,
+                                                const std::vector<std::string> &defines, Shader::CompileMode mode)
+{
+    std::string vertex = applyDefines(vertexSource, defines);
+    std::string fragment = applyDefines(fragmentSource, defines);
+
+    std::size_t hash = std::hash<std::string>()(vertex);
+    hash ^= std::hash<std::string>()(fragment) + 0x9e3779b9u + (hash << 6) + (hash >> 2);
+
+    std::vector<Entry> &bucket = m_programs[hash];
+    for (const Entry &entry : bucket)
+    {
+        if (entry.vertexSource == vertex && entry.fragmentSource == fragment)
+        {
+            ++m_stats.hits;
+            return entry.shader;
+        }
+    }
+
+    PROFILE_ZONE("ShaderCache::compile");
+    auto shader = std::make_shared<Shader>(vertex.c_str(), fragment.c_str(), mode);
+    bucket.push_back({std::move(vertex), std::move(fragment), shader});
+    if (shader->isPending())
+    {
+        m_pending.push_back(shader);
+    }
+    else
+    {
+        ++m_stats.finished;
+    }
+    ++m_programCount;
+    ++m_stats.misses;
+    return shader;
+}
+
+size_t ShaderCache::update()
+{
+    if (m_pending.empty())
+        return 0;
+
+    PROFILE_ZONE("ShaderCache::update");
+
+    const size_t before = m_pending.size();
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                   [](const std::shared_ptr<Shader> &shader)
+                                   { return shader->poll(); }),
+                    m_pending.end());
+    const size_t finished = before - m_pending.size();
+    m_stats.finished += finished;
+    return finished;
+}
+
+void ShaderCache::finishAll()
+{
+    PROFILE_ZONE("ShaderCache::finishAll");
+
+    for (const std::shared_ptr<Shader> &shader : m_pending)
+    {
+        shader->poll(true);
+    }
+    m_stats.finished += m_pending.size();
+    m_pending.clear();
+}
+
+void ShaderCache::purge()
+{
+    m_programCount = 0;
+    for (auto it = m_programs.begin(); it != m_programs.end();)
+    {
+        std::vector<Entry> &bucket = it->second;
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                    [](const Entry &entry)
+                                    {
+                                        // 编译中的程序还被 m_pending 引用
+                                        const long owners = entry.shader->isPending() ? 2 : 1;
+                                        return entry.shader.use_count() <= owners;
+                                    }),
+                     bucket.end());
+        if (bucket.empty())
+        {
+            it = m_programs.erase(it);
+        }
+        else
+        {
+            m_programCount += bucket.size();
+            ++it;
+        }
+    }
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                   [](const std::shared_ptr<Shader> &shader)
+                                   { return shader.use_count() == 1; }),
+                    m_pending.end());
+}
+
+void ShaderCache::clear()
+{
+    m_programs.clear();
+    m_pending.clear();
+    m_programCount = 0;
+    m_stats = {};
+}
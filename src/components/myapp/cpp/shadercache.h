@@ -0,0 +1,122 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shader.h"
+
+/**
+ * @brief 着色器程序缓存
+ *
+ * 按源码和宏定义的哈希登记程序，相同的组合只编译一次。新程序以 Shader::CompileMode::Deferred 创建：
+ * 编译和链接只提交给驱动，不立即查询结果；update() 每帧轮询 GL_COMPLETION_STATUS_KHR，
+ * 完成后才检查结果并反射。编译期间使用这些程序的材质绘制后备材质（见 Material::setFallback）。
+ * 只在持有 GL 上下文的线程上使用
+ */
+class ShaderCache
+{
+public:
+    /**
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        std::uint64_t hits;     // 返回已有程序的次数
+        std::uint64_t misses;   // 新建程序的次数
+        std::uint64_t finished; // 已经完成编译的程序数量
+    };
+
+    /**
+     * @brief 获取全局缓存
+     * @return 缓存实例
+     */
+    static ShaderCache &instance();
+
+    // 禁用拷贝构造和赋值
+    ShaderCache(const ShaderCache &) = delete;
+    ShaderCache &operator=(const ShaderCache &) = delete;
+
+    /**
+     * @brief 获取程序，没有时提交编译
+     * @param vertexSource 顶点着色器源码
+     * @param fragmentSource 片段着色器源码
+     * @param defines 宏定义（"NAME" 或 "NAME VALUE"），插入到 #version 之后，与顺序无关
+     * @param mode 新建程序的编译方式，Immediate 时返回前完成编译
+     * @return 程序，可能仍在编译（Shader::isPending）
+     */
+    std::shared_ptr<Shader> getProgram(const std::string &vertexSource, const std::string &fragmentSource,
+                                       const std::vector<std::string> &defines = {},
+                                       Shader::CompileMode mode = Shader::CompileMode::Deferred);
+
+    /**
+     * @brief 轮询编译中的程序（每帧调用一次，RenderPipeline::render 开始时自动调用）
+     * @return 本次完成的程序数量
+     */
+    size_t update();
+
+    /**
+     * @brief 等待所有编译中的程序完成（例如加载界面结束时）
+     */
+    void finishAll();
+
+    /**
+     * @brief 释放只被缓存引用的程序
+     */
+    void purge();
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 获取缓存的程序数量
+     * @return 程序数量
+     */
+    size_t getProgramCount() const { return m_programCount; }
+
+    /**
+     * @brief 获取仍在编译的程序数量
+     * @return 程序数量
+     */
+    size_t getPendingCount() const { return m_pending.size(); }
+
+    /**
+     * @brief 获取缓存统计
+     * @return 统计数据
+     */
+    const Stats &getStats() const { return m_stats; }
+
+    /**
+     * @brief 把宏定义插入源码的 #version 行之后
+     * @param source 源码
+     * @param defines 宏定义
+     * @return 插入后的源码
+     */
+    static std::string applyDefines(const std::string &source, const std::vector<std::string> &defines);
+
+private:
+    ShaderCache();
+    ~ShaderCache();
+
+    /**
+     * @brief 一个缓存的程序（源码已经插入宏定义）
+     */
+    struct Entry
+    {
+        std::string vertexSource;
+        std::string fragmentSource;
+        std::shared_ptr<Shader> shader;
+    };
+
+    std::unordered_map<std::size_t, std::vector<Entry>> m_programs; // 按源码哈希分组
+    std::vector<std::shared_ptr<Shader>> m_pending;                  // 仍在编译的程序，按提交顺序
+    size_t m_programCount;
+    Stats m_stats;
+};
+
+#endif // SHADERCACHE_H
@@ -0,0 +1,160 @@
+#include "shaderpermutations.h"
+#include "shadercache.h"
+#include "profiler.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+ShaderPermutations::ShaderPermutations(std::string name, std::string vertexSource, std::string fragmentSource)
+    : m_name(std::move(name)), m_vertexSource(std::move(vertexSource)), m_fragmentSource(std::move(fragmentSource))
+{
+    parseKeywords(m_vertexSource);
+    parseKeywords(m_fragmentSource);
+}
+
+ShaderPermutations::~ShaderPermutations()
+{
+}
+
+void ShaderPermutations::parseKeywords(const std::string &source)
+{
+    std::istringstream lines(source);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        std::istringstream words(line);
+        std::string directive;
+        std::string pragma;
+        words >> directive >> pragma;
+        if (directive != "#pragma" || pragma != "keywords")
+            continue;
+
+        std::string keyword;
+        while (words >> keyword)
+        {
+            if (std::find(m_keywords.begin(), m_keywords.end(), keyword) != m_keywords.end())
+                continue;
+
+            if (m_keywords.size() == kMaxKeywords)
+            {
+                std::cout << "WARNING::SHADER::TOO_MANY_KEYWORDS " << m_name << " " << keyword << std::endl;
+                continue;
+            }
+            m_keywords.push_back(keyword);
+        }
+    }
+}
+
+ShaderPermutations::VariantKey ShaderPermutations::makeKey(const std::vector<std::string> &keywords) const
+{
+    VariantKey key = 0;
+    for (const std::string &keyword : keywords)
+    {
+        auto it = std::find(m_keywords.begin(), m_keywords.end(), keyword);
+        if (it == m_keywords.end())
+        {
+            std::cout << "WARNING::SHADER::UNKNOWN_KEYWORD " << m_name << " " << keyword << std::endl;
+            continue;
+        }
+        key |= VariantKey(1) << (it - m_keywords.begin());
+    }
+    return key;
+}
+
+std::vector<std::string> ShaderPermutations::getKeywordNames(VariantKey key) const
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < m_keywords.size(); ++i)
+    {
+        if (key & (VariantKey(1) << i))
+        {
+            names.push_back(m_keywords[i]);
+        }
+    }
+    return names;
+}
+
+std::shared_ptr<Shader> ShaderPermutations::compileVariant(VariantKey key, Shader::CompileMode mode)
+{
+    auto it = m_variants.find(key);
+    if (it != m_variants.end())
+        return it->second;
+
+    PROFILE_ZONE("ShaderPermutations::compileVariant");
+    std::shared_ptr<Shader> shader =
+        ShaderCache::instance().getProgram(m_vertexSource, m_fragmentSource, getKeywordNames(key), mode);
+    m_variants.emplace(key, shader);
+    return shader;
+}
+
+std::shared_ptr<Shader> ShaderPermutations::getVariant(VariantKey key, Shader::CompileMode mode)
+{
+    if (std::find(m_usedVariants.begin(), m_usedVariants.end(), key) == m_usedVariants.end())
+    {
+        m_usedVariants.push_back(key);
+    }
+    return compileVariant(key, mode);
+}
+
+void ShaderPermutations::writeWarmUpList(std::ostream &out) const
+{
+    for (VariantKey key : m_usedVariants)
+    {
+        out << m_name;
+        for (const std::string &keyword : getKeywordNames(key))
+        {
+            out << ' ' << keyword;
+        }
+        out << '\n';
+    }
+}
+
+size_t ShaderPermutations::warmUp(const std::vector<std::string> &lines)
+{
+    PROFILE_ZONE("ShaderPermutations::warmUp");
+
+    size_t submitted = 0;
+    for (const std::string &line : lines)
+    {
+        std::istringstream words(line);
+        std::string name;
+        words >> name;
+        if (name != m_name)
+            continue;
+
+        // 列表可能来自旧版本的着色器，关键字不存在时整行跳过
+        VariantKey key = 0;
+        bool known = true;
+        std::string keyword;
+        while (words >> keyword)
+        {
+            auto it = std::find(m_keywords.begin(), m_keywords.end(), keyword);
+            if (it == m_keywords.end())
+            {
+                known = false;
+                break;
+            }
+            key |= VariantKey(1) << (it - m_keywords.begin());
+        }
+        if (!known || m_variants.count(key) != 0)
+            continue;
+
+        compileVariant(key, Shader::CompileMode::Deferred);
+        ++submitted;
+    }
+    return submitted;
+}
+
+std::vector<std::string> ShaderPermutations::readWarmUpList(std::istream &in)
+{
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
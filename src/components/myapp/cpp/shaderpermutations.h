@@ -0,0 +1,132 @@
+#ifndef SHADERPERMUTATIONS_H
+#define SHADERPERMUTATIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shader.h"
+
+/**
+ * @brief 着色器变体集合
+ *
+ * 一对源码用 "#pragma keywords NAME ..." 声明功能关键字，用 #ifdef NAME 选择代码；
+ * 每个变体由关键字位掩码表示，第一次使用时把对应的宏插入源码后交给 ShaderCache 编译。
+ * 本次会话用过的变体可以写成预热列表，下次加载时先提交编译，避免运行中途才编译造成卡顿。
+ * 只在持有 GL 上下文的线程上使用
+ */
+class ShaderPermutations
+{
+public:
+    // 关键字位掩码，第 i 位对应 getKeywords()[i]
+    using VariantKey = std::uint32_t;
+
+    // 关键字数量上限
+    static constexpr size_t kMaxKeywords = 32;
+
+    /**
+     * @brief 创建变体集合并解析关键字声明（不编译任何变体）
+     * @param name 名称，用于预热列表
+     * @param vertexSource 顶点着色器源码
+     * @param fragmentSource 片段着色器源码
+     */
+    ShaderPermutations(std::string name, std::string vertexSource, std::string fragmentSource);
+    ~ShaderPermutations();
+
+    // 禁用拷贝构造和赋值
+    ShaderPermutations(const ShaderPermutations &) = delete;
+    ShaderPermutations &operator=(const ShaderPermutations &) = delete;
+
+    /**
+     * @brief 获取名称
+     * @return 名称
+     */
+    const std::string &getName() const { return m_name; }
+
+    /**
+     * @brief 获取声明的关键字，按声明顺序
+     * @return 关键字列表
+     */
+    const std::vector<std::string> &getKeywords() const { return m_keywords; }
+
+    /**
+     * @brief 按关键字名称组合变体键
+     * @param keywords 关键字
+     * @return 变体键，未声明的关键字被忽略
+     */
+    VariantKey makeKey(const std::vector<std::string> &keywords) const;
+
+    /**
+     * @brief 获取变体键包含的关键字
+     * @param key 变体键
+     * @return 关键字，按声明顺序
+     */
+    std::vector<std::string> getKeywordNames(VariantKey key) const;
+
+    /**
+     * @brief 获取变体，第一次使用时提交编译并记录到本次会话的使用列表
+     * @param key 变体键
+     * @param mode 新建程序的编译方式
+     * @return 程序，可能仍在编译（Shader::isPending）
+     */
+    std::shared_ptr<Shader> getVariant(VariantKey key, Shader::CompileMode mode = Shader::CompileMode::Deferred);
+
+    /**
+     * @brief 获取已经创建的变体数量
+     * @return 变体数量
+     */
+    size_t getVariantCount() const { return m_variants.size(); }
+
+    /**
+     * @brief 获取本次会话用过的变体，按第一次使用的顺序
+     * @return 变体键列表
+     */
+    const std::vector<VariantKey> &getUsedVariants() const { return m_usedVariants; }
+
+    /**
+     * @brief 把用过的变体写成预热列表，每行为 "名称 关键字..."
+     * @param out 输出流
+     */
+    void writeWarmUpList(std::ostream &out) const;
+
+    /**
+     * @brief 提交预热列表中属于本集合的变体（不计入使用列表）
+     *
+     * 关键字已经不存在的行被跳过。提交后可以调用 ShaderCache::finishAll() 在加载期间等待完成
+     * @param lines 预热列表的行（见 readWarmUpList）
+     * @return 新提交编译的变体数量
+     */
+    size_t warmUp(const std::vector<std::string> &lines);
+
+    /**
+     * @brief 读取预热列表
+     * @param in 输入流
+     * @return 非空的行
+     */
+    static std::vector<std::string> readWarmUpList(std::istream &in);
+
+private:
+    /**
+     * @brief 解析源码中的 "#pragma keywords" 声明
+     */
+    void parseKeywords(const std::string &source);
+
+    /**
+     * @brief 创建或返回已有的变体
+     */
+    std::shared_ptr<Shader> compileVariant(VariantKey key, Shader::CompileMode mode);
+
+private:
+    std::string m_name;
+    std::string m_vertexSource;
+    std::string m_fragmentSource;
+    std::vector<std::string> m_keywords;
+    std::unordered_map<VariantKey, std::shared_ptr<Shader>> m_variants;
+    std::vector<VariantKey> m_usedVariants;
+};
+
+#endif // SHADERPERMUTATIONS_H
@@ -0,0 +1,256 @@
+#include "staticbatch.h"
+#include "gameobject.h"
+#include "glstate.h"
+#include "indexformat.h"
+#include "mesh.h"
+#include "profiler.h"
+#include "rendercommand.h"
+#include "renderrevision.h"
+#include "vertexlayout.h"
+#include <algorithm>
+
+StaticBatch::StaticBatch(std::shared_ptr<Material> material)
+    : m_material(std::move(material)),
+      m_vbo(BufferObject::Type::VertexBuffer),
+      m_ebo(BufferObject::Type::ElementBuffer),
+      m_vertexCount(0), m_indexCount(0), m_indexType(0), m_revision(0)
+{
+}
+
+StaticBatch::~StaticBatch()
+{
+    if (m_indexType != 0)
+    {
+        IndexFormat::removeBuffer(m_indexType, static_cast<size_t>(m_indexCount));
+    }
+}
+
+bool StaticBatch::canBatch(const Mesh &mesh)
+{
+    return mesh.isValid() && mesh.getMaterial() && !mesh.isInstanced() &&
+           mesh.getVertexLayout() == VertexLayout::position() &&
+           mesh.getVertexData().size() == static_cast<size_t>(mesh.getVertexCount()) * 3 &&
+           mesh.getIndexData().size() == static_cast<size_t>(mesh.getIndexCount());
+}
+
+void StaticBatch::add(const GameObject &owner, const Mesh &mesh)
+{
+    float model[16];
+    owner.getModelMatrix(model);
+
+    const unsigned int baseVertex = static_cast<unsigned int>(m_vertexCount);
+    const std::vector<float> &vertices = mesh.getVertexData();
+    m_vertices.reserve(m_vertices.size() + vertices.size());
+    for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+    {
+        const float x = vertices[i];
+        const float y = vertices[i + 1];
+        const float z = vertices[i + 2];
+        m_vertices.push_back(model[0] * x + model[4] * y + model[8] * z + model[12]);
+        m_vertices.push_back(model[1] * x + model[5] * y + model[9] * z + model[13]);
+        m_vertices.push_back(model[2] * x + model[6] * y + model[10] * z + model[14]);
+    }
+
+    Range range{&owner, m_indexCount, 0};
+    const std::vector<unsigned int> &indices = mesh.getIndexData();
+    if (!indices.empty())
+    {
+        for (unsigned int index : indices)
+        {
+            m_indices.push_back(baseVertex + index);
+        }
+        range.indexCount = static_cast<GLsizei>(indices.size());
+    }
+    else
+    {
+        // 非索引网格按顺序生成索引
+        for (GLsizei i = 0; i < mesh.getVertexCount(); ++i)
+        {
+            m_indices.push_back(baseVertex + static_cast<unsigned int>(i));
+        }
+        range.indexCount = mesh.getVertexCount();
+    }
+
+    m_vertexCount += mesh.getVertexCount();
+    m_indexCount += range.indexCount;
+
+    // 同一对象的相邻范围直接合并
+    if (!m_ranges.empty() && m_ranges.back().owner == &owner &&
+        m_ranges.back().firstIndex + m_ranges.back().indexCount == range.firstIndex)
+    {
+        m_ranges.back().indexCount += range.indexCount;
+    }
+    else
+    {
+        m_ranges.push_back(range);
+    }
+}
+
+void StaticBatch::build()
+{
+    PROFILE_ZONE("StaticBatch::build");
+
+    m_vao.bind();
+    m_vao.bindVertexBuffer(m_vbo);
+    m_vbo.setData(m_vertices, BufferObject::Usage::StaticDraw);
+    // 合批只处理 Mesh 的默认顶点格式：每个顶点 3 个 float 的位置
+    const GLuint vertexBuffer = m_vbo.getId();
+    m_vao.setVertexLayout(*VertexLayout::position(), &vertexBuffer);
+    // 合并后的顶点数决定索引类型，顶点少的批次仍然可以使用 16 位索引
+    if (m_indexType != 0)
+    {
+        IndexFormat::removeBuffer(m_indexType, static_cast<size_t>(m_indexCount));
+    }
+    std::vector<std::uint8_t> indexData;
+    m_indexType = IndexFormat::pack(m_indices.data(), m_indices.size(), indexData);
+    IndexFormat::addBuffer(m_indexType, m_indices.size());
+    if (indexData.empty())
+    {
+        m_ebo.setData(m_indices, BufferObject::Usage::StaticDraw);
+    }
+    else
+    {
+        m_ebo.setData(indexData, BufferObject::Usage::StaticDraw);
+    }
+    m_vao.bindElementBuffer(m_ebo);
+    m_vao.unbind();
+
+    // 数据已在 GPU 上，释放 CPU 副本
+    std::vector<float>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
+    m_revision = RenderRevision::bump();
+}
+
+std::uint64_t StaticBatch::getRevision() const
+{
+    // 范围按所属对象的可见性剔除
+    std::uint64_t revision = m_material ? std::max(m_revision, m_material->getRevision()) : m_revision;
+    for (const Range &range : m_ranges)
+    {
+        revision = std::max(revision, range.owner->getRevision());
+    }
+    return revision;
+}
+
+void StaticBatch::removeOwner(const GameObject *owner)
+{
+    for (Range &range : m_ranges)
+    {
+        if (range.owner == owner)
+        {
+            range.owner = nullptr;
+        }
+    }
+    m_revision = RenderRevision::bump();
+}
+
+void StaticBatch::clearRanges()
+{
+    m_ranges.clear();
+    m_revision = RenderRevision::bump();
+}
+
+const StaticBatch::Range *StaticBatch::collectVisibleRuns()
+{
+    m_runCounts.clear();
+    m_runOffsets.clear();
+
+    const Range *firstRange = nullptr;
+    GLsizei runEnd = -1;
+    for (const Range &range : m_ranges)
+    {
+        if (!range.owner || !range.owner->isVisible())
+        {
+            continue;
+        }
+
+        if (range.firstIndex == runEnd)
+        {
+            // 与上一段相邻，直接延长
+            m_runCounts.back() += range.indexCount;
+        }
+        else
+        {
+            if (!firstRange)
+            {
+                firstRange = &range;
+            }
+            m_runCounts.push_back(range.indexCount);
+            m_runOffsets.push_back(
+                reinterpret_cast<const void *>(static_cast<std::uintptr_t>(range.firstIndex) * IndexFormat::size(m_indexType)));
+        }
+        runEnd = range.firstIndex + range.indexCount;
+    }
+    return firstRange;
+}
+
+void StaticBatch::render()
+{
+    PROFILE_ZONE("StaticBatch::render");
+
+    if (!m_material || m_indexCount == 0 || !collectVisibleRuns())
+        return;
+
+    if (!m_material->apply())
+        return;
+    m_vao.bind();
+    const GLsizei runCount = static_cast<GLsizei>(m_runCounts.size());
+    if (GLState::isMultiDrawSupported())
+    {
+        glMultiDrawElementsWEBGL(GL_TRIANGLES, m_runCounts.data(), m_indexType, m_runOffsets.data(), runCount);
+    }
+    else
+    {
+        for (GLsizei i = 0; i < runCount; ++i)
+        {
+            glDrawElements(GL_TRIANGLES, m_runCounts[i], m_indexType, m_runOffsets[i]);
+        }
+    }
+}
+
+void StaticBatch::recordCommands(RenderCommandQueue &commandQueue, float nearDepth, float depthScale,
+                                 std::uint32_t uniformSlot)
+{
+    if (!m_material || m_indexCount == 0)
+        return;
+
+    const Range *firstRange = collectVisibleRuns();
+    if (!firstRange)
+        return;
+
+    Material *material = m_material.get();
+    const GLuint vertexArray = m_vao.getId();
+    if (!material->usesUniformBlock(UniformBlock::Object))
+    {
+        uniformSlot = DrawCommand::kNoUniformSlot;
+    }
+    const float depth = (-firstRange->owner->getPosition()[2] - nearDepth) * depthScale;
+    std::uint64_t sortKey = material->isTranslucent()
+                                ? DrawKey::translucent(material->getProgramId(), material->getSortId(), vertexArray, depth)
+                                : DrawKey::opaque(material->getProgramId(), material->getSortId(), vertexArray, depth);
+
+    if (m_runCounts.size() == 1)
+    {
+        DrawCommand &command = commandQueue.addDraw(sortKey);
+        command.material = material;
+        command.vertexArray = vertexArray;
+        command.mode = GL_TRIANGLES;
+        command.first = 0;
+        command.count = m_runCounts[0];
+        command.indexType = m_indexType;
+        command.indexOffset = reinterpret_cast<std::uintptr_t>(m_runOffsets[0]);
+        command.instanceLayout = nullptr;
+        command.uniformSlot = uniformSlot;
+        return;
+    }
+
+    MultiDrawCommand &command = commandQueue.addMultiDraw(sortKey);
+    command.material = material;
+    command.vertexArray = vertexArray;
+    command.mode = GL_TRIANGLES;
+    command.indexType = m_indexType;
+    command.drawCount = static_cast<GLsizei>(m_runCounts.size());
+    command.counts = m_runCounts.data();
+    command.offsets = m_runOffsets.data();
+    command.uniformSlot = uniformSlot;
+}
@@ -0,0 +1,149 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include "glapi.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "vertexarrayobject.h"
+#include "bufferobject.h"
+#include "material.h"
+
+class GameObject;
+class Mesh;
+class RenderCommandQueue;
+
+/**
+ * @brief 静态合批
+ *
+ * 把使用同一材质的静态网格合并到一对 VBO/EBO 中：顶点按所属游戏对象的模型矩阵预先变换，
+ * 索引按合并后的顶点位置重新编号。每个源网格在合并的索引缓冲中占一段范围，
+ * 绘制时跳过不可见对象的范围，相邻的可见范围合并为一段，所有段通过一次多重绘制提交
+ */
+class StaticBatch
+{
+public:
+    /**
+     * @brief 源网格在合并索引缓冲中的范围
+     */
+    struct Range
+    {
+        const GameObject *owner; // 所属游戏对象，用于可见性剔除；nullptr 表示对象已移出场景
+        GLsizei firstIndex;      // 第一个索引的位置
+        GLsizei indexCount;      // 索引数量
+    };
+
+    explicit StaticBatch(std::shared_ptr<Material> material);
+    ~StaticBatch();
+
+    // 禁用拷贝构造和赋值
+    StaticBatch(const StaticBatch &) = delete;
+    StaticBatch &operator=(const StaticBatch &) = delete;
+
+    /**
+     * @brief 检查网格能否合批：有效、非实例化、保留了只含位置的顶点数据和索引数据（见 Mesh::setKeepGeometry()）
+     * @param mesh 网格
+     * @return 是否可以合批
+     */
+    static bool canBatch(const Mesh &mesh);
+
+    /**
+     * @brief 追加一个源网格（只修改 CPU 数据，build() 时上传）
+     * @param owner 所属游戏对象，提供模型矩阵和可见性
+     * @param mesh 网格，必须满足 canBatch()
+     */
+    void add(const GameObject &owner, const Mesh &mesh);
+
+    /**
+     * @brief 上传合并的顶点和索引数据并配置 VAO，之后释放 CPU 数据
+     */
+    void build();
+
+    /**
+     * @brief 对象移出场景时停止绘制它的范围（几何数据保留到下一次重建）
+     * @param owner 游戏对象
+     */
+    void removeOwner(const GameObject *owner);
+
+    /**
+     * @brief 清空范围表，合批不再绘制任何内容
+     */
+    void clearRanges();
+
+    /**
+     * @brief 立即绘制所有可见范围
+     */
+    void render();
+
+    /**
+     * @brief 录制所有可见范围的绘制命令：只有一段时录制普通绘制，否则录制一个多重绘制
+     *
+     * 多重绘制引用合批内部的范围数组，下一次录制或 render() 之前有效
+     * @param commandQueue 命令队列
+     * @param nearDepth 排序深度范围的近端
+     * @param depthScale 排序深度的缩放，使用第一段所属对象的深度
+     * @param uniformSlot 单位模型矩阵的 ObjectBlock 槽位，材质的着色器没有声明 ObjectBlock 时忽略
+     */
+    void recordCommands(RenderCommandQueue &commandQueue, float nearDepth, float depthScale,
+                        std::uint32_t uniformSlot);
+
+    /**
+     * @brief 获取材质
+     * @return 材质对象
+     */
+    const std::shared_ptr<Material> &getMaterial() const { return m_material; }
+
+    /**
+     * @brief 获取范围表
+     * @return 范围列表，按添加顺序排列
+     */
+    const std::vector<Range> &getRanges() const { return m_ranges; }
+
+    /**
+     * @brief 获取合并后的顶点数量
+     * @return 顶点数量
+     */
+    GLsizei getVertexCount() const { return m_vertexCount; }
+
+    /**
+     * @brief 获取合并后的索引数量
+     * @return 索引数量
+     */
+    GLsizei getIndexCount() const { return m_indexCount; }
+
+    /**
+     * @brief 获取合并后的索引类型（按合并后的顶点数选择，build() 之前为 0）
+     * @return 索引类型
+     */
+    GLenum getIndexType() const { return m_indexType; }
+
+    /**
+     * @brief 获取影响录制命令的最近一次修改的修订号（包括材质和范围所属的对象）
+     * @return 修订号（见 RenderRevision）
+     */
+    std::uint64_t getRevision() const;
+
+private:
+    /**
+     * @brief 把连续的可见范围合并成段，写入 m_runCounts/m_runOffsets
+     * @return 第一段所属的范围，没有可见范围时为 nullptr
+     */
+    const Range *collectVisibleRuns();
+
+private:
+    std::shared_ptr<Material> m_material;
+    VertexArrayObject m_vao;
+    BufferObject m_vbo;
+    BufferObject m_ebo;
+    std::vector<float> m_vertices;      // 预变换后的位置，build() 后释放
+    std::vector<unsigned int> m_indices; // build() 后释放
+    std::vector<Range> m_ranges;
+    std::vector<GLsizei> m_runCounts;      // 每段的索引数量
+    std::vector<const void *> m_runOffsets; // 每段的索引字节偏移
+    GLsizei m_vertexCount;
+    GLsizei m_indexCount;
+    GLenum m_indexType;
+    std::uint64_t m_revision; // 合批自身最近一次修改的修订号
+};
+
+#endif // STATICBATCH_H
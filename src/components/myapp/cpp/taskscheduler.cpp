@@ -0,0 +1,411 @@
+#include "taskscheduler.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+// 与链接选项 PTHREAD_POOL_SIZE 保持一致，浏览器中只能同步启动预创建的线程
+#ifndef ENGINE_WASM_WORKERS
+#define ENGINE_WASM_WORKERS 4
+#endif
+
+namespace
+{
+    // 当前线程在调度器中的索引，主线程为0
+    thread_local unsigned t_threadIndex = 0;
+
+    // 当前线程正在执行的作业
+    thread_local Job *t_currentJob = nullptr;
+
+    // 空闲线程进入睡眠前的自旋次数
+    constexpr int kIdleSpinCount = 64;
+
+    unsigned nextRandom()
+    {
+        thread_local uint32_t state = 0x9E3779B9u ^ static_cast<uint32_t>(t_threadIndex * 0x85EBCA6Bu);
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+JobQueue::JobQueue()
+    : m_top(0), m_bottom(0), m_jobs(new std::atomic<Job *>[kCapacity])
+{
+}
+
+bool JobQueue::push(Job *job)
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= kCapacity)
+    {
+        return false;
+    }
+
+    m_jobs[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job *JobQueue::pop()
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_seq_cst);
+
+    if (top > bottom)
+    {
+        // 队列为空
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job *job = m_jobs[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (top != bottom)
+    {
+        return job;
+    }
+
+    // 最后一个作业，与窃取线程竞争
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        job = nullptr;
+    }
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return job;
+}
+
+Job *JobQueue::steal()
+{
+    int64_t top = m_top.load(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Job *job = m_jobs[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+TaskScheduler &TaskScheduler::instance()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+    : m_queuedJobs(0), m_sleepingWorkers(0), m_stopping(false)
+{
+    // 主线程的作业池在未初始化时也可用
+    m_contexts.push_back(std::make_unique<ThreadContext>());
+    m_contexts[0]->jobs.reset(new Job[kMaxJobsPerThread]);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    shutdown();
+}
+
+unsigned TaskScheduler::defaultWorkerCount()
+{
+    if (!threadsSupported())
+    {
+        return 0;
+    }
+
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    unsigned workers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+#ifdef __EMSCRIPTEN__
+    workers = std::min<unsigned>(workers, ENGINE_WASM_WORKERS);
+#endif
+    return workers;
+}
+
+bool TaskScheduler::initialize(unsigned workerCount)
+{
+    shutdown();
+
+    if (!threadsSupported() && workerCount > 0)
+    {
+        std::cout << "TaskScheduler: threads unavailable in this build, running single-threaded" << std::endl;
+        workerCount = 0;
+    }
+
+    m_stopping = false;
+#if ENGINE_THREADS
+    m_contexts.resize(1);
+    for (unsigned i = 0; i < workerCount; ++i)
+    {
+        m_contexts.push_back(std::make_unique<ThreadContext>());
+        m_contexts.back()->jobs.reset(new Job[kMaxJobsPerThread]);
+    }
+    for (unsigned i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&TaskScheduler::workerLoop, this, i + 1);
+    }
+#endif
+
+    std::cout << "TaskScheduler: " << m_workers.size() << " worker thread(s)" << std::endl;
+    return isThreaded();
+}
+
+void TaskScheduler::shutdown()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+    m_contexts.resize(1);
+}
+
+Job *TaskScheduler::createJob(JobFunction function, Job *parent)
+{
+    ThreadContext &context = *m_contexts[t_threadIndex];
+    Job *job = &context.jobs[context.allocated++ & (kMaxJobsPerThread - 1)];
+
+    // 作业池循环复用：同一线程未完成的作业不能超过 kMaxJobsPerThread
+    assert(job->m_unfinished.load(std::memory_order_relaxed) == 0);
+
+    if (parent)
+    {
+        parent->m_unfinished.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    job->m_function = std::move(function);
+    job->m_parent = parent;
+    job->m_unfinished.store(1, std::memory_order_relaxed);
+    job->m_continuationCount.store(0, std::memory_order_relaxed);
+    return job;
+}
+
+Job *TaskScheduler::createParallelForJob(size_t count, size_t grainSize, RangeFunction function, Job *parent)
+{
+    auto shared = std::make_shared<const RangeFunction>(std::move(function));
+    return createRangeJob(0, count, std::max<size_t>(grainSize, 1), std::move(shared), parent);
+}
+
+Job *TaskScheduler::createRangeJob(size_t begin, size_t end, size_t grainSize,
+                                   std::shared_ptr<const RangeFunction> function, Job *parent)
+{
+    Job *job = createJob(nullptr, parent);
+    job->m_function = [this, job, begin, end, grainSize, function]()
+    {
+        if (end - begin <= grainSize)
+        {
+            (*function)(begin, end);
+            return;
+        }
+
+        // 二分拆分，子作业可被其他线程窃取
+        size_t middle = begin + (end - begin) / 2;
+        run(createRangeJob(begin, middle, grainSize, function, job));
+        run(createRangeJob(middle, end, grainSize, function, job));
+    };
+    return job;
+}
+
+bool TaskScheduler::addContinuation(Job *job, Job *continuation)
+{
+    int index = job->m_continuationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= Job::kMaxContinuations)
+    {
+        job->m_continuationCount.fetch_sub(1, std::memory_order_relaxed);
+        std::cerr << "TaskScheduler: too many continuations" << std::endl;
+        return false;
+    }
+    job->m_continuations[index] = continuation;
+    return true;
+}
+
+void TaskScheduler::run(Job *job)
+{
+    // 单线程模式或队列已满：直接在当前线程执行
+    if (!isThreaded() || !m_contexts[t_threadIndex]->queue.push(job))
+    {
+        execute(job);
+        return;
+    }
+
+    m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_condition.notify_one();
+    }
+}
+
+void TaskScheduler::wait(const Job *job)
+{
+    // 浏览器主线程不能阻塞等待，因此在等待期间帮助执行作业，空闲时让出时间片
+    while (!isFinished(job))
+    {
+        Job *next = findJob();
+        if (next)
+        {
+            execute(next);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::parallelFor(size_t count, size_t grainSize, const RangeFunction &function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (!isThreaded() || count <= grainSize)
+    {
+        function(0, count);
+        return;
+    }
+
+    Job *job = createParallelForJob(count, grainSize, function);
+    run(job);
+    wait(job);
+}
+
+Job *TaskScheduler::currentJob()
+{
+    return t_currentJob;
+}
+
+void TaskScheduler::workerLoop(unsigned threadIndex)
+{
+    t_threadIndex = threadIndex;
+
+    int idleSpins = 0;
+    while (!m_stopping.load(std::memory_order_relaxed))
+    {
+        Job *job = findJob();
+        if (job)
+        {
+            execute(job);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (++idleSpins < kIdleSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // 长时间没有作业时睡眠，直到有新作业提交
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        m_condition.wait(lock, [this]
+                         { return m_stopping.load(std::memory_order_relaxed) ||
+                                  m_queuedJobs.load(std::memory_order_seq_cst) > 0; });
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        idleSpins = 0;
+    }
+}
+
+Job *TaskScheduler::findJob()
+{
+    if (m_queuedJobs.load(std::memory_order_relaxed) <= 0)
+    {
+        return nullptr;
+    }
+
+    const size_t threadCount = m_contexts.size();
+    Job *job = m_contexts[t_threadIndex]->queue.pop();
+    if (!job)
+    {
+        // 从随机线程开始依次窃取
+        size_t start = nextRandom() % threadCount;
+        for (size_t i = 0; i < threadCount && !job; ++i)
+        {
+            size_t victim = (start + i) % threadCount;
+            if (victim != t_threadIndex)
+            {
+                job = m_contexts[victim]->queue.steal();
+            }
+        }
+    }
+
+    if (job)
+    {
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void TaskScheduler::execute(Job *job)
+{
+    if (job->m_function)
+    {
+        Job *previousJob = t_currentJob;
+        t_currentJob = job;
+        job->m_function();
+        t_currentJob = previousJob;
+        // 释放捕获的资源，作业槽位可能很久之后才被复用
+        job->m_function = nullptr;
+    }
+    finish(job);
+}
+
+void TaskScheduler::finish(Job *job)
+{
+    // 后续作业和父作业必须在计数归零前读取，归零后作业槽位可能被复用
+    Job *parent = job->m_parent;
+    int continuationCount = job->m_continuationCount.load(std::memory_order_relaxed);
+    Job *continuations[Job::kMaxContinuations];
+    std::copy(job->m_continuations, job->m_continuations + continuationCount, continuations);
+
+    if (job->m_unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    for (int i = 0; i < continuationCount; ++i)
+    {
+        run(continuations[i]);
+    }
+    if (parent)
+    {
+        finish(parent);
+    }
+}
+
+// Electron 绑定接口 - 供 JS 查询当前运行模式
+#ifdef __EMSCRIPTEN__
+extern "C"
+{
+    EMSCRIPTEN_KEEPALIVE
+    int engine_task_worker_count()
+    {
+        return static_cast<int>(TaskScheduler::instance().getWorkerCount());
+    }
+}
+#endif
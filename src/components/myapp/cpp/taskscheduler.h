@@ -0,0 +1,244 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 原生构建总是支持线程；wasm 构建只有在 -pthread 编译时才支持
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define ENGINE_THREADS 1
+#else
+#define ENGINE_THREADS 0
+#endif
+
+class TaskScheduler;
+
+/**
+ * @brief 作业
+ *
+ * 由 TaskScheduler::createJob 从线程本地作业池分配，只在一帧内有效。
+ * 父作业在自身函数和所有子作业都完成后才算完成；
+ * 后续作业（continuation）在本作业完成时自动提交。
+ */
+class Job
+{
+public:
+    static constexpr int kMaxContinuations = 8;
+
+    Job() : m_parent(nullptr), m_unfinished(0), m_continuationCount(0) {}
+
+    // 禁用拷贝构造和赋值
+    Job(const Job &) = delete;
+    Job &operator=(const Job &) = delete;
+
+private:
+    friend class TaskScheduler;
+
+    std::function<void()> m_function;
+    Job *m_parent;
+    std::atomic<int> m_unfinished;
+    std::atomic<int> m_continuationCount;
+    Job *m_continuations[kMaxContinuations];
+};
+
+/**
+ * @brief 作业队列（Chase-Lev 工作窃取双端队列）
+ *
+ * 所属线程在底部 push/pop，其他线程从顶部 steal，容量固定
+ */
+class JobQueue
+{
+public:
+    static constexpr int64_t kCapacity = 4096;
+
+    JobQueue();
+
+    // 禁用拷贝构造和赋值
+    JobQueue(const JobQueue &) = delete;
+    JobQueue &operator=(const JobQueue &) = delete;
+
+    /**
+     * @brief 压入作业（仅所属线程调用）
+     * @return 队列已满时返回 false
+     */
+    bool push(Job *job);
+
+    /**
+     * @brief 弹出最近压入的作业（仅所属线程调用）
+     * @return 作业，队列为空时返回 nullptr
+     */
+    Job *pop();
+
+    /**
+     * @brief 窃取最早压入的作业（任意线程调用）
+     * @return 作业，队列为空或竞争失败时返回 nullptr
+     */
+    Job *steal();
+
+private:
+    std::atomic<int64_t> m_top;
+    std::atomic<int64_t> m_bottom;
+    std::unique_ptr<std::atomic<Job *>[]> m_jobs;
+};
+
+/**
+ * @brief 任务调度器（工作窃取作业系统）
+ *
+ * 启动时创建固定数量的工作线程，每个线程（包括主线程）拥有一个作业队列和作业池，
+ * 空闲线程从其他线程的队列窃取作业。每帧的场景更新、动画、渲染准备等工作
+ * 通过父子关系和后续作业组织成依赖图。
+ * 工作线程数为0时（单线程wasm构建或跨源隔离不可用）作业在提交时直接执行，
+ * 调用方代码无需区分两种模式。
+ *
+ * 作业只能由主线程或作业内部创建和提交。
+ */
+class TaskScheduler
+{
+public:
+    using JobFunction = std::function<void()>;
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    // 每个线程同时存在的作业上限，作业池循环复用
+    static constexpr size_t kMaxJobsPerThread = 4096;
+
+    /**
+     * @brief 获取全局调度器
+     * @return 调度器实例
+     */
+    static TaskScheduler &instance();
+
+    // 禁用拷贝构造和赋值
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /**
+     * @brief 创建工作线程
+     * @param workerCount 工作线程数量，0 表示单线程模式
+     * @return 实际是否以多线程模式运行
+     */
+    bool initialize(unsigned workerCount);
+
+    /**
+     * @brief 停止所有工作线程，调用前所有作业必须已完成
+     */
+    void shutdown();
+
+    /**
+     * @brief 创建作业（尚未提交）
+     * @param function 作业函数，可为空（仅用于汇合子作业）
+     * @param parent 父作业，父作业在本作业完成后才会完成
+     * @return 作业
+     */
+    Job *createJob(JobFunction function, Job *parent = nullptr);
+
+    /**
+     * @brief 创建并行循环作业，按粒度递归拆分 [0, count)
+     * @param count 元素数量
+     * @param grainSize 每个子作业最多处理的元素数量
+     * @param function 区间处理函数，会被多个线程同时调用
+     * @param parent 父作业
+     * @return 作业（尚未提交）
+     */
+    Job *createParallelForJob(size_t count, size_t grainSize, RangeFunction function, Job *parent = nullptr);
+
+    /**
+     * @brief 添加后续作业，必须在提交 job 之前调用
+     * @param job 前置作业
+     * @param continuation 前置作业完成后提交的作业
+     * @return 后续作业数量超过上限时返回 false
+     */
+    bool addContinuation(Job *job, Job *continuation);
+
+    /**
+     * @brief 提交作业
+     * @param job 作业
+     */
+    void run(Job *job);
+
+    /**
+     * @brief 等待作业完成，等待期间当前线程也会执行其他作业
+     * @param job 作业
+     */
+    void wait(const Job *job);
+
+    /**
+     * @brief 检查作业是否完成
+     * @param job 作业
+     * @return 是否完成
+     */
+    bool isFinished(const Job *job) const { return job->m_unfinished.load(std::memory_order_acquire) == 0; }
+
+    /**
+     * @brief 获取当前线程正在执行的作业，用于在作业内部创建子作业
+     * @return 作业，不在作业中时返回 nullptr
+     */
+    static Job *currentJob();
+
+    /**
+     * @brief 并行执行循环并等待完成；元素数量不超过粒度时直接在当前线程执行
+     * @param count 元素数量
+     * @param grainSize 每个子作业最多处理的元素数量
+     * @param function 区间处理函数
+     */
+    void parallelFor(size_t count, size_t grainSize, const RangeFunction &function);
+
+    /**
+     * @brief 是否以多线程模式运行
+     * @return 是否有工作线程
+     */
+    bool isThreaded() const { return !m_workers.empty(); }
+
+    /**
+     * @brief 获取工作线程数量（不含主线程）
+     * @return 工作线程数量
+     */
+    unsigned getWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * @brief 当前构建是否支持线程
+     * @return 是否支持
+     */
+    static bool threadsSupported() { return ENGINE_THREADS != 0; }
+
+    /**
+     * @brief 默认工作线程数量：硬件线程数减去主线程，wasm 构建不超过预创建的线程池大小
+     * @return 工作线程数量
+     */
+    static unsigned defaultWorkerCount();
+
+private:
+    TaskScheduler();
+    ~TaskScheduler();
+
+    struct ThreadContext
+    {
+        JobQueue queue;
+        std::unique_ptr<Job[]> jobs;
+        size_t allocated = 0;
+    };
+
+    void workerLoop(unsigned threadIndex);
+    Job *findJob();
+    void execute(Job *job);
+    void finish(Job *job);
+    Job *createRangeJob(size_t begin, size_t end, size_t grainSize,
+                        std::shared_ptr<const RangeFunction> function, Job *parent);
+
+private:
+    std::vector<std::unique_ptr<ThreadContext>> m_contexts; // [0] 为主线程
+    std::vector<std::thread> m_workers;
+    std::atomic<int> m_queuedJobs;
+    std::atomic<int> m_sleepingWorkers;
+    std::atomic<bool> m_stopping;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+#endif // TASKSCHEDULER_H
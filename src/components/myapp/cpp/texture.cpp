@@ -1,4 +1,5 @@
 #include "texture.h"
+#include "glstate.h"
 #include <iostream>
 
 Texture::Texture()
@@ -11,6 +12,7 @@ Texture::~Texture()
 {
     if (m_textureId != 0)
     {
+        GLState::textureDeleted(m_textureId);
         glDeleteTextures(1, &m_textureId);
     }
 }
@@ -32,6 +34,7 @@ Texture &Texture::operator=(Texture &&other) noexcept
     {
         if (m_textureId != 0)
         {
+            GLState::textureDeleted(m_textureId);
             glDeleteTextures(1, &m_textureId);
         }
 
@@ -64,7 +67,7 @@ bool Texture::createFromData(const unsigned char *data, int width, int height, G
     m_height = height;
     m_format = format;
 
-    glBindTexture(GL_TEXTURE_2D, m_textureId);
+    GLState::bindTexture(GL_TEXTURE_2D, m_textureId);
 
     // 设置纹理参数
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -78,7 +81,7 @@ bool Texture::createFromData(const unsigned char *data, int width, int height, G
     // 生成mipmap
     // glGenerateMipmap(GL_TEXTURE_2D);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(GL_TEXTURE_2D, 0);
 
     return true;
 }
@@ -87,12 +90,11 @@ void Texture::bind(GLuint unit) const
 {
     if (m_textureId != 0)
     {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(GL_TEXTURE_2D, m_textureId);
+        GLState::bindTexture(unit, GL_TEXTURE_2D, m_textureId);
     }
 }
 
 void Texture::unbind() const
 {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(GL_TEXTURE_2D, 0);
 }
@@ -1,7 +1,7 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
 #include <string>
 
 /**
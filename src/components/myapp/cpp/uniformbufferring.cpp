@@ -0,0 +1,71 @@
+#include "uniformbufferring.h"
+#include "glstate.h"
+#include "profiler.h"
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    const char *const kUniformBlockNames[] = {
+        "FrameBlock",
+        "ViewBlock",
+        "ObjectBlock",
+    };
+    static_assert(sizeof(kUniformBlockNames) / sizeof(kUniformBlockNames[0]) == static_cast<size_t>(UniformBlock::Count),
+                  "kUniformBlockNames must match UniformBlock");
+
+    // std140 布局下这些块没有额外填充，C++ 结构体可以直接拷贝
+    static_assert(sizeof(FrameUniforms) == 16, "FrameUniforms must match FrameBlock");
+    static_assert(sizeof(ViewUniforms) == 80, "ViewUniforms must match ViewBlock");
+    static_assert(sizeof(ObjectUniforms) == 96, "ObjectUniforms must match ObjectBlock");
+}
+
+const char *uniformBlockName(UniformBlock block)
+{
+    size_t index = static_cast<size_t>(block);
+    return index < static_cast<size_t>(UniformBlock::Count) ? kUniformBlockNames[index] : "";
+}
+
+UniformBufferRing::UniformBufferRing(int frameCount, GLsizeiptr capacity)
+    : m_ring(BufferObject::Type::UniformBuffer, frameCount, capacity > 0 ? capacity : kDefaultCapacity),
+      m_alignment(GLState::getUniformBufferOffsetAlignment())
+{
+    m_ring.setOrphaning(false);
+    m_ring.setMaxCapacity(std::numeric_limits<GLsizeiptr>::max());
+}
+
+UniformBufferRing::~UniformBufferRing()
+{
+}
+
+void UniformBufferRing::beginFrame()
+{
+    m_ring.beginFrame();
+}
+
+void *UniformBufferRing::allocate(GLsizeiptr size, Allocation &allocation)
+{
+    // 按对齐后的大小分配，下一块的偏移自然对齐
+    void *data = m_ring.allocate(alignSize(size), m_alignment, allocation);
+    allocation.size = size;
+    return data;
+}
+
+UniformBufferRing::Allocation UniformBufferRing::push(const void *data, GLsizeiptr size)
+{
+    Allocation allocation;
+    std::memcpy(allocate(size, allocation), data, static_cast<size_t>(size));
+    return allocation;
+}
+
+void UniformBufferRing::flush()
+{
+    PROFILE_ZONE("UniformBufferRing::flush");
+
+    m_ring.flush();
+}
+
+void UniformBufferRing::bind(UniformBlock block, const Allocation &allocation)
+{
+    GLState::bindUniformBufferRange(static_cast<GLuint>(block), allocation.buffer, allocation.offset, allocation.size);
+}
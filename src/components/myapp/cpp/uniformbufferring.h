@@ -0,0 +1,171 @@
+#ifndef UNIFORMBUFFERRING_H
+#define UNIFORMBUFFERRING_H
+
+#include "glapi.h"
+#include <cstdint>
+#include <vector>
+#include "dynamicbufferring.h"
+
+/**
+ * @brief 引擎约定的 uniform 块，枚举值即绑定点
+ *
+ * 着色器按名称声明需要的块（std140 布局），Shader 链接后把找到的块绑定到对应的绑定点：
+ *   layout(std140) uniform FrameBlock { vec4 uFrame; };
+ *   layout(std140) uniform ViewBlock { mat4 uViewProjection; vec4 uDepthRange; };
+ *   layout(std140) uniform ObjectBlock { mat4 uModel; vec4 uColor; vec4 uParams; };
+ */
+enum class UniformBlock : GLuint
+{
+    Frame = 0,  // 每帧一份
+    View = 1,   // 每个渲染过程一份
+    Object = 2, // 每个游戏对象一份
+    Count
+};
+
+/**
+ * @brief 获取 uniform 块在着色器中的名称
+ * @param block 块
+ * @return 块名称
+ */
+const char *uniformBlockName(UniformBlock block);
+
+/**
+ * @brief FrameBlock 的 std140 布局
+ */
+struct FrameUniforms
+{
+    float frame[4]; // x: 时间（秒） y: 帧间隔（秒） z: 帧序号 w: 保留
+};
+
+/**
+ * @brief ViewBlock 的 std140 布局
+ */
+struct ViewUniforms
+{
+    float viewProjection[16]; // 视图投影矩阵（列主序）
+    float depthRange[4];      // x: 近端 y: 远端 z: 1 / (远端 - 近端) w: 保留
+};
+
+/**
+ * @brief ObjectBlock 的 std140 布局
+ */
+struct ObjectUniforms
+{
+    float model[16]; // 模型矩阵（列主序）
+    float color[4];  // 对象颜色
+    float params[4]; // 自定义参数
+};
+
+/**
+ * @brief 多缓冲的 uniform 缓冲环
+ *
+ * 基于 GL_UNIFORM_BUFFER 类型的 DynamicBufferRing：每帧轮换使用其中一个缓冲，避免覆盖 GPU 可能仍在读取的上一帧数据。
+ * 一帧内的块按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐并填充到对齐大小，flush() 时一次上传，
+ * 之后用 glBindBufferRange 把各块绑定到对应的绑定点。轮换已经避免了覆盖，不孤立旧存储，容量不设上限。
+ * 只在持有 GL 上下文的线程上使用
+ */
+class UniformBufferRing
+{
+public:
+    // 默认轮换的缓冲数量
+    static constexpr int kDefaultFrameCount = 3;
+
+    // 每个缓冲的初始容量（字节）
+    static constexpr GLsizeiptr kDefaultCapacity = 64 * 1024;
+
+    // 一次分配在缓冲中的位置
+    using Allocation = DynamicBufferRing::Allocation;
+
+    /**
+     * @brief 创建缓冲环（创建 GL 缓冲对象，必须在 GL 上下文中调用）
+     * @param frameCount 轮换的缓冲数量
+     * @param capacity 每个缓冲的初始容量（字节）
+     */
+    explicit UniformBufferRing(int frameCount = kDefaultFrameCount, GLsizeiptr capacity = kDefaultCapacity);
+    ~UniformBufferRing();
+
+    // 禁用拷贝构造和赋值
+    UniformBufferRing(const UniformBufferRing &) = delete;
+    UniformBufferRing &operator=(const UniformBufferRing &) = delete;
+
+    /**
+     * @brief 开始新的一帧：切换到下一个缓冲并清空暂存区
+     */
+    void beginFrame();
+
+    /**
+     * @brief 在本帧中分配一段对齐的空间
+     * @param size 字节数
+     * @param allocation 输出分配的位置
+     * @return 暂存区中的写入地址，下一次分配前有效
+     */
+    void *allocate(GLsizeiptr size, Allocation &allocation);
+
+    /**
+     * @brief 分配空间并拷贝数据
+     * @param data 数据
+     * @param size 字节数
+     * @return 分配的位置
+     */
+    Allocation push(const void *data, GLsizeiptr size);
+
+    /**
+     * @brief 分配空间并拷贝一个块
+     * @param block 块数据
+     * @return 分配的位置
+     */
+    template <typename T>
+    Allocation push(const T &block)
+    {
+        return push(&block, static_cast<GLsizeiptr>(sizeof(T)));
+    }
+
+    /**
+     * @brief 把本帧暂存区上传到当前缓冲（一次 glBufferSubData），绑定前调用
+     */
+    void flush();
+
+    /**
+     * @brief 把分配的空间绑定到块对应的绑定点
+     * @param block 块
+     * @param allocation 分配的位置
+     */
+    static void bind(UniformBlock block, const Allocation &allocation);
+
+    /**
+     * @brief 按偏移对齐要求向上取整
+     * @param size 字节数
+     * @return 对齐后的字节数
+     */
+    GLsizeiptr alignSize(GLsizeiptr size) const { return (size + m_alignment - 1) / m_alignment * m_alignment; }
+
+    /**
+     * @brief 获取偏移对齐要求
+     * @return 对齐字节数
+     */
+    GLsizeiptr getAlignment() const { return m_alignment; }
+
+    /**
+     * @brief 获取轮换的缓冲数量
+     * @return 缓冲数量
+     */
+    int getFrameCount() const { return m_ring.getFrameCount(); }
+
+    /**
+     * @brief 获取每个缓冲的容量
+     * @return 字节数
+     */
+    GLsizeiptr getCapacity() const { return m_ring.getCapacity(); }
+
+    /**
+     * @brief 获取本帧已分配的字节数（含对齐填充）
+     * @return 字节数
+     */
+    GLsizeiptr getBytesUsed() const { return m_ring.getBytesUsed(); }
+
+private:
+    DynamicBufferRing m_ring;
+    GLsizeiptr m_alignment;
+};
+
+#endif // UNIFORMBUFFERRING_H
@@ -1,7 +1,9 @@
 #include "vertexarrayobject.h"
 #include "bufferobject.h"
-
-#include <GLES3/gl3.h>
+#include "glstate.h"
+#include "instancing.h"
+#include "vertexlayout.h"
+#include <cstdint>
 
 VertexArrayObject::VertexArrayObject()
     : m_id(0)
@@ -13,6 +15,7 @@ VertexArrayObject::~VertexArrayObject()
 {
     if (m_id != 0)
     {
+        GLState::vertexArrayDeleted(m_id);
         glDeleteVertexArrays(1, &m_id);
     }
 }
@@ -29,6 +32,7 @@ VertexArrayObject &VertexArrayObject::operator=(VertexArrayObject &&other) noexc
     {
         if (m_id != 0)
         {
+            GLState::vertexArrayDeleted(m_id);
             glDeleteVertexArrays(1, &m_id);
         }
         m_id = other.m_id;
@@ -39,12 +43,12 @@ VertexArrayObject &VertexArrayObject::operator=(VertexArrayObject &&other) noexc
 
 void VertexArrayObject::bind() const
 {
-    glBindVertexArray(m_id);
+    GLState::bindVertexArray(m_id);
 }
 
 void VertexArrayObject::unbind() const
 {
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
 }
 
 void VertexArrayObject::setVertexAttribPointer(GLuint index, GLint size, GLenum type,
@@ -66,6 +70,42 @@ void VertexArrayObject::disableVertexAttribArray(GLuint index)
     // glDisableVertexAttribArray(index);
 }
 
+void VertexArrayObject::setVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    bind();
+    glVertexAttribDivisor(index, divisor);
+}
+
+void VertexArrayObject::setInstanceLayout(const InstanceLayout &layout)
+{
+    for (const InstanceAttribute &attribute : layout.getAttributes())
+    {
+        enableVertexAttribArray(attribute.location);
+        setVertexAttribDivisor(attribute.location, 1);
+    }
+}
+
+void VertexArrayObject::setVertexLayout(const VertexLayout &layout, const GLuint *streamBuffers)
+{
+    bind();
+    GLuint boundStream = ~0u;
+    for (const VertexAttributeSetup &setup : layout.getSetup())
+    {
+        // 属性指针记录的是调用时绑定的 GL_ARRAY_BUFFER，设置表按流排列，每个流只绑定一次
+        if (setup.stream != boundStream)
+        {
+            GLState::bindBuffer(GL_ARRAY_BUFFER, streamBuffers[setup.stream]);
+            boundStream = setup.stream;
+        }
+        glVertexAttribPointer(setup.location, setup.size, setup.type, setup.normalized, setup.stride, setup.pointer);
+        glEnableVertexAttribArray(setup.location);
+        if (setup.divisor != 0)
+        {
+            glVertexAttribDivisor(setup.location, setup.divisor);
+        }
+    }
+}
+
 void VertexArrayObject::bindElementBuffer(const BufferObject &ebo)
 {
     bind();
@@ -1,11 +1,13 @@
 #ifndef VERTEX_ARRAY_OBJECT_H
 #define VERTEX_ARRAY_OBJECT_H
 
-#include <GLFW/glfw3.h>
+#include "glapi.h"
 #include <vector>
 #include <memory>
 
 class BufferObject;
+class InstanceLayout;
+class VertexLayout;
 
 /**
  * @brief Vertex Array Object (VAO) 封装类
@@ -72,6 +74,30 @@ public:
      */
     void disableVertexAttribArray(GLuint index);
 
+    /**
+     * @brief 设置顶点属性除数
+     * @param index 属性索引
+     * @param divisor 每隔多少个实例前进一次，0 表示逐顶点
+     */
+    void setVertexAttribDivisor(GLuint index, GLuint divisor);
+
+    /**
+     * @brief 启用实例属性布局中的所有属性并把除数设为 1（属性指针在绘制时设置）
+     * @param layout 实例属性布局
+     */
+    void setInstanceLayout(const InstanceLayout &layout);
+
+    /**
+     * @brief 按顶点布局设置并启用所有属性，每个流的属性指向对应的缓冲
+     *
+     * 参数取自布局预先生成的设置表（VertexLayout::getSetup()），不再逐个属性计算。
+     * 属性指针属于每个 VAO 的状态，WebGL 2 没有 vertex_attrib_binding，
+     * 因此每个 VAO 仍要为每个属性调用一次 glVertexAttribPointer/glEnableVertexAttribArray
+     * @param layout 顶点布局
+     * @param streamBuffers 每个流的缓冲名，数量为 layout.getStreamCount()
+     */
+    void setVertexLayout(const VertexLayout &layout, const GLuint *streamBuffers);
+
     /**
      * @brief 绑定元素缓冲对象(EBO)
      * @param ebo EBO对象
@@ -0,0 +1,182 @@
+#include "vertexlayout.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace
+{
+    void hashCombine(std::size_t &seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9u + (seed << 6) + (seed >> 2);
+    }
+
+    GLuint alignOffset(GLuint offset)
+    {
+        return (offset + 3u) & ~3u;
+    }
+
+    GLuint attributeEnd(const VertexAttribute &attribute)
+    {
+        return attribute.offset + static_cast<GLuint>(attribute.size * vertexTypeSize(attribute.type));
+    }
+
+    // 共享表：按内容哈希分桶，布局数量很少且不会释放
+    std::unordered_map<std::size_t, std::vector<std::shared_ptr<const VertexLayout>>> &sharedLayouts()
+    {
+        static std::unordered_map<std::size_t, std::vector<std::shared_ptr<const VertexLayout>>> layouts;
+        return layouts;
+    }
+}
+
+GLsizei vertexTypeSize(GLenum type)
+{
+    switch (type)
+    {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT:
+        return 2;
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+    case GL_FIXED:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+VertexLayout &VertexLayout::add(VertexSemantic semantic, GLint size, GLenum type, GLboolean normalized,
+                                GLuint stream, GLuint divisor)
+{
+    GLuint offset = 0;
+    for (const VertexAttribute &attribute : m_attributes)
+    {
+        if (attribute.stream == stream)
+        {
+            offset = std::max(offset, alignOffset(attributeEnd(attribute)));
+        }
+    }
+    return add({semantic, static_cast<GLuint>(semantic), size, type, normalized, offset, stream, divisor});
+}
+
+VertexLayout &VertexLayout::add(const VertexAttribute &attribute)
+{
+    m_attributes.push_back(attribute);
+    if (attribute.stream >= m_strides.size())
+    {
+        m_strides.resize(attribute.stream + 1, 0);
+        m_explicitStrides.resize(attribute.stream + 1, false);
+    }
+    if (!m_explicitStrides[attribute.stream])
+    {
+        m_strides[attribute.stream] =
+            std::max(m_strides[attribute.stream], static_cast<GLsizei>(alignOffset(attributeEnd(attribute))));
+    }
+    updateSetup();
+    return *this;
+}
+
+VertexLayout &VertexLayout::setStride(GLuint stream, GLsizei stride)
+{
+    if (stream >= m_strides.size())
+    {
+        m_strides.resize(stream + 1, 0);
+        m_explicitStrides.resize(stream + 1, false);
+    }
+    m_strides[stream] = stride;
+    m_explicitStrides[stream] = true;
+    updateSetup();
+    return *this;
+}
+
+void VertexLayout::updateSetup()
+{
+    m_setup.clear();
+    m_setup.reserve(m_attributes.size());
+    for (const VertexAttribute &attribute : m_attributes)
+    {
+        m_setup.push_back({attribute.location, attribute.size, attribute.type, attribute.normalized,
+                           getStride(attribute.stream),
+                           reinterpret_cast<const void *>(static_cast<std::uintptr_t>(attribute.offset)),
+                           attribute.stream, attribute.divisor});
+    }
+    std::stable_sort(m_setup.begin(), m_setup.end(),
+                     [](const VertexAttributeSetup &a, const VertexAttributeSetup &b) { return a.stream < b.stream; });
+}
+
+const VertexAttribute *VertexLayout::find(VertexSemantic semantic) const
+{
+    for (const VertexAttribute &attribute : m_attributes)
+    {
+        if (attribute.semantic == semantic)
+            return &attribute;
+    }
+    return nullptr;
+}
+
+std::size_t VertexLayout::getHash() const
+{
+    std::size_t hash = m_attributes.size();
+    for (const VertexAttribute &attribute : m_attributes)
+    {
+        hashCombine(hash, static_cast<std::size_t>(attribute.semantic));
+        hashCombine(hash, attribute.location);
+        hashCombine(hash, static_cast<std::size_t>(attribute.size));
+        hashCombine(hash, attribute.type);
+        hashCombine(hash, attribute.normalized);
+        hashCombine(hash, attribute.offset);
+        hashCombine(hash, attribute.stream);
+        hashCombine(hash, attribute.divisor);
+    }
+    for (GLsizei stride : m_strides)
+    {
+        hashCombine(hash, static_cast<std::size_t>(stride));
+    }
+    return hash;
+}
+
+bool VertexLayout::operator==(const VertexLayout &other) const
+{
+    return m_strides == other.m_strides &&
+           std::equal(m_attributes.begin(), m_attributes.end(), other.m_attributes.begin(), other.m_attributes.end(),
+                      [](const VertexAttribute &a, const VertexAttribute &b)
+                      {
+                          return a.semantic == b.semantic && a.location == b.location && a.size == b.size &&
+                                 a.type == b.type && a.normalized == b.normalized && a.offset == b.offset &&
+                                 a.stream == b.stream && a.divisor == b.divisor;
+                      });
+}
+
+std::shared_ptr<const VertexLayout> VertexLayout::share(const VertexLayout &layout)
+{
+    std::vector<std::shared_ptr<const VertexLayout>> &bucket = sharedLayouts()[layout.getHash()];
+    for (const auto &shared : bucket)
+    {
+        if (*shared == layout)
+            return shared;
+    }
+    bucket.push_back(std::make_shared<const VertexLayout>(layout));
+    return bucket.back();
+}
+
+const std::shared_ptr<const VertexLayout> &VertexLayout::position()
+{
+    static const std::shared_ptr<const VertexLayout> layout =
+        share(VertexLayout().add(VertexSemantic::Position, 3, GL_FLOAT));
+    return layout;
+}
+
+std::size_t VertexLayout::getSharedCount()
+{
+    std::size_t count = 0;
+    for (const auto &bucket : sharedLayouts())
+    {
+        count += bucket.second.size();
+    }
+    return count;
+}
@@ -0,0 +1,176 @@
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+#include "glapi.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 顶点属性语义，决定默认的属性位置
+ *
+ * 位置 4-9 留给 InstanceLayout::standard()，逐顶点属性不使用
+ */
+enum class VertexSemantic : GLuint
+{
+    Position = 0,
+    Normal = 1,
+    TexCoord0 = 2,
+    Color = 3,
+    Tangent = 10,
+    TexCoord1 = 11,
+    Joints = 12,
+    Weights = 13
+};
+
+/**
+ * @brief 顶点属性：布局中的一个字段
+ */
+struct VertexAttribute
+{
+    VertexSemantic semantic; // 语义
+    GLuint location;         // 属性位置
+    GLint size;              // 分量数 (1, 2, 3, 4)
+    GLenum type;             // 数据类型
+    GLboolean normalized;    // 是否归一化
+    GLuint offset;           // 在所属流的顶点中的字节偏移
+    GLuint stream;           // 所属顶点流（缓冲）的序号
+    GLuint divisor;          // 每隔多少个实例前进一次，0 表示逐顶点
+};
+
+/**
+ * @brief 一个属性的 glVertexAttribPointer 参数，步长和指针已经按布局解析
+ */
+struct VertexAttributeSetup
+{
+    GLuint location;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei stride;
+    const void *pointer; // 在所属流的缓冲中的字节偏移
+    GLuint stream;
+    GLuint divisor;
+};
+
+/**
+ * @brief 声明式顶点布局
+ *
+ * 描述顶点数据分成几个流（每个流一个缓冲）、每个流的步长以及每个属性的语义、格式和偏移。
+ * 同一个流中的属性交错存放，不同流的属性分开存放。Mesh 和 VertexArrayObject 按布局设置属性指针。
+ *
+ * 布局通过 share() 按内容去重：内容相同的布局共享同一个对象，可以直接比较指针，
+ * 属性偏移、步长和按流排列的属性设置表（getSetup()）只计算一次。共享表只在主线程上访问
+ */
+class VertexLayout
+{
+public:
+    /**
+     * @brief 添加一个属性，偏移按所属流中已有的属性依次排列（按 4 字节对齐）
+     * @param semantic 语义，属性位置取语义的值
+     * @param size 分量数
+     * @param type 数据类型
+     * @param normalized 是否归一化
+     * @param stream 所属顶点流
+     * @param divisor 实例除数
+     * @return 布局本身，便于链式调用
+     */
+    VertexLayout &add(VertexSemantic semantic, GLint size, GLenum type, GLboolean normalized = GL_FALSE,
+                      GLuint stream = 0, GLuint divisor = 0);
+
+    /**
+     * @brief 按给定的位置和偏移添加一个属性（与已有数据格式对接时使用）
+     * @param attribute 属性
+     * @return 布局本身，便于链式调用
+     */
+    VertexLayout &add(const VertexAttribute &attribute);
+
+    /**
+     * @brief 设置流的步长（默认是该流属性的紧密排列大小，顶点有填充时需要显式设置）
+     * @param stream 顶点流
+     * @param stride 字节数
+     * @return 布局本身，便于链式调用
+     */
+    VertexLayout &setStride(GLuint stream, GLsizei stride);
+
+    /**
+     * @brief 获取所有属性
+     * @return 属性列表
+     */
+    const std::vector<VertexAttribute> &getAttributes() const { return m_attributes; }
+
+    /**
+     * @brief 按语义查找属性
+     * @param semantic 语义
+     * @return 属性，不存在时返回 nullptr
+     */
+    const VertexAttribute *find(VertexSemantic semantic) const;
+
+    /**
+     * @brief 获取属性设置表：按流排列，同一个流的属性相邻，修改布局时重新生成
+     * @return 设置表
+     */
+    const std::vector<VertexAttributeSetup> &getSetup() const { return m_setup; }
+
+    /**
+     * @brief 获取顶点流的数量
+     * @return 流数量
+     */
+    GLuint getStreamCount() const { return static_cast<GLuint>(m_strides.size()); }
+
+    /**
+     * @brief 获取流的步长
+     * @param stream 顶点流
+     * @return 字节数，不存在的流返回 0
+     */
+    GLsizei getStride(GLuint stream) const { return stream < m_strides.size() ? m_strides[stream] : 0; }
+
+    /**
+     * @brief 获取内容哈希
+     * @return 哈希值
+     */
+    std::size_t getHash() const;
+
+    bool operator==(const VertexLayout &other) const;
+    bool operator!=(const VertexLayout &other) const { return !(*this == other); }
+
+    /**
+     * @brief 获取与布局内容相同的共享对象，第一次出现的布局被复制进共享表
+     * @param layout 布局
+     * @return 共享的布局
+     */
+    static std::shared_ptr<const VertexLayout> share(const VertexLayout &layout);
+
+    /**
+     * @brief 只有位置的默认布局：一个流，每个顶点 3 个 float
+     * @return 共享的布局
+     */
+    static const std::shared_ptr<const VertexLayout> &position();
+
+    /**
+     * @brief 获取共享表中不同布局的数量
+     * @return 布局数量
+     */
+    static std::size_t getSharedCount();
+
+private:
+    /**
+     * @brief 按当前的属性和步长重新生成设置表
+     */
+    void updateSetup();
+
+private:
+    std::vector<VertexAttribute> m_attributes;
+    std::vector<GLsizei> m_strides;        // 每个流的步长
+    std::vector<bool> m_explicitStrides;   // 步长是否由 setStride() 指定
+    std::vector<VertexAttributeSetup> m_setup;
+};
+
+/**
+ * @brief 获取顶点属性数据类型的字节数
+ * @param type 数据类型
+ * @return 字节数，未知类型返回 0
+ */
+GLsizei vertexTypeSize(GLenum type);
+
+#endif // VERTEXLAYOUT_H
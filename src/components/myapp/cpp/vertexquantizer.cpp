@@ -0,0 +1,312 @@
+#include "vertexquantizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr float kSnorm16 = 32767.0f;
+    constexpr float kRadiansToDegrees = 180.0f / 3.14159265358979323846f;
+
+    const float *attribute(const float *base, size_t index, size_t stride, size_t components)
+    {
+        if (!base)
+            return nullptr;
+        const size_t step = stride != 0 ? stride : components * sizeof(float);
+        return reinterpret_cast<const float *>(reinterpret_cast<const std::uint8_t *>(base) + index * step);
+    }
+
+    std::int16_t toSnorm16(float value)
+    {
+        return static_cast<std::int16_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * kSnorm16));
+    }
+
+    float fromSnorm16(std::int16_t value)
+    {
+        return std::max(static_cast<float>(value) / kSnorm16, -1.0f);
+    }
+
+    float signNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    bool normalize(const float in[3], float out[3])
+    {
+        const float length = std::sqrt(in[0] * in[0] + in[1] * in[1] + in[2] * in[2]);
+        if (length <= 0.0f)
+            return false;
+        out[0] = in[0] / length;
+        out[1] = in[1] / length;
+        out[2] = in[2] / length;
+        return true;
+    }
+
+    float angleDegrees(const float a[3], const float b[3])
+    {
+        const float dot = std::min(std::max(a[0] * b[0] + a[1] * b[1] + a[2] * b[2], -1.0f), 1.0f);
+        return std::acos(dot) * kRadiansToDegrees;
+    }
+
+    // 编码方向并返回解码后与输入的夹角
+    float encodeDirection(const float *input, std::uint8_t *out)
+    {
+        float direction[3];
+        if (!normalize(input, direction))
+        {
+            direction[0] = 0.0f;
+            direction[1] = 0.0f;
+            direction[2] = 1.0f;
+        }
+        std::int16_t encoded[2];
+        VertexQuantizer::encodeOctahedral(direction, encoded);
+        std::memcpy(out, encoded, sizeof(encoded));
+
+        float decoded[3];
+        VertexQuantizer::decodeOctahedral(encoded, decoded);
+        return angleDegrees(direction, decoded);
+    }
+}
+
+void VertexQuantizer::encodeOctahedral(const float direction[3], std::int16_t encoded[2])
+{
+    float n[3];
+    if (!normalize(direction, n))
+    {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+
+    // 投影到八面体 |x| + |y| + |z| = 1，下半球折叠到外侧三角形
+    const float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    float x = n[0] / l1;
+    float y = n[1] / l1;
+    if (n[2] < 0.0f)
+    {
+        const float folded = (1.0f - std::fabs(y)) * signNotZero(x);
+        y = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = folded;
+    }
+
+    // 向下/向上取整的四种组合中选择解码误差最小的一个
+    const float fx = std::floor(std::min(std::max(x, -1.0f), 1.0f) * kSnorm16);
+    const float fy = std::floor(std::min(std::max(y, -1.0f), 1.0f) * kSnorm16);
+    float bestDot = -2.0f;
+    for (int i = 0; i < 4; ++i)
+    {
+        const std::int16_t candidate[2] = {
+            static_cast<std::int16_t>(std::min(fx + (i & 1), kSnorm16)),
+            static_cast<std::int16_t>(std::min(fy + (i >> 1), kSnorm16))};
+        float decoded[3];
+        decodeOctahedral(candidate, decoded);
+        const float dot = decoded[0] * n[0] + decoded[1] * n[1] + decoded[2] * n[2];
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            encoded[0] = candidate[0];
+            encoded[1] = candidate[1];
+        }
+    }
+}
+
+void VertexQuantizer::decodeOctahedral(const std::int16_t encoded[2], float direction[3])
+{
+    float x = fromSnorm16(encoded[0]);
+    float y = fromSnorm16(encoded[1]);
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f)
+    {
+        const float unfolded = (1.0f - std::fabs(y)) * signNotZero(x);
+        y = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = unfolded;
+    }
+    const float v[3] = {x, y, z};
+    if (!normalize(v, direction))
+    {
+        direction[0] = 0.0f;
+        direction[1] = 0.0f;
+        direction[2] = 1.0f;
+    }
+}
+
+std::uint16_t VertexQuantizer::toHalf(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    const int exponent = static_cast<int>((bits >> 23) & 0xFFu);
+    std::uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFF)
+    {
+        // 无穷大保持，NaN 保留为静默 NaN
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+    }
+
+    const int halfExponent = exponent - 127 + 15;
+    if (halfExponent >= 31)
+    {
+        return static_cast<std::uint16_t>(sign | 0x7BFFu);
+    }
+
+    if (halfExponent <= 0)
+    {
+        // 半精度的非规格化数
+        if (halfExponent < -10)
+            return sign;
+        mantissa |= 0x800000u;
+        const int shift = 14 - halfExponent;
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const std::uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u)))
+        {
+            ++half;
+        }
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    std::uint32_t half = (static_cast<std::uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const std::uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+    {
+        ++half; // 进位到指数也是正确的结果
+    }
+    if (half >= 0x7C00u)
+    {
+        half = 0x7BFFu;
+    }
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+float VertexQuantizer::fromHalf(std::uint16_t half)
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+    const int exponent = (half >> 10) & 0x1F;
+    const std::uint32_t mantissa = half & 0x3FFu;
+
+    float value;
+    if (exponent == 0)
+    {
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+    }
+    else if (exponent == 31)
+    {
+        value = mantissa != 0 ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+    }
+    else
+    {
+        value = std::ldexp(static_cast<float>(mantissa | 0x400u), exponent - 25);
+    }
+    return sign ? -value : value;
+}
+
+QuantizedVertices VertexQuantizer::quantize(const VertexSource &source, size_t vertexCount, const float *bounds)
+{
+    QuantizedVertices result;
+    if (!source.positions || vertexCount == 0)
+        return result;
+
+    VertexLayout layout;
+    layout.add(VertexSemantic::Position, 4, GL_SHORT, GL_TRUE);
+    if (source.normals)
+        layout.add(VertexSemantic::Normal, 2, GL_SHORT, GL_TRUE);
+    if (source.tangents)
+        layout.add(VertexSemantic::Tangent, 2, GL_SHORT, GL_TRUE);
+    if (source.texcoords)
+        layout.add(VertexSemantic::TexCoord0, 2, GL_HALF_FLOAT);
+    if (source.colors)
+        layout.add(VertexSemantic::Color, 4, GL_UNSIGNED_BYTE, GL_TRUE);
+    result.layout = VertexLayout::share(layout);
+    result.vertexCount = static_cast<GLsizei>(vertexCount);
+
+    // 反量化变换：包围盒中心和半边长
+    float minimum[3];
+    float maximum[3];
+    if (bounds)
+    {
+        std::copy(bounds, bounds + 3, minimum);
+        std::copy(bounds + 3, bounds + 6, maximum);
+    }
+    else
+    {
+        const float *first = attribute(source.positions, 0, source.stride, 3);
+        std::copy(first, first + 3, minimum);
+        std::copy(first, first + 3, maximum);
+        for (size_t i = 1; i < vertexCount; ++i)
+        {
+            const float *position = attribute(source.positions, i, source.stride, 3);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                minimum[axis] = std::min(minimum[axis], position[axis]);
+                maximum[axis] = std::max(maximum[axis], position[axis]);
+            }
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        result.offset[axis] = 0.5f * (minimum[axis] + maximum[axis]);
+        const float halfExtent = 0.5f * (maximum[axis] - minimum[axis]);
+        result.scale[axis] = halfExtent > 0.0f ? halfExtent : 1.0f;
+    }
+
+    const GLsizei stride = result.layout->getStride(0);
+    const GLuint normalOffset = source.normals ? result.layout->find(VertexSemantic::Normal)->offset : 0;
+    const GLuint tangentOffset = source.tangents ? result.layout->find(VertexSemantic::Tangent)->offset : 0;
+    const GLuint texcoordOffset = source.texcoords ? result.layout->find(VertexSemantic::TexCoord0)->offset : 0;
+    const GLuint colorOffset = source.colors ? result.layout->find(VertexSemantic::Color)->offset : 0;
+    result.data.assign(vertexCount * static_cast<size_t>(stride), 0);
+
+    QuantizationError &error = result.error;
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        std::uint8_t *vertex = result.data.data() + i * static_cast<size_t>(stride);
+
+        // 位置，w 存放副切线方向
+        const float *position = attribute(source.positions, i, source.stride, 3);
+        std::int16_t packed[4];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            packed[axis] = toSnorm16((position[axis] - result.offset[axis]) / result.scale[axis]);
+            const float decoded = result.offset[axis] + result.scale[axis] * fromSnorm16(packed[axis]);
+            error.position = std::max(error.position, std::fabs(decoded - position[axis]));
+        }
+        const float *tangent = attribute(source.tangents, i, source.stride, 4);
+        packed[3] = tangent && tangent[3] < 0.0f ? -32767 : 32767;
+        std::memcpy(vertex, packed, sizeof(packed));
+
+        if (source.normals)
+        {
+            error.normalDegrees = std::max(
+                error.normalDegrees, encodeDirection(attribute(source.normals, i, source.stride, 3), vertex + normalOffset));
+        }
+        if (tangent)
+        {
+            error.tangentDegrees = std::max(error.tangentDegrees, encodeDirection(tangent, vertex + tangentOffset));
+        }
+        if (source.texcoords)
+        {
+            const float *texcoord = attribute(source.texcoords, i, source.stride, 2);
+            const std::uint16_t halves[2] = {toHalf(texcoord[0]), toHalf(texcoord[1])};
+            std::memcpy(vertex + texcoordOffset, halves, sizeof(halves));
+            for (int c = 0; c < 2; ++c)
+            {
+                error.texcoord = std::max(error.texcoord, std::fabs(fromHalf(halves[c]) - texcoord[c]));
+            }
+        }
+        if (source.colors)
+        {
+            const float *color = attribute(source.colors, i, source.stride, 4);
+            for (int c = 0; c < 4; ++c)
+            {
+                const float clamped = std::min(std::max(color[c], 0.0f), 1.0f);
+                const std::uint8_t value = static_cast<std::uint8_t>(std::lround(clamped * 255.0f));
+                vertex[colorOffset + c] = value;
+                error.color = std::max(error.color, std::fabs(static_cast<float>(value) / 255.0f - color[c]));
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,109 @@
+#ifndef VERTEXQUANTIZER_H
+#define VERTEXQUANTIZER_H
+
+#include "glapi.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "vertexlayout.h"
+
+/**
+ * @brief 待量化的浮点顶点数据
+ *
+ * 各属性可以交错存放在同一个数组中（例如导入器的 FBXVertex：位置、法线、纹理坐标、颜色共 48 字节），
+ * 也可以各自紧密排列。除位置外的属性可以为 nullptr
+ */
+struct VertexSource
+{
+    const float *positions = nullptr; // 3 个 float
+    const float *normals = nullptr;   // 3 个 float
+    const float *tangents = nullptr;  // 4 个 float，w 为副切线方向（±1）
+    const float *texcoords = nullptr; // 2 个 float
+    const float *colors = nullptr;    // 4 个 float，范围 [0, 1]
+    size_t stride = 0;                // 相邻顶点的字节间隔，0 表示各属性按自己的分量数紧密排列
+};
+
+/**
+ * @brief 量化误差（解码结果与输入的最大偏差）
+ */
+struct QuantizationError
+{
+    float position;       // 位置的最大分量误差（模型空间单位）
+    float normalDegrees;  // 法线的最大夹角误差（度）
+    float tangentDegrees; // 切线的最大夹角误差（度）
+    float texcoord;       // 纹理坐标的最大分量误差
+    float color;          // 颜色的最大分量误差
+};
+
+/**
+ * @brief 量化后的顶点数据，单流交错存放
+ *
+ * 位置是归一化的 16 位有符号整数，模型空间位置 = offset + scale * 解码值；
+ * w 分量存放切线的副切线方向（没有切线时为 1）
+ */
+struct QuantizedVertices
+{
+    std::shared_ptr<const VertexLayout> layout; // 共享的布局
+    std::vector<std::uint8_t> data;             // 顶点数据
+    GLsizei vertexCount = 0;
+    float scale[3] = {1.0f, 1.0f, 1.0f};  // 反量化缩放（包围盒的半边长）
+    float offset[3] = {0.0f, 0.0f, 0.0f}; // 反量化偏移（包围盒中心）
+    QuantizationError error = {};
+};
+
+/**
+ * @brief 顶点属性量化
+ *
+ * 把浮点顶点压缩为：
+ *   位置  4 x GL_SHORT 归一化（按包围盒映射到 [-1, 1]）   8 字节
+ *   法线  2 x GL_SHORT 归一化（八面体编码）                4 字节
+ *   切线  2 x GL_SHORT 归一化（八面体编码，方向在位置 w）  4 字节
+ *   UV    2 x GL_HALF_FLOAT                                4 字节
+ *   颜色  4 x GL_UNSIGNED_BYTE 归一化                      4 字节
+ * 位置 + 法线 + UV 共 16 字节，再加颜色 20 字节（浮点的 FBXVertex 是 48 字节）。
+ * 着色器从法线/切线的 vec2 解码八面体方向，位置的反量化变换由 Mesh 合并到模型矩阵
+ */
+class VertexQuantizer
+{
+public:
+    /**
+     * @brief 量化顶点
+     * @param source 浮点顶点数据
+     * @param vertexCount 顶点数量
+     * @param bounds 量化使用的包围盒 [minX, minY, minZ, maxX, maxY, maxZ]，nullptr 表示按顶点计算。
+     *               每个网格的反量化变换分别合并到它自己的模型矩阵（实例数据或 ObjectBlock）
+     * @return 量化结果和误差
+     */
+    static QuantizedVertices quantize(const VertexSource &source, size_t vertexCount, const float *bounds = nullptr);
+
+    /**
+     * @brief 八面体编码单位向量
+     * @param direction 方向（不必归一化）
+     * @param encoded 输出两个归一化 16 位分量，选择解码误差最小的取整
+     */
+    static void encodeOctahedral(const float direction[3], std::int16_t encoded[2]);
+
+    /**
+     * @brief 解码八面体编码的方向
+     * @param encoded 两个归一化 16 位分量
+     * @param direction 输出单位向量
+     */
+    static void decodeOctahedral(const std::int16_t encoded[2], float direction[3]);
+
+    /**
+     * @brief 浮点数转换为半精度浮点（就近舍入，超出范围的值饱和到最大有限值）
+     * @param value 浮点数
+     * @return 半精度位模式
+     */
+    static std::uint16_t toHalf(float value);
+
+    /**
+     * @brief 半精度浮点转换为浮点数
+     * @param half 半精度位模式
+     * @return 浮点数
+     */
+    static float fromHalf(std::uint16_t half);
+};
+
+#endif // VERTEXQUANTIZER_H